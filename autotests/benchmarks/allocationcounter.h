@@ -0,0 +1,21 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * Process wide heap allocation counter used by the benchmarks.
+ *
+ * The counter interposes malloc, calloc and realloc, so it sees allocations made by Qt
+ * containers and libwayland as well as operator new. On platforms where interposing is
+ * not supported, count() always returns zero.
+ */
+namespace AllocationCounter
+{
+quint64 count();
+bool isSupported();
+}
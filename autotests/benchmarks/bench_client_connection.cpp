@@ -0,0 +1,211 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QtTest>
+// server
+#include "../../src/server/clientconnection.h"
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/filtered_display.h"
+#include "../../src/server/seat_interface.h"
+#include "../../src/server/subcompositor_interface.h"
+#include "../../src/server/viewporter_interface.h"
+// Wayland
+#include <wayland-client-protocol.h>
+// std
+#include <functional>
+// system
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "allocationcounter.h"
+
+using namespace KWaylandServer;
+
+class CountingDisplay : public FilteredDisplay
+{
+public:
+    bool allowInterface(ClientConnection *client, const QByteArray &interfaceName) override
+    {
+        Q_UNUSED(client)
+        Q_UNUSED(interfaceName)
+        filterCalls++;
+        return true;
+    }
+
+    quint64 filterCalls = 0;
+};
+
+/**
+ * Simulates the connect storm after a session unlock: many clients connect, bind the
+ * registry (which runs the global filter, and thus Display::getConnection, once per global)
+ * and disconnect again.
+ *
+ * The clients are raw wl_display connections over socketpairs living in the server thread.
+ */
+class ClientConnectionBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkConnectStorm_data();
+    void benchmarkConnectStorm();
+    void benchmarkGetConnection_data();
+    void benchmarkGetConnection();
+
+private:
+    struct Client {
+        wl_display *display = nullptr;
+        wl_registry *registry = nullptr;
+        ClientConnection *connection = nullptr;
+    };
+
+    bool connectClients(int count);
+    bool disconnectClients();
+    bool dispatchUntil(std::function<bool()> condition);
+
+    CountingDisplay *m_display = nullptr;
+    QVector<Client> m_clients;
+    int m_globalCount = 0;
+};
+
+void ClientConnectionBenchmark::initTestCase()
+{
+    m_display = new CountingDisplay;
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+
+    // a handful of globals, each one runs the global filter for every client
+    m_display->createShm();
+    new CompositorInterface(m_display, m_display);
+    new SubCompositorInterface(m_display, m_display);
+    new ViewporterInterface(m_display, m_display);
+    auto seat = new SeatInterface(m_display, m_display);
+    seat->setHasPointer(true);
+    seat->setHasKeyboard(true);
+    m_globalCount = 5;
+}
+
+void ClientConnectionBenchmark::cleanupTestCase()
+{
+    disconnectClients();
+    delete m_display;
+    m_display = nullptr;
+}
+
+bool ClientConnectionBenchmark::dispatchUntil(std::function<bool()> condition)
+{
+    // the server event loop reports a limited number of ready clients per dispatch
+    for (int i = 0; i < 10000 && !condition(); ++i) {
+        m_display->dispatchEvents();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+    return condition();
+}
+
+bool ClientConnectionBenchmark::connectClients(int count)
+{
+    const quint64 expectedFilterCalls = m_display->filterCalls + quint64(count) * m_globalCount;
+    for (int i = 0; i < count; ++i) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0) {
+            return false;
+        }
+        Client client;
+        client.connection = m_display->createClient(sv[0]);
+        client.display = wl_display_connect_to_fd(sv[1]);
+        if (!client.connection || !client.display) {
+            return false;
+        }
+        client.registry = wl_display_get_registry(client.display);
+        wl_display_flush(client.display);
+        m_clients << client;
+    }
+    return dispatchUntil([this, expectedFilterCalls] {
+        return m_display->filterCalls >= expectedFilterCalls;
+    });
+}
+
+bool ClientConnectionBenchmark::disconnectClients()
+{
+    for (const Client &client : qAsConst(m_clients)) {
+        wl_registry_destroy(client.registry);
+        wl_display_disconnect(client.display);
+    }
+    m_clients.clear();
+    return dispatchUntil([this] {
+        return m_display->connections().isEmpty();
+    });
+}
+
+void ClientConnectionBenchmark::benchmarkConnectStorm_data()
+{
+    QTest::addColumn<int>("clients");
+
+    QTest::newRow("50") << 50;
+    QTest::newRow("500") << 500;
+}
+
+void ClientConnectionBenchmark::benchmarkConnectStorm()
+{
+    QFETCH(int, clients);
+
+    QBENCHMARK {
+        QVERIFY(connectClients(clients));
+        QCOMPARE(m_display->connections().count(), clients);
+        QVERIFY(disconnectClients());
+    }
+
+    const quint64 allocationsBefore = AllocationCounter::count();
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(connectClients(clients));
+    QVERIFY(disconnectClients());
+    const qint64 elapsed = timer.nsecsElapsed();
+    qInfo("connect storm, %d clients: %.1f us/client, %.1f allocations/client",
+          clients,
+          elapsed / 1000.0 / clients,
+          AllocationCounter::isSupported() ? double(AllocationCounter::count() - allocationsBefore) / clients : qQNaN());
+}
+
+void ClientConnectionBenchmark::benchmarkGetConnection_data()
+{
+    QTest::addColumn<int>("clients");
+
+    QTest::newRow("50") << 50;
+    QTest::newRow("500") << 500;
+}
+
+void ClientConnectionBenchmark::benchmarkGetConnection()
+{
+    QFETCH(int, clients);
+    QVERIFY(connectClients(clients));
+
+    QVector<wl_client *> nativeClients;
+    for (const Client &client : qAsConst(m_clients)) {
+        nativeClients << client.connection->client();
+    }
+
+    // look the last client up, that used to be the worst case
+    wl_client *native = nativeClients.last();
+    ClientConnection *expected = m_clients.last().connection;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            if (Q_UNLIKELY(m_display->getConnection(native) != expected)) {
+                QFAIL("Wrong connection");
+            }
+        }
+    }
+
+    for (int i = 0; i < nativeClients.count(); ++i) {
+        QCOMPARE(m_display->getConnection(nativeClients[i]), m_clients[i].connection);
+    }
+    QVERIFY(disconnectClients());
+}
+
+QTEST_GUILESS_MAIN(ClientConnectionBenchmark)
+#include "bench_client_connection.moc"
@@ -0,0 +1,215 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QElapsedTimer>
+#include <QtTest>
+// server
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/display.h"
+#include "../../src/server/plasmashell_interface.h"
+// client
+#include "../../src/client/compositor.h"
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/plasmashell.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/surface.h"
+// std
+#include <memory>
+#include <vector>
+// system
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace KWaylandServer;
+
+/**
+ * Measures the cost of mapping a native proxy back to its KWayland::Client wrapper.
+ *
+ * This is what every wl_pointer.enter, wl_keyboard.enter and wl_surface.enter callback
+ * does, so it must not depend on the number of wrappers alive in the process. The lookups
+ * cycle through all surfaces to not only measure the best case.
+ */
+class ClientWrappersBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkSurfaceGet_data();
+    void benchmarkSurfaceGet();
+    void benchmarkPlasmaShellSurfaceGet_data();
+    void benchmarkPlasmaShellSurfaceGet();
+
+private:
+    void createSurfaces(int count);
+    void dispatch();
+    template<typename Fn>
+    void report(const char *name, Fn fn);
+
+    Display *m_display = nullptr;
+    KWayland::Client::ConnectionThread *m_connection = nullptr;
+    KWayland::Client::EventQueue *m_queue = nullptr;
+    KWayland::Client::Registry *m_registry = nullptr;
+    KWayland::Client::Compositor *m_compositor = nullptr;
+    KWayland::Client::PlasmaShell *m_plasmaShell = nullptr;
+    std::vector<std::unique_ptr<KWayland::Client::PlasmaShellSurface>> m_plasmaSurfaces;
+    std::vector<std::unique_ptr<KWayland::Client::Surface>> m_surfaces;
+};
+
+void ClientWrappersBenchmark::initTestCase()
+{
+    m_display = new Display(this);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+    new CompositorInterface(m_display, m_display);
+    new PlasmaShellInterface(m_display, m_display);
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    QVERIFY(m_display->createClient(sv[0]));
+
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketFd(sv[1]);
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    m_registry = new KWayland::Client::Registry(this);
+    QSignalSpy interfacesAnnouncedSpy(m_registry, &KWayland::Client::Registry::interfacesAnnounced);
+    m_registry->setEventQueue(m_queue);
+    m_registry->create(m_connection->display());
+    QVERIFY(m_registry->isValid());
+    m_registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+
+    const auto compositor = m_registry->interface(KWayland::Client::Registry::Interface::Compositor);
+    m_compositor = m_registry->createCompositor(compositor.name, compositor.version, this);
+    QVERIFY(m_compositor->isValid());
+    const auto plasmaShell = m_registry->interface(KWayland::Client::Registry::Interface::PlasmaShell);
+    m_plasmaShell = m_registry->createPlasmaShell(plasmaShell.name, plasmaShell.version, this);
+    QVERIFY(m_plasmaShell->isValid());
+}
+
+void ClientWrappersBenchmark::cleanupTestCase()
+{
+    m_plasmaSurfaces.clear();
+    m_surfaces.clear();
+    delete m_plasmaShell;
+    m_plasmaShell = nullptr;
+    delete m_compositor;
+    m_compositor = nullptr;
+    delete m_registry;
+    m_registry = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    delete m_connection;
+    m_connection = nullptr;
+    delete m_display;
+    m_display = nullptr;
+}
+
+void ClientWrappersBenchmark::createSurfaces(int count)
+{
+    m_plasmaSurfaces.clear();
+    m_surfaces.clear();
+    for (int i = 0; i < count; ++i) {
+        m_surfaces.emplace_back(m_compositor->createSurface());
+        m_plasmaSurfaces.emplace_back(m_plasmaShell->createSurface(m_surfaces.back().get()));
+        // Keep the socket buffer from filling up.
+        if (i % 100 == 0) {
+            dispatch();
+        }
+    }
+    dispatch();
+}
+
+void ClientWrappersBenchmark::dispatch()
+{
+    m_connection->flush();
+    m_display->dispatchEvents();
+}
+
+template<typename Fn>
+void ClientWrappersBenchmark::report(const char *name, Fn fn)
+{
+    static const int lookups = 100000;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < lookups; ++i) {
+        fn(i % m_surfaces.size());
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    qInfo("%s with %zu surfaces: %.1f ns/lookup", name, m_surfaces.size(), double(elapsed) / lookups);
+}
+
+void ClientWrappersBenchmark::benchmarkSurfaceGet_data()
+{
+    QTest::addColumn<int>("surfaces");
+
+    QTest::newRow("500") << 500;
+    QTest::newRow("5000") << 5000;
+}
+
+void ClientWrappersBenchmark::benchmarkSurfaceGet()
+{
+    QFETCH(int, surfaces);
+    createSurfaces(surfaces);
+
+    std::vector<wl_surface *> natives;
+    for (const auto &surface : m_surfaces) {
+        natives.push_back(*surface);
+    }
+    for (size_t i = 0; i < natives.size(); ++i) {
+        QCOMPARE(KWayland::Client::Surface::get(natives[i]), m_surfaces[i].get());
+    }
+
+    QBENCHMARK {
+        for (wl_surface *native : natives) {
+            KWayland::Client::Surface::get(native);
+        }
+    }
+
+    report("Surface::get", [&natives](size_t i) {
+        KWayland::Client::Surface::get(natives[i]);
+    });
+}
+
+void ClientWrappersBenchmark::benchmarkPlasmaShellSurfaceGet_data()
+{
+    QTest::addColumn<int>("surfaces");
+
+    QTest::newRow("500") << 500;
+    QTest::newRow("5000") << 5000;
+}
+
+void ClientWrappersBenchmark::benchmarkPlasmaShellSurfaceGet()
+{
+    QFETCH(int, surfaces);
+    createSurfaces(surfaces);
+
+    for (size_t i = 0; i < m_surfaces.size(); ++i) {
+        QCOMPARE(KWayland::Client::PlasmaShellSurface::get(m_surfaces[i].get()), m_plasmaSurfaces[i].get());
+    }
+
+    QBENCHMARK {
+        for (const auto &surface : m_surfaces) {
+            KWayland::Client::PlasmaShellSurface::get(surface.get());
+        }
+    }
+
+    report("PlasmaShellSurface::get", [this](size_t i) {
+        KWayland::Client::PlasmaShellSurface::get(m_surfaces[i].get());
+    });
+}
+
+QTEST_GUILESS_MAIN(ClientWrappersBenchmark)
+#include "bench_client_wrappers.moc"
@@ -0,0 +1,165 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QThread>
+#include <QtTest>
+// server
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/display.h"
+#include "../../src/server/surface_interface.h"
+// client
+#include "../../src/client/compositor.h"
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/surface.h"
+// std
+#include <algorithm>
+
+using namespace KWaylandServer;
+using namespace KWayland::Client;
+
+static const QString s_socketName = QStringLiteral("kwayland-bench-connection-thread-0");
+
+/**
+ * Measures how long it takes until a frame callback sent by the server is delivered to a
+ * render thread, while the thread owning the ConnectionThread is busy.
+ *
+ * The server lives in the main thread. The ConnectionThread lives in a "GUI" thread which
+ * is blocked for 20 ms around every frame, the surface and its EventQueue live in a render
+ * thread. Without a reader thread, the frame callback is only read once the GUI thread gets
+ * back to its event loop.
+ */
+class ConnectionThreadBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkFrameCallbackLatency_data();
+    void benchmarkFrameCallbackLatency();
+};
+
+void ConnectionThreadBenchmark::benchmarkFrameCallbackLatency_data()
+{
+    QTest::addColumn<bool>("readerThread");
+
+    QTest::newRow("socket notifier") << false;
+    QTest::newRow("reader thread") << true;
+}
+
+void ConnectionThreadBenchmark::benchmarkFrameCallbackLatency()
+{
+    QFETCH(bool, readerThread);
+    const int frames = 50;
+    const int guiBlockMs = 20;
+
+    Display display;
+    display.addSocketName(s_socketName);
+    display.start();
+    QVERIFY(display.isRunning());
+    CompositorInterface *serverCompositor = new CompositorInterface(&display, &display);
+
+    QThread guiThread;
+    QThread renderThread;
+    ConnectionThread *connection = new ConnectionThread;
+    connection->setSocketName(s_socketName);
+    connection->setUseReaderThread(readerThread);
+    QCOMPARE(connection->usesReaderThread(), readerThread);
+    QSignalSpy connectedSpy(connection, &ConnectionThread::connected);
+    connection->moveToThread(&guiThread);
+    guiThread.start();
+    renderThread.start();
+    connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    EventQueue mainQueue;
+    mainQueue.setup(connection);
+    EventQueue *renderQueue = new EventQueue;
+    renderQueue->setup(connection);
+    renderQueue->moveToThread(&renderThread);
+
+    Registry registry;
+    QSignalSpy interfacesAnnouncedSpy(&registry, &Registry::interfacesAnnounced);
+    registry.setEventQueue(&mainQueue);
+    registry.create(connection);
+    registry.setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+    const Registry::AnnouncedInterface compositorInterface = registry.interface(Registry::Interface::Compositor);
+    QScopedPointer<Compositor> compositor(registry.createCompositor(compositorInterface.name, compositorInterface.version));
+    compositor->setEventQueue(renderQueue);
+
+    QSignalSpy surfaceCreatedSpy(serverCompositor, &CompositorInterface::surfaceCreated);
+    QScopedPointer<Surface> surface(compositor->createSurface());
+    QVERIFY(surfaceCreatedSpy.wait());
+    SurfaceInterface *serverSurface = surfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 doneSentAt = 0;
+    connect(serverSurface, &SurfaceInterface::committed, serverSurface, [&]() {
+        doneSentAt = clock.nsecsElapsed();
+        serverSurface->frameRendered(clock.elapsed());
+        display.flush();
+    });
+    QAtomicInteger<qint64> doneReceivedAt = 0;
+    QSemaphore rendered;
+    connect(
+        surface.data(),
+        &Surface::frameRendered,
+        surface.data(),
+        [&]() {
+            doneReceivedAt = clock.nsecsElapsed();
+            rendered.release();
+        },
+        Qt::DirectConnection);
+
+    QObject renderContext;
+    renderContext.moveToThread(&renderThread);
+    QSemaphore guiBlocked;
+
+    QVector<qint64> latencies;
+    for (int i = 0; i < frames; ++i) {
+        QMetaObject::invokeMethod(
+            connection,
+            [&guiBlocked, guiBlockMs]() {
+                guiBlocked.release();
+                QThread::msleep(guiBlockMs);
+            },
+            Qt::QueuedConnection);
+        QVERIFY(guiBlocked.tryAcquire(1, 5000));
+
+        QMetaObject::invokeMethod(
+            &renderContext,
+            [&]() {
+                surface->commit(Surface::CommitFlag::FrameCallback);
+                connection->flush();
+            },
+            Qt::QueuedConnection);
+        QTRY_VERIFY_WITH_TIMEOUT(rendered.tryAcquire(), 5000);
+        latencies << doneReceivedAt - doneSentAt;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    qInfo("frame callback latency with a busy GUI thread, %s: median %.1f us, max %.1f us",
+          readerThread ? "reader thread" : "socket notifier",
+          latencies.at(latencies.count() / 2) / 1000.0,
+          latencies.last() / 1000.0);
+
+    surface.reset();
+    compositor.reset();
+    registry.release();
+    mainQueue.release();
+    renderThread.quit();
+    renderThread.wait();
+    delete renderQueue;
+    connection->deleteLater();
+    guiThread.quit();
+    guiThread.wait();
+}
+
+QTEST_GUILESS_MAIN(ConnectionThreadBenchmark)
+#include "bench_connection_thread.moc"
@@ -0,0 +1,172 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QElapsedTimer>
+#include <QtTest>
+// server
+#include "../../src/server/display.h"
+#include "../../src/server/idle_interface.h"
+#include "../../src/server/seat_interface.h"
+// client
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/idle.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/seat.h"
+// std
+#include <memory>
+#include <vector>
+// system
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "allocationcounter.h"
+
+using namespace KWaylandServer;
+
+/**
+ * Measures what an input event costs when idle timeouts are registered.
+ *
+ * The compositor reports every key press and pointer motion with
+ * IdleInterface::simulateUserActivity, so the cost must not grow with the number of
+ * clients watching for idle. The timeouts are long enough to never fire during the run.
+ */
+class IdleBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkUserActivity_data();
+    void benchmarkUserActivity();
+
+private:
+    void createTimeouts(int count);
+    void dispatch();
+
+    Display *m_display = nullptr;
+    SeatInterface *m_seat = nullptr;
+    IdleInterface *m_idle = nullptr;
+    KWayland::Client::ConnectionThread *m_connection = nullptr;
+    KWayland::Client::EventQueue *m_queue = nullptr;
+    KWayland::Client::Registry *m_registry = nullptr;
+    KWayland::Client::Seat *m_clientSeat = nullptr;
+    KWayland::Client::Idle *m_clientIdle = nullptr;
+    std::vector<std::unique_ptr<KWayland::Client::IdleTimeout>> m_timeouts;
+};
+
+void IdleBenchmark::initTestCase()
+{
+    m_display = new Display(this);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+    m_seat = new SeatInterface(m_display, m_display);
+    m_idle = new IdleInterface(m_display, m_display);
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    QVERIFY(m_display->createClient(sv[0]));
+
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketFd(sv[1]);
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    m_registry = new KWayland::Client::Registry(this);
+    QSignalSpy interfacesAnnouncedSpy(m_registry, &KWayland::Client::Registry::interfacesAnnounced);
+    m_registry->setEventQueue(m_queue);
+    m_registry->create(m_connection->display());
+    QVERIFY(m_registry->isValid());
+    m_registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+
+    const auto seat = m_registry->interface(KWayland::Client::Registry::Interface::Seat);
+    m_clientSeat = m_registry->createSeat(seat.name, seat.version, this);
+    QVERIFY(m_clientSeat->isValid());
+    const auto idle = m_registry->interface(KWayland::Client::Registry::Interface::Idle);
+    m_clientIdle = m_registry->createIdle(idle.name, idle.version, this);
+    QVERIFY(m_clientIdle->isValid());
+}
+
+void IdleBenchmark::cleanupTestCase()
+{
+    m_timeouts.clear();
+    delete m_clientIdle;
+    m_clientIdle = nullptr;
+    delete m_clientSeat;
+    m_clientSeat = nullptr;
+    delete m_registry;
+    m_registry = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    delete m_connection;
+    m_connection = nullptr;
+    delete m_display;
+    m_display = nullptr;
+}
+
+void IdleBenchmark::createTimeouts(int count)
+{
+    m_timeouts.clear();
+    for (int i = 0; i < count; ++i) {
+        // spread the deadlines, they are a minute or more away
+        m_timeouts.emplace_back(m_clientIdle->getTimeout(60000 + i, m_clientSeat));
+        // Keep the socket buffer from filling up.
+        if (i % 100 == 0) {
+            dispatch();
+        }
+    }
+    dispatch();
+}
+
+void IdleBenchmark::dispatch()
+{
+    m_connection->flush();
+    m_display->dispatchEvents();
+}
+
+void IdleBenchmark::benchmarkUserActivity_data()
+{
+    QTest::addColumn<int>("timeouts");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void IdleBenchmark::benchmarkUserActivity()
+{
+    QFETCH(int, timeouts);
+    createTimeouts(timeouts);
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            m_idle->simulateUserActivity(m_seat);
+        }
+    }
+
+    static const int events = 100000;
+    const quint64 allocationsBefore = AllocationCounter::count();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < events; ++i) {
+        m_idle->simulateUserActivity(m_seat);
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    qInfo("user activity with %d idle timeouts: %.1f ns/event, %.3f allocations/event",
+          timeouts,
+          double(elapsed) / events,
+          AllocationCounter::isSupported() ? double(AllocationCounter::count() - allocationsBefore) / events : qQNaN());
+}
+
+QTEST_GUILESS_MAIN(IdleBenchmark)
+#include "bench_idle.moc"
@@ -0,0 +1,178 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QElapsedTimer>
+#include <QtTest>
+// server
+#include "../../src/server/display.h"
+#include "../../src/server/plasmawindowmanagement_interface.h"
+// client
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/plasmawindowmanagement.h"
+#include "../../src/client/plasmawindowmodel.h"
+#include "../../src/client/registry.h"
+// std
+#include <memory>
+#include <vector>
+// system
+#include <sys/socket.h>
+
+using namespace KWaylandServer;
+
+/**
+ * Replays the geometry updates of an interactive move against a PlasmaWindowModel, as seen
+ * by a taskbar while the user drags a window around.
+ *
+ * The server sends one geometry per step for the dragged window and flushes, the client
+ * dispatches after every few steps like it would when busy painting. Reported is the
+ * client side time per geometry update and the number of dataChanged the model emitted.
+ */
+class PlasmaWindowModelBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkGeometryDrag_data();
+    void benchmarkGeometryDrag();
+
+private:
+    void createWindows(int count);
+
+    Display *m_display = nullptr;
+    PlasmaWindowManagementInterface *m_windowManagementInterface = nullptr;
+    std::vector<std::unique_ptr<PlasmaWindowInterface>> m_windowInterfaces;
+    KWayland::Client::ConnectionThread *m_connection = nullptr;
+    KWayland::Client::EventQueue *m_queue = nullptr;
+    KWayland::Client::Registry *m_registry = nullptr;
+    KWayland::Client::PlasmaWindowManagement *m_windowManagement = nullptr;
+};
+
+void PlasmaWindowModelBenchmark::initTestCase()
+{
+    m_display = new Display(this);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+    m_windowManagementInterface = new PlasmaWindowManagementInterface(m_display, m_display);
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    QVERIFY(m_display->createClient(sv[0]));
+
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketFd(sv[1]);
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    m_registry = new KWayland::Client::Registry(this);
+    QSignalSpy interfacesAnnouncedSpy(m_registry, &KWayland::Client::Registry::interfacesAnnounced);
+    m_registry->setEventQueue(m_queue);
+    m_registry->create(m_connection->display());
+    QVERIFY(m_registry->isValid());
+    m_registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+
+    const auto windowManagement = m_registry->interface(KWayland::Client::Registry::Interface::PlasmaWindowManagement);
+    m_windowManagement = m_registry->createPlasmaWindowManagement(windowManagement.name, windowManagement.version, this);
+    QVERIFY(m_windowManagement->isValid());
+}
+
+void PlasmaWindowModelBenchmark::cleanupTestCase()
+{
+    m_windowInterfaces.clear();
+    delete m_windowManagement;
+    m_windowManagement = nullptr;
+    delete m_registry;
+    m_registry = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    delete m_connection;
+    m_connection = nullptr;
+    delete m_display;
+    m_display = nullptr;
+}
+
+void PlasmaWindowModelBenchmark::createWindows(int count)
+{
+    m_windowInterfaces.clear();
+    QTRY_COMPARE(m_windowManagement->windows().count(), 0);
+
+    QSignalSpy windowCreatedSpy(m_windowManagement, &KWayland::Client::PlasmaWindowManagement::windowCreated);
+    for (int i = 0; i < count; ++i) {
+        m_windowInterfaces.emplace_back(m_windowManagementInterface->createWindow(nullptr, QUuid::createUuid()));
+        PlasmaWindowInterface *window = m_windowInterfaces.back().get();
+        window->setTitle(QStringLiteral("Window %1").arg(i));
+        window->setAppId(QStringLiteral("org.kde.bench%1").arg(i % 20));
+        window->setGeometry(QRect(i, i, 800, 600));
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(windowCreatedSpy.count(), count, 10000);
+}
+
+void PlasmaWindowModelBenchmark::benchmarkGeometryDrag_data()
+{
+    QTest::addColumn<int>("windows");
+
+    QTest::newRow("30") << 30;
+    QTest::newRow("300") << 300;
+}
+
+void PlasmaWindowModelBenchmark::benchmarkGeometryDrag()
+{
+    QFETCH(int, windows);
+    createWindows(windows);
+
+    QScopedPointer<KWayland::Client::PlasmaWindowModel> model(m_windowManagement->createWindowModel());
+    QCOMPARE(model->rowCount(), windows);
+    int dataChangedCount = 0;
+    connect(model.data(), &KWayland::Client::PlasmaWindowModel::dataChanged, this, [&dataChangedCount] {
+        ++dataChangedCount;
+    });
+
+    // The window in the middle of the list, so row lookups do not hit the best case.
+    PlasmaWindowInterface *dragged = m_windowInterfaces.at(windows / 2).get();
+    KWayland::Client::PlasmaWindow *draggedWindow = m_windowManagement->windows().at(windows / 2);
+    static const int steps = 2000;
+    static const int stepsPerDispatch = 4;
+
+    qint64 clientNs = 0;
+    int position = 0;
+    QBENCHMARK {
+        dataChangedCount = 0;
+        clientNs = 0;
+        for (int i = 0; i < steps; ++i) {
+            ++position;
+            dragged->setGeometry(QRect(position, position / 2, 800, 600));
+            m_display->flush();
+            if ((i + 1) % stepsPerDispatch == 0) {
+                QElapsedTimer timer;
+                timer.start();
+                QCoreApplication::processEvents();
+                clientNs += timer.nsecsElapsed();
+            }
+        }
+        QElapsedTimer timer;
+        timer.start();
+        QTRY_COMPARE(draggedWindow->geometry().x(), position);
+        QCoreApplication::processEvents();
+        clientNs += timer.nsecsElapsed();
+    }
+
+    qInfo("geometry drag with %d windows: %.1f ns/update on the client, %d dataChanged for %d updates",
+          windows,
+          double(clientNs) / steps,
+          dataChangedCount,
+          steps);
+}
+
+QTEST_GUILESS_MAIN(PlasmaWindowModelBenchmark)
+#include "bench_plasma_window_model.moc"
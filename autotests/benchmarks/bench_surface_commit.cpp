@@ -0,0 +1,376 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QElapsedTimer>
+#include <QtTest>
+// server
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/display.h"
+#include "../../src/server/subcompositor_interface.h"
+#include "../../src/server/surface_interface.h"
+#include "../../src/server/viewporter_interface.h"
+// client
+#include "../../src/client/compositor.h"
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/shm_pool.h"
+#include "../../src/client/subcompositor.h"
+#include "../../src/client/subsurface.h"
+#include "../../src/client/surface.h"
+// Wayland
+#include <wayland-client-protocol.h>
+#include "qwayland-viewporter.h"
+// std
+#include <memory>
+#include <vector>
+// system
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "allocationcounter.h"
+
+using namespace KWaylandServer;
+
+class Viewport : public QtWayland::wp_viewport
+{
+};
+
+/**
+ * Measures the server side cost of wl_surface.commit.
+ *
+ * The client and the server live in the same thread and talk over a socketpair, so each
+ * iteration is fully synchronous: the client marshals the requests, flushes the socket
+ * and the server dispatches them. The numbers therefore include the (small and constant)
+ * client side marshalling cost, but no event loop latency.
+ */
+class SurfaceCommitBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkPlainCommit();
+    void benchmarkSynchronizedSubSurfaceTree_data();
+    void benchmarkSynchronizedSubSurfaceTree();
+    void benchmarkViewportTransformCommit();
+    void benchmarkDamageHeavyCommit_data();
+    void benchmarkDamageHeavyCommit();
+
+private:
+    struct TestSurface {
+        QScopedPointer<KWayland::Client::Surface> client;
+        SurfaceInterface *server = nullptr;
+    };
+
+    bool createSurface(TestSurface *surface);
+    void dispatch();
+    template<typename Fn>
+    void report(const char *name, int commitsPerIteration, Fn fn);
+
+    Display *m_display = nullptr;
+    CompositorInterface *m_serverCompositor = nullptr;
+    KWayland::Client::ConnectionThread *m_connection = nullptr;
+    KWayland::Client::EventQueue *m_queue = nullptr;
+    KWayland::Client::Registry *m_registry = nullptr;
+    KWayland::Client::Compositor *m_compositor = nullptr;
+    KWayland::Client::SubCompositor *m_subCompositor = nullptr;
+    KWayland::Client::ShmPool *m_shm = nullptr;
+    QtWayland::wp_viewporter *m_viewporter = nullptr;
+    quint64 m_serverCommits = 0;
+};
+
+void SurfaceCommitBenchmark::initTestCase()
+{
+    m_display = new Display(this);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+    m_display->createShm();
+    m_serverCompositor = new CompositorInterface(m_display, m_display);
+    new SubCompositorInterface(m_display, m_display);
+    new ViewporterInterface(m_display, m_display);
+
+    connect(m_serverCompositor, &CompositorInterface::surfaceCreated, this, [this](SurfaceInterface *surface) {
+        connect(surface, &SurfaceInterface::committed, this, [this] {
+            m_serverCommits++;
+        });
+    });
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    QVERIFY(m_display->createClient(sv[0]));
+
+    // The client intentionally lives in the server thread, see class documentation.
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketFd(sv[1]);
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    m_registry = new KWayland::Client::Registry(this);
+    connect(m_registry, &KWayland::Client::Registry::interfaceAnnounced, this, [this](const QByteArray &interface, quint32 id, quint32 version) {
+        if (interface == QByteArrayLiteral("wp_viewporter")) {
+            m_viewporter = new QtWayland::wp_viewporter();
+            m_viewporter->init(*m_registry, id, version);
+        }
+    });
+    QSignalSpy interfacesAnnouncedSpy(m_registry, &KWayland::Client::Registry::interfacesAnnounced);
+    m_registry->setEventQueue(m_queue);
+    m_registry->create(m_connection->display());
+    QVERIFY(m_registry->isValid());
+    m_registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+    QVERIFY(m_viewporter);
+
+    const auto compositor = m_registry->interface(KWayland::Client::Registry::Interface::Compositor);
+    m_compositor = m_registry->createCompositor(compositor.name, compositor.version, this);
+    QVERIFY(m_compositor->isValid());
+    const auto subCompositor = m_registry->interface(KWayland::Client::Registry::Interface::SubCompositor);
+    m_subCompositor = m_registry->createSubCompositor(subCompositor.name, subCompositor.version, this);
+    QVERIFY(m_subCompositor->isValid());
+    const auto shm = m_registry->interface(KWayland::Client::Registry::Interface::Shm);
+    m_shm = m_registry->createShmPool(shm.name, shm.version, this);
+    QVERIFY(m_shm->isValid());
+}
+
+void SurfaceCommitBenchmark::cleanupTestCase()
+{
+    delete m_viewporter;
+    m_viewporter = nullptr;
+    delete m_shm;
+    m_shm = nullptr;
+    delete m_subCompositor;
+    m_subCompositor = nullptr;
+    delete m_compositor;
+    m_compositor = nullptr;
+    delete m_registry;
+    m_registry = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    delete m_connection;
+    m_connection = nullptr;
+    delete m_display;
+    m_display = nullptr;
+}
+
+bool SurfaceCommitBenchmark::createSurface(TestSurface *surface)
+{
+    QSignalSpy surfaceCreatedSpy(m_serverCompositor, &CompositorInterface::surfaceCreated);
+    surface->client.reset(m_compositor->createSurface());
+    dispatch();
+    if (surfaceCreatedSpy.count() != 1) {
+        return false;
+    }
+    surface->server = surfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+    return surface->server;
+}
+
+void SurfaceCommitBenchmark::dispatch()
+{
+    m_connection->flush();
+    m_display->dispatchEvents();
+}
+
+template<typename Fn>
+void SurfaceCommitBenchmark::report(const char *name, int commitsPerIteration, Fn fn)
+{
+    // QBENCHMARK gives the per iteration wall time, this gives the per commit numbers
+    // that are easier to compare across scenarios.
+    static const int iterations = 2000;
+    const quint64 commitsBefore = m_serverCommits;
+    const quint64 allocationsBefore = AllocationCounter::count();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    const quint64 allocations = AllocationCounter::count() - allocationsBefore;
+    const quint64 commits = m_serverCommits - commitsBefore;
+    QCOMPARE(commits, quint64(iterations) * commitsPerIteration);
+
+    qInfo("%s: %.1f ns/commit, %.2f allocations/commit, %.0f commits/s",
+          name,
+          double(elapsed) / commits,
+          AllocationCounter::isSupported() ? double(allocations) / commits : qQNaN(),
+          commits * 1e9 / elapsed);
+}
+
+void SurfaceCommitBenchmark::benchmarkPlainCommit()
+{
+    TestSurface surface;
+    QVERIFY(createSurface(&surface));
+
+    QImage image(QSize(256, 256), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::red);
+    KWayland::Client::Buffer::Ptr buffer = m_shm->createBuffer(image);
+
+    auto commit = [&] {
+        surface.client->attachBuffer(buffer);
+        surface.client->damage(image.rect());
+        surface.client->commit(KWayland::Client::Surface::CommitFlag::None);
+        dispatch();
+    };
+    commit();
+    QVERIFY(surface.server->isMapped());
+
+    QBENCHMARK {
+        commit();
+    }
+    report("plain", 1, commit);
+}
+
+void SurfaceCommitBenchmark::benchmarkSynchronizedSubSurfaceTree_data()
+{
+    QTest::addColumn<int>("depth");
+
+    QTest::newRow("depth 4") << 4;
+    QTest::newRow("depth 16") << 16;
+    QTest::newRow("depth 64") << 64;
+}
+
+void SurfaceCommitBenchmark::benchmarkSynchronizedSubSurfaceTree()
+{
+    QFETCH(int, depth);
+
+    QImage image(QSize(64, 64), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::blue);
+    KWayland::Client::Buffer::Ptr buffer = m_shm->createBuffer(image);
+
+    // Build a chain root <- child 1 <- ... <- child N, every sub-surface is synchronized.
+    std::vector<std::unique_ptr<TestSurface>> surfaces;
+    std::vector<std::unique_ptr<KWayland::Client::SubSurface>> subSurfaces;
+    for (int i = 0; i <= depth; ++i) {
+        auto surface = std::make_unique<TestSurface>();
+        QVERIFY(createSurface(surface.get()));
+        if (i > 0) {
+            KWayland::Client::SubSurface *subSurface = m_subCompositor->createSubSurface(surface->client.data(), surfaces.back()->client.data());
+            subSurface->setMode(KWayland::Client::SubSurface::Mode::Synchronized);
+            subSurface->setPosition(QPoint(1, 1));
+            subSurfaces.emplace_back(subSurface);
+        }
+        surfaces.push_back(std::move(surface));
+    }
+    dispatch();
+
+    // Children are committed bottom-up, the root commit applies the whole tree.
+    auto commit = [&] {
+        for (auto it = surfaces.rbegin(); it != surfaces.rend(); ++it) {
+            KWayland::Client::Surface *surface = (*it)->client.data();
+            surface->attachBuffer(buffer);
+            surface->damage(image.rect());
+            surface->commit(KWayland::Client::Surface::CommitFlag::None);
+        }
+        dispatch();
+    };
+    commit();
+    QVERIFY(surfaces.back()->server->isMapped());
+
+    QBENCHMARK {
+        commit();
+    }
+    // Each child applies its state from the cache once, when its parent commits.
+    report(qPrintable(QStringLiteral("subsurface tree, depth %1").arg(depth)), depth + 1, commit);
+
+    subSurfaces.clear();
+    surfaces.clear();
+    dispatch();
+}
+
+void SurfaceCommitBenchmark::benchmarkViewportTransformCommit()
+{
+    TestSurface surface;
+    QVERIFY(createSurface(&surface));
+
+    QImage image(QSize(512, 256), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::green);
+    KWayland::Client::Buffer::Ptr buffer = m_shm->createBuffer(image);
+
+    Viewport viewport;
+    viewport.init(m_viewporter->get_viewport(*surface.client));
+    surface.client->setScale(2);
+    wl_surface_set_buffer_transform(*surface.client, WL_OUTPUT_TRANSFORM_FLIPPED_90);
+
+    // Alternate the destination size so the surface to buffer mapping changes on every commit.
+    bool toggle = false;
+    auto commit = [&] {
+        toggle = !toggle;
+        viewport.set_source(wl_fixed_from_int(8), wl_fixed_from_int(8), wl_fixed_from_int(96), wl_fixed_from_int(192));
+        viewport.set_destination(toggle ? 300 : 200, toggle ? 600 : 400);
+        surface.client->attachBuffer(buffer);
+        surface.client->damageBuffer(QRect(0, 0, 128, 128));
+        surface.client->commit(KWayland::Client::Surface::CommitFlag::None);
+        dispatch();
+    };
+    commit();
+    QVERIFY(surface.server->isMapped());
+
+    QBENCHMARK {
+        commit();
+    }
+    report("viewport+transform", 1, commit);
+
+    viewport.destroy();
+}
+
+void SurfaceCommitBenchmark::benchmarkDamageHeavyCommit_data()
+{
+    QTest::addColumn<int>("rects");
+    QTest::addColumn<bool>("bufferDamage");
+
+    QTest::newRow("64 surface rects") << 64 << false;
+    QTest::newRow("256 surface rects") << 256 << false;
+    QTest::newRow("64 buffer rects") << 64 << true;
+    QTest::newRow("256 buffer rects") << 256 << true;
+}
+
+void SurfaceCommitBenchmark::benchmarkDamageHeavyCommit()
+{
+    QFETCH(int, rects);
+    QFETCH(bool, bufferDamage);
+
+    TestSurface surface;
+    QVERIFY(createSurface(&surface));
+
+    QImage image(QSize(1024, 1024), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::black);
+    KWayland::Client::Buffer::Ptr buffer = m_shm->createBuffer(image);
+
+    // Small, mostly disjoint rectangles similar to what a terminal emulator sends.
+    QVector<QRect> damage;
+    damage.reserve(rects);
+    for (int i = 0; i < rects; ++i) {
+        damage.append(QRect((i * 37) % 1000, (i * 53) % 1000, 8 + i % 16, 16));
+    }
+
+    auto commit = [&] {
+        surface.client->attachBuffer(buffer);
+        for (const QRect &rect : qAsConst(damage)) {
+            if (bufferDamage) {
+                surface.client->damageBuffer(rect);
+            } else {
+                surface.client->damage(rect);
+            }
+        }
+        surface.client->commit(KWayland::Client::Surface::CommitFlag::None);
+        dispatch();
+    };
+    commit();
+    QVERIFY(surface.server->isMapped());
+
+    QBENCHMARK {
+        commit();
+    }
+    report(qPrintable(QStringLiteral("damage, %1 %2 rects").arg(rects).arg(bufferDamage ? QStringLiteral("buffer") : QStringLiteral("surface"))), 1, commit);
+}
+
+QTEST_GUILESS_MAIN(SurfaceCommitBenchmark)
+#include "bench_surface_commit.moc"
@@ -0,0 +1,283 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QtTest>
+// client
+#include "../../src/client/compositor.h"
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/cursorshape.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/pointer.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/seat.h"
+#include "../../src/client/surface.h"
+// server
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/cursorshape_v1_interface.h"
+#include "../../src/server/display.h"
+#include "../../src/server/pointer_interface.h"
+#include "../../src/server/seat_interface.h"
+#include "../../src/server/surface_interface.h"
+
+using namespace KWayland::Client;
+using namespace KWaylandServer;
+
+class TestCursorShape : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testSetShape();
+    void testMixWithSurface();
+    void testUnfocused();
+    void testInvalidShape();
+    void testShapeName();
+
+private:
+    SurfaceInterface *createSurface(QScopedPointer<Surface> &surface);
+    quint32 enterPointer(SurfaceInterface *surface);
+
+    Display *m_display = nullptr;
+    CompositorInterface *m_compositorInterface = nullptr;
+    SeatInterface *m_seatInterface = nullptr;
+    CursorShapeManagerV1Interface *m_cursorShapeManagerInterface = nullptr;
+    ConnectionThread *m_connection = nullptr;
+    Compositor *m_compositor = nullptr;
+    Seat *m_seat = nullptr;
+    Pointer *m_pointer = nullptr;
+    CursorShapeManager *m_cursorShapeManager = nullptr;
+    EventQueue *m_queue = nullptr;
+    Registry *m_registry = nullptr;
+    QThread *m_thread = nullptr;
+};
+
+static const QString s_socketName = QStringLiteral("kwayland-test-cursor-shape-0");
+
+void TestCursorShape::init()
+{
+    delete m_display;
+    m_display = new Display(this);
+    m_display->addSocketName(s_socketName);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+
+    m_compositorInterface = new CompositorInterface(m_display, m_display);
+    m_seatInterface = new SeatInterface(m_display, m_display);
+    m_seatInterface->setHasPointer(true);
+    m_cursorShapeManagerInterface = new CursorShapeManagerV1Interface(m_display, m_display);
+
+    // setup connection
+    m_connection = new ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &ConnectionThread::connected);
+    QVERIFY(connectedSpy.isValid());
+    m_connection->setSocketName(s_socketName);
+
+    m_thread = new QThread(this);
+    m_connection->moveToThread(m_thread);
+    m_thread->start();
+
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    m_registry = new Registry();
+    QSignalSpy interfacesAnnouncedSpy(m_registry, &Registry::interfacesAnnounced);
+    QVERIFY(interfacesAnnouncedSpy.isValid());
+    m_registry->setEventQueue(m_queue);
+    m_registry->create(m_connection);
+    QVERIFY(m_registry->isValid());
+    m_registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+
+    const auto compositor = m_registry->interface(Registry::Interface::Compositor);
+    m_compositor = m_registry->createCompositor(compositor.name, compositor.version, this);
+    QVERIFY(m_compositor->isValid());
+
+    const auto seat = m_registry->interface(Registry::Interface::Seat);
+    m_seat = m_registry->createSeat(seat.name, seat.version, this);
+    QSignalSpy hasPointerSpy(m_seat, &Seat::hasPointerChanged);
+    QVERIFY(hasPointerSpy.wait());
+    m_pointer = m_seat->createPointer(this);
+    QVERIFY(m_pointer->isValid());
+
+    QVERIFY(m_registry->hasInterface(Registry::Interface::CursorShapeManagerV1));
+    const auto cursorShape = m_registry->interface(Registry::Interface::CursorShapeManagerV1);
+    m_cursorShapeManager = m_registry->createCursorShapeManager(cursorShape.name, cursorShape.version, this);
+    QVERIFY(m_cursorShapeManager->isValid());
+}
+
+void TestCursorShape::cleanup()
+{
+#define CLEANUP(variable)   \
+    if (variable) {         \
+        delete variable;    \
+        variable = nullptr; \
+    }
+    CLEANUP(m_cursorShapeManager)
+    CLEANUP(m_pointer)
+    CLEANUP(m_seat)
+    CLEANUP(m_compositor)
+    CLEANUP(m_queue)
+    CLEANUP(m_registry)
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    CLEANUP(m_connection)
+    CLEANUP(m_display)
+#undef CLEANUP
+}
+
+SurfaceInterface *TestCursorShape::createSurface(QScopedPointer<Surface> &surface)
+{
+    QSignalSpy surfaceCreatedSpy(m_compositorInterface, &CompositorInterface::surfaceCreated);
+    surface.reset(m_compositor->createSurface());
+    if (!surfaceCreatedSpy.wait()) {
+        return nullptr;
+    }
+    return surfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+}
+
+quint32 TestCursorShape::enterPointer(SurfaceInterface *surface)
+{
+    QSignalSpy enteredSpy(m_pointer, &Pointer::entered);
+    m_seatInterface->setFocusedPointerSurface(surface, QPointF(10, 15));
+    if (!enteredSpy.wait()) {
+        return 0;
+    }
+    return enteredSpy.first().first().value<quint32>();
+}
+
+void TestCursorShape::testSetShape()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    const quint32 serial = enterPointer(serverSurface);
+    QVERIFY(serial);
+    QVERIFY(!m_seatInterface->pointer()->cursor());
+
+    QScopedPointer<CursorShapeDevice> device(m_cursorShapeManager->createDevice(m_pointer));
+    QVERIFY(device->isValid());
+
+    QSignalSpy cursorChangedSpy(m_seatInterface->pointer(), &PointerInterface::cursorChanged);
+    device->setShape(serial, CursorShapeDevice::Shape::NwseResize);
+    QVERIFY(cursorChangedSpy.wait());
+    Cursor *cursor = m_seatInterface->pointer()->cursor();
+    QVERIFY(cursor);
+    QCOMPARE(cursor->shape(), Cursor::Shape::NwseResize);
+    QVERIFY(!cursor->surface());
+    QCOMPARE(cursor->enteredSerial(), serial);
+
+    // changing the shape does not need a surface or a buffer
+    QSignalSpy shapeChangedSpy(cursor, &Cursor::shapeChanged);
+    QSignalSpy surfaceChangedSpy(cursor, &Cursor::surfaceChanged);
+    device->setShape(serial, CursorShapeDevice::Shape::Text);
+    QVERIFY(shapeChangedSpy.wait());
+    QCOMPARE(cursor->shape(), Cursor::Shape::Text);
+    QCOMPARE(cursorChangedSpy.count(), 2);
+    QVERIFY(surfaceChangedSpy.isEmpty());
+
+    // setting the same shape again is not a change
+    device->setShape(serial, CursorShapeDevice::Shape::Text);
+    QVERIFY(!shapeChangedSpy.wait(100));
+    QCOMPARE(cursorChangedSpy.count(), 2);
+}
+
+void TestCursorShape::testMixWithSurface()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    const quint32 serial = enterPointer(serverSurface);
+    QVERIFY(serial);
+
+    QScopedPointer<CursorShapeDevice> device(m_cursorShapeManager->createDevice(m_pointer));
+    QSignalSpy cursorChangedSpy(m_seatInterface->pointer(), &PointerInterface::cursorChanged);
+    device->setShape(serial, CursorShapeDevice::Shape::Wait);
+    QVERIFY(cursorChangedSpy.wait());
+    Cursor *cursor = m_seatInterface->pointer()->cursor();
+    QVERIFY(cursor);
+    QCOMPARE(cursor->shape(), Cursor::Shape::Wait);
+
+    // a cursor surface replaces the shape
+    QScopedPointer<Surface> cursorSurface(m_compositor->createSurface());
+    QSignalSpy surfaceChangedSpy(cursor, &Cursor::surfaceChanged);
+    QSignalSpy shapeChangedSpy(cursor, &Cursor::shapeChanged);
+    m_pointer->setCursor(cursorSurface.data(), QPoint(1, 2));
+    QVERIFY(surfaceChangedSpy.wait());
+    QVERIFY(cursor->surface());
+    QCOMPARE(cursor->hotspot(), QPoint(1, 2));
+    QCOMPARE(cursor->shape(), Cursor::Shape::None);
+    QCOMPARE(shapeChangedSpy.count(), 1);
+
+    // and the shape replaces the cursor surface
+    device->setShape(serial, CursorShapeDevice::Shape::Grab);
+    QVERIFY(shapeChangedSpy.wait());
+    QVERIFY(!cursor->surface());
+    QCOMPARE(cursor->hotspot(), QPoint());
+    QCOMPARE(cursor->shape(), Cursor::Shape::Grab);
+    QCOMPARE(surfaceChangedSpy.count(), 2);
+}
+
+void TestCursorShape::testUnfocused()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    const quint32 serial = enterPointer(serverSurface);
+    QVERIFY(serial);
+
+    QSignalSpy leftSpy(m_pointer, &Pointer::left);
+    m_seatInterface->setFocusedPointerSurface(nullptr);
+    QVERIFY(leftSpy.wait());
+
+    // the cursor can only be changed while a surface of the client is focused
+    QScopedPointer<CursorShapeDevice> device(m_cursorShapeManager->createDevice(m_pointer));
+    QSignalSpy cursorChangedSpy(m_seatInterface->pointer(), &PointerInterface::cursorChanged);
+    device->setShape(serial, CursorShapeDevice::Shape::Pointer);
+    QVERIFY(!cursorChangedSpy.wait(100));
+    QVERIFY(!m_seatInterface->pointer()->cursor());
+}
+
+void TestCursorShape::testInvalidShape()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    const quint32 serial = enterPointer(serverSurface);
+    QVERIFY(serial);
+
+    QScopedPointer<CursorShapeDevice> device(m_cursorShapeManager->createDevice(m_pointer));
+    QSignalSpy errorSpy(m_connection, &ConnectionThread::errorOccurred);
+    device->setShape(serial, CursorShapeDevice::Shape(int(CursorShapeDevice::Shape::ZoomOut) + 1));
+    QVERIFY(errorSpy.wait());
+    QVERIFY(m_connection->hasError());
+    QVERIFY(!m_seatInterface->pointer()->cursor());
+}
+
+void TestCursorShape::testShapeName()
+{
+    QCOMPARE(Cursor::shapeName(Cursor::Shape::None), QByteArray());
+    QCOMPARE(Cursor::shapeName(Cursor::Shape::Default), QByteArrayLiteral("default"));
+    QCOMPARE(Cursor::shapeName(Cursor::Shape::ContextMenu), QByteArrayLiteral("context-menu"));
+    QCOMPARE(Cursor::shapeName(Cursor::Shape::NwseResize), QByteArrayLiteral("nwse-resize"));
+    QCOMPARE(Cursor::shapeName(Cursor::Shape::ZoomOut), QByteArrayLiteral("zoom-out"));
+
+    // the server and the client enums have to match the protocol values
+    QCOMPARE(int(Cursor::Shape::ZoomOut), int(CursorShapeDevice::Shape::ZoomOut));
+    QCOMPARE(int(Cursor::Shape::Default), int(CursorShapeDevice::Shape::Default));
+}
+
+QTEST_GUILESS_MAIN(TestCursorShape)
+#include "test_cursor_shape.moc"
@@ -0,0 +1,278 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+// Qt
+#include <QtTest>
+// client
+#include "../../src/client/compositor.h"
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/output.h"
+#include "../../src/client/presentationtime.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/surface.h"
+// server
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/display.h"
+#include "../../src/server/output_interface.h"
+#include "../../src/server/presentationtime_interface.h"
+#include "../../src/server/surface_interface.h"
+
+using namespace KWayland::Client;
+using namespace KWaylandServer;
+
+Q_DECLARE_METATYPE(std::chrono::nanoseconds)
+
+class TestPresentationTime : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testClockId();
+    void testPresented();
+    void testDiscarded();
+    void testSuperseded();
+    void testCommitWithoutFeedback();
+    void testNoFeedback();
+
+private:
+    SurfaceInterface *createSurface(QScopedPointer<Surface> &surface);
+
+    Display *m_display = nullptr;
+    CompositorInterface *m_compositorInterface = nullptr;
+    OutputInterface *m_outputInterface = nullptr;
+    PresentationTimeInterface *m_presentationTimeInterface = nullptr;
+    ConnectionThread *m_connection = nullptr;
+    Compositor *m_compositor = nullptr;
+    Output *m_output = nullptr;
+    PresentationTime *m_presentationTime = nullptr;
+    EventQueue *m_queue = nullptr;
+    Registry *m_registry = nullptr;
+    QThread *m_thread = nullptr;
+};
+
+static const QString s_socketName = QStringLiteral("kwayland-test-presentation-time-0");
+
+void TestPresentationTime::init()
+{
+    qRegisterMetaType<clockid_t>("clockid_t");
+    qRegisterMetaType<std::chrono::nanoseconds>();
+    qRegisterMetaType<KWayland::Client::PresentationFeedback::Kinds>();
+
+    delete m_display;
+    m_display = new Display(this);
+    m_display->addSocketName(s_socketName);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+
+    m_compositorInterface = new CompositorInterface(m_display, m_display);
+    m_outputInterface = new OutputInterface(m_display, m_display);
+    m_outputInterface->setMode(QSize(1920, 1080));
+    m_presentationTimeInterface = new PresentationTimeInterface(m_display, m_display);
+    m_presentationTimeInterface->setClockId(CLOCK_MONOTONIC_RAW);
+
+    // setup connection
+    m_connection = new ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &ConnectionThread::connected);
+    QVERIFY(connectedSpy.isValid());
+    m_connection->setSocketName(s_socketName);
+
+    m_thread = new QThread(this);
+    m_connection->moveToThread(m_thread);
+    m_thread->start();
+
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    m_registry = new Registry();
+    QSignalSpy interfacesAnnouncedSpy(m_registry, &Registry::interfacesAnnounced);
+    QVERIFY(interfacesAnnouncedSpy.isValid());
+    m_registry->setEventQueue(m_queue);
+    m_registry->create(m_connection);
+    QVERIFY(m_registry->isValid());
+    m_registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+
+    const auto compositor = m_registry->interface(Registry::Interface::Compositor);
+    m_compositor = m_registry->createCompositor(compositor.name, compositor.version, this);
+    QVERIFY(m_compositor->isValid());
+
+    const auto output = m_registry->interface(Registry::Interface::Output);
+    m_output = m_registry->createOutput(output.name, output.version, this);
+    QSignalSpy outputChangedSpy(m_output, &Output::changed);
+    QVERIFY(outputChangedSpy.wait());
+
+    QVERIFY(m_registry->hasInterface(Registry::Interface::PresentationTime));
+    const auto presentationTime = m_registry->interface(Registry::Interface::PresentationTime);
+    m_presentationTime = m_registry->createPresentationTime(presentationTime.name, presentationTime.version, this);
+    QVERIFY(m_presentationTime->isValid());
+}
+
+void TestPresentationTime::cleanup()
+{
+#define CLEANUP(variable)   \
+    if (variable) {         \
+        delete variable;    \
+        variable = nullptr; \
+    }
+    CLEANUP(m_presentationTime)
+    CLEANUP(m_output)
+    CLEANUP(m_compositor)
+    CLEANUP(m_queue)
+    CLEANUP(m_registry)
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    CLEANUP(m_connection)
+    CLEANUP(m_display)
+#undef CLEANUP
+}
+
+SurfaceInterface *TestPresentationTime::createSurface(QScopedPointer<Surface> &surface)
+{
+    QSignalSpy surfaceCreatedSpy(m_compositorInterface, &CompositorInterface::surfaceCreated);
+    surface.reset(m_compositor->createSurface());
+    if (!surfaceCreatedSpy.wait()) {
+        return nullptr;
+    }
+    return surfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+}
+
+void TestPresentationTime::testClockId()
+{
+    if (m_presentationTime->clockId() != CLOCK_MONOTONIC_RAW) {
+        QSignalSpy clockIdChangedSpy(m_presentationTime, &PresentationTime::clockIdChanged);
+        QVERIFY(clockIdChangedSpy.wait());
+    }
+    QCOMPARE(m_presentationTime->clockId(), CLOCK_MONOTONIC_RAW);
+}
+
+void TestPresentationTime::testPresented()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    QSignalSpy committedSpy(serverSurface, &SurfaceInterface::committed);
+
+    QScopedPointer<KWayland::Client::PresentationFeedback> feedback(m_presentationTime->createFeedback(surface.data()));
+    QSignalSpy syncOutputSpy(feedback.data(), &KWayland::Client::PresentationFeedback::syncOutput);
+    QSignalSpy presentedSpy(feedback.data(), &KWayland::Client::PresentationFeedback::presented);
+    QSignalSpy discardedSpy(feedback.data(), &KWayland::Client::PresentationFeedback::discarded);
+    surface->commit(Surface::CommitFlag::None);
+    QVERIFY(committedSpy.wait());
+
+    QScopedPointer<KWaylandServer::PresentationFeedback> serverFeedback(serverSurface->takePresentationFeedback());
+    QVERIFY(serverFeedback);
+    QVERIFY(!serverSurface->takePresentationFeedback());
+
+    // more than 32 bits of seconds and of sequence
+    const std::chrono::nanoseconds timestamp = std::chrono::seconds(0x123456789) + std::chrono::nanoseconds(987654321);
+    const std::chrono::nanoseconds refresh(16666666);
+    const quint64 sequence = 0x100000002;
+    serverFeedback->presented(m_outputInterface,
+                              timestamp,
+                              refresh,
+                              sequence,
+                              KWaylandServer::PresentationFeedback::Kind::Vsync | KWaylandServer::PresentationFeedback::Kind::ZeroCopy);
+    QVERIFY(presentedSpy.wait());
+    QCOMPARE(syncOutputSpy.count(), 1);
+    QCOMPARE(syncOutputSpy.first().first().value<Output *>(), m_output);
+    QCOMPARE(presentedSpy.first().at(0).value<std::chrono::nanoseconds>(), timestamp);
+    QCOMPARE(presentedSpy.first().at(1).value<std::chrono::nanoseconds>(), refresh);
+    QCOMPARE(presentedSpy.first().at(2).value<quint64>(), sequence);
+    QCOMPARE(presentedSpy.first().at(3).value<KWayland::Client::PresentationFeedback::Kinds>(),
+             KWayland::Client::PresentationFeedback::Kind::Vsync | KWayland::Client::PresentationFeedback::Kind::ZeroCopy);
+    QVERIFY(discardedSpy.isEmpty());
+    QVERIFY(!feedback->isValid());
+
+    // reporting does not send anything twice
+    serverFeedback.reset();
+    QVERIFY(!discardedSpy.wait(100));
+}
+
+void TestPresentationTime::testDiscarded()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    QSignalSpy committedSpy(serverSurface, &SurfaceInterface::committed);
+
+    QScopedPointer<KWayland::Client::PresentationFeedback> feedback(m_presentationTime->createFeedback(surface.data()));
+    QSignalSpy discardedSpy(feedback.data(), &KWayland::Client::PresentationFeedback::discarded);
+    surface->commit(Surface::CommitFlag::None);
+    QVERIFY(committedSpy.wait());
+
+    // a feedback destroyed without reporting is discarded
+    delete serverSurface->takePresentationFeedback();
+    QVERIFY(discardedSpy.wait());
+    QVERIFY(!feedback->isValid());
+}
+
+void TestPresentationTime::testSuperseded()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    QSignalSpy committedSpy(serverSurface, &SurfaceInterface::committed);
+
+    QScopedPointer<KWayland::Client::PresentationFeedback> first(m_presentationTime->createFeedback(surface.data()));
+    QSignalSpy firstDiscardedSpy(first.data(), &KWayland::Client::PresentationFeedback::discarded);
+    surface->commit(Surface::CommitFlag::None);
+    QScopedPointer<KWayland::Client::PresentationFeedback> second(m_presentationTime->createFeedback(surface.data()));
+    QSignalSpy secondDiscardedSpy(second.data(), &KWayland::Client::PresentationFeedback::discarded);
+    surface->commit(Surface::CommitFlag::None);
+
+    // the first content update was replaced before the compositor took it
+    QVERIFY(firstDiscardedSpy.wait());
+    QTRY_COMPARE(committedSpy.count(), 2);
+    QVERIFY(secondDiscardedSpy.isEmpty());
+
+    // destroying the surface discards the feedback of the current content update
+    surface.reset();
+    QVERIFY(secondDiscardedSpy.wait());
+}
+
+void TestPresentationTime::testCommitWithoutFeedback()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    QSignalSpy committedSpy(serverSurface, &SurfaceInterface::committed);
+
+    QScopedPointer<KWayland::Client::PresentationFeedback> feedback(m_presentationTime->createFeedback(surface.data()));
+    QSignalSpy discardedSpy(feedback.data(), &KWayland::Client::PresentationFeedback::discarded);
+    surface->commit(Surface::CommitFlag::None);
+    surface->commit(Surface::CommitFlag::None);
+    QTRY_COMPARE(committedSpy.count(), 2);
+
+    // a commit without feedback does not supersede the feedback which is still pending
+    QVERIFY(!discardedSpy.wait(100));
+    QScopedPointer<KWaylandServer::PresentationFeedback> serverFeedback(serverSurface->takePresentationFeedback());
+    QVERIFY(serverFeedback);
+}
+
+void TestPresentationTime::testNoFeedback()
+{
+    QScopedPointer<Surface> surface;
+    SurfaceInterface *serverSurface = createSurface(surface);
+    QVERIFY(serverSurface);
+    QSignalSpy committedSpy(serverSurface, &SurfaceInterface::committed);
+
+    surface->commit(Surface::CommitFlag::None);
+    QVERIFY(committedSpy.wait());
+    QVERIFY(!serverSurface->takePresentationFeedback());
+}
+
+QTEST_GUILESS_MAIN(TestPresentationTime)
+#include "test_presentation_time.moc"
@@ -15,6 +15,11 @@
 #include "../../src/client/registry.h"
 #include "../../src/client/shm_pool.h"
 #include "../../src/client/surface.h"
+// system
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 class TestShmPool : public QObject
 {
@@ -32,6 +37,10 @@ private Q_SLOTS:
     void testCreateBufferFromImageWithAlpha();
     void testCreateBufferFromData();
     void testReuseBuffer();
+    void testReclaimReleasedBuffer();
+    void testGeometricGrowth();
+    void testSealedMemfd();
+    void testHugePagesFallback();
 
 private:
     KWaylandServer::Display *m_display;
@@ -204,5 +213,154 @@ void TestShmPool::testReuseBuffer()
     QVERIFY(buffer4 != buffer3);
 }
 
+void TestShmPool::testReclaimReleasedBuffer()
+{
+    QVERIFY(m_shmPool->isValid());
+    QCOMPARE(m_shmPool->bytesInUse(), 0);
+    auto buffer = m_shmPool->getBuffer(QSize(32, 32), 128);
+    QVERIFY(buffer);
+    QCOMPARE(m_shmPool->bytesInUse(), 4096);
+    const int32_t poolSize = m_shmPool->poolSize();
+    const int resizeCount = m_shmPool->resizeCount();
+    QVERIFY(poolSize >= 4096);
+
+    // fill the remaining space, so that the next buffer cannot be placed without reclaiming
+    if (poolSize > 4096) {
+        QVERIFY(m_shmPool->getBuffer(QSize(1, (poolSize - 4096) / 4), 4));
+    }
+    QCOMPARE(m_shmPool->bytesInUse(), poolSize);
+
+    // a released buffer of a different size gives its memory to the new buffer
+    buffer.toStrongRef()->setReleased(true);
+    buffer.toStrongRef()->setUsed(false);
+    auto buffer2 = m_shmPool->getBuffer(QSize(16, 64), 64);
+    QVERIFY(buffer2);
+    QVERIFY(!buffer);
+    QCOMPARE(m_shmPool->poolSize(), poolSize);
+    QCOMPARE(m_shmPool->resizeCount(), resizeCount);
+    QCOMPARE(m_shmPool->bytesInUse(), poolSize);
+
+    // a used buffer must not be reclaimed
+    buffer2.toStrongRef()->setReleased(true);
+    buffer2.toStrongRef()->setUsed(true);
+    auto buffer3 = m_shmPool->getBuffer(QSize(8, 8), 32);
+    QVERIFY(buffer3);
+    QVERIFY(buffer2);
+    QCOMPARE(m_shmPool->resizeCount(), resizeCount + 1);
+}
+
+void TestShmPool::testGeometricGrowth()
+{
+    QVERIFY(m_shmPool->isValid());
+    QSignalSpy poolResizedSpy(m_shmPool, &KWayland::Client::ShmPool::poolResized);
+    QVERIFY(poolResizedSpy.isValid());
+
+    // allocating 64 buffers of 4 KiB must not resize the pool 64 times
+    QVector<KWayland::Client::Buffer::Ptr> buffers;
+    for (int i = 0; i < 64; ++i) {
+        auto buffer = m_shmPool->getBuffer(QSize(32, 32), 128);
+        QVERIFY(buffer);
+        buffers << buffer;
+    }
+    QCOMPARE(m_shmPool->bytesInUse(), 64 * 4096);
+    QCOMPARE(m_shmPool->poolSize(), 64 * 4096);
+    QVERIFY(m_shmPool->resizeCount() <= 9);
+    QCOMPARE(poolResizedSpy.count(), m_shmPool->resizeCount());
+    QCOMPARE(m_shmPool->fragmentation(), 0.0);
+
+    // every other buffer gets released, that leaves 32 holes that cannot be coalesced
+    for (int i = 0; i < buffers.count(); i += 2) {
+        buffers[i].toStrongRef()->setReleased(true);
+    }
+    QVERIFY(m_shmPool->getBuffer(QSize(64, 64), 256));
+    QCOMPARE(m_shmPool->bytesInUse(), 32 * 4096 + 16384);
+    QVERIFY(m_shmPool->fragmentation() > 0.0);
+
+    // releasing the neighbours coalesces the holes again
+    for (int i = 1; i < buffers.count(); i += 2) {
+        buffers[i].toStrongRef()->setReleased(true);
+    }
+    const int resizeCount = m_shmPool->resizeCount();
+    QVERIFY(m_shmPool->getBuffer(QSize(128, 512), 512));
+    QCOMPARE(m_shmPool->resizeCount(), resizeCount);
+    QCOMPARE(m_shmPool->fragmentation(), 0.0);
+}
+
+// The descriptors of all Shm pool memfds in this process.
+static QVector<int> poolFileDescriptors()
+{
+    QVector<int> fds;
+    QDir dir(QStringLiteral("/proc/self/fd"));
+    const QFileInfoList entries = dir.entryInfoList(QDir::Files | QDir::System);
+    for (const QFileInfo &entry : entries) {
+        if (entry.symLinkTarget().contains(QLatin1String("memfd:dwayland-shm-pool"))) {
+            fds << entry.fileName().toInt();
+        }
+    }
+    return fds;
+}
+
+void TestShmPool::testSealedMemfd()
+{
+#ifndef MFD_CLOEXEC
+    QSKIP("memfd_create is not available");
+#else
+    QVERIFY(m_shmPool->isValid());
+    const QVector<int> fds = poolFileDescriptors();
+    QCOMPARE(fds.count(), 1);
+
+    // the pool can only grow, so the server may map it safely
+    const int seals = fcntl(fds.first(), F_GET_SEALS);
+    QVERIFY(seals != -1);
+    QVERIFY(seals & F_SEAL_SHRINK);
+    QVERIFY(seals & F_SEAL_SEAL);
+    QVERIFY(!(seals & F_SEAL_GROW));
+    QVERIFY(m_shmPool->getBuffer(QSize(256, 256), 1024));
+    QCOMPARE(m_shmPool->poolSize(), 256 * 1024);
+#endif
+}
+
+void TestShmPool::testHugePagesFallback()
+{
+#ifndef MFD_CLOEXEC
+    QSKIP("memfd_create is not available");
+#else
+    QFile hugePages(QStringLiteral("/proc/sys/vm/nr_hugepages"));
+    if (hugePages.open(QIODevice::ReadOnly) && hugePages.readAll().trimmed() != QByteArrayLiteral("0")) {
+        QSKIP("huge pages are reserved on this system");
+    }
+    // only the pool created below may be around
+    delete m_shmPool;
+    m_shmPool = nullptr;
+    QVERIFY(poolFileDescriptors().isEmpty());
+
+    KWayland::Client::Registry registry;
+    QSignalSpy shmSpy(&registry, &KWayland::Client::Registry::shmAnnounced);
+    registry.create(m_connection->display());
+    QVERIFY(registry.isValid());
+    registry.setup();
+    QVERIFY(shmSpy.wait());
+
+    // Without reserved huge pages memfd_create(MFD_HUGETLB) may still succeed, sizing or
+    // mapping the file fails later. The pool has to fall back to regular pages either way.
+    KWayland::Client::ShmPool pool;
+    pool.setHugePagesEnabled(true);
+    pool.setup(registry.bindShm(shmSpy.first().first().value<quint32>(), shmSpy.first().last().value<quint32>()));
+    QVERIFY(pool.isValid());
+    QCOMPARE(pool.poolSize(), 1024);
+
+    const QVector<int> fds = poolFileDescriptors();
+    QCOMPARE(fds.count(), 1);
+    struct stat info;
+    QCOMPARE(fstat(fds.first(), &info), 0);
+    QCOMPARE(qint64(info.st_blksize), qint64(sysconf(_SC_PAGESIZE)));
+    QVERIFY(fcntl(fds.first(), F_GET_SEALS) & F_SEAL_SHRINK);
+
+    auto buffer = pool.getBuffer(QSize(32, 32), 128);
+    QVERIFY(buffer);
+    QVERIFY(buffer.toStrongRef()->address());
+#endif
+}
+
 QTEST_GUILESS_MAIN(TestShmPool)
 #include "test_shm_pool.moc"
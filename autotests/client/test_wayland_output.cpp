@@ -27,6 +27,8 @@ private Q_SLOTS:
     void cleanup();
 
     void testRegistry();
+    void testRegistrySync();
+    void testRoundtripAsync();
     void testModeChange();
     void testScaleChange();
 
@@ -187,6 +189,58 @@ void TestWaylandOutput::testRegistry()
     QCOMPARE(output.transform(), KWayland::Client::Output::Transform::Normal);
 }
 
+void TestWaylandOutput::testRegistrySync()
+{
+    using namespace KWayland::Client;
+    Registry registry;
+    QSignalSpy interfacesAnnouncedSpy(&registry, &Registry::interfacesAnnounced);
+    QVERIFY(interfacesAnnouncedSpy.isValid());
+    QSignalSpy syncedSpy(&registry, &Registry::synced);
+    QVERIFY(syncedSpy.isValid());
+    registry.setEventQueue(m_queue);
+    registry.create(m_connection);
+    QVERIFY(registry.isValid());
+    registry.setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+
+    // bind and wait for the initial state in one go
+    const Registry::AnnouncedInterface announced = registry.interface(Registry::Interface::Output);
+    QScopedPointer<Output> output(registry.createOutput(announced.name, announced.version));
+    QSignalSpy outputChangedSpy(output.data(), &Output::changed);
+    QVERIFY(outputChangedSpy.isValid());
+    registry.sync();
+    QVERIFY(syncedSpy.wait());
+    QCOMPARE(syncedSpy.count(), 1);
+    QCOMPARE(outputChangedSpy.count(), 1);
+    QCOMPARE(output->pixelSize(), QSize(1024, 768));
+}
+
+void TestWaylandOutput::testRoundtripAsync()
+{
+    using namespace KWayland::Client;
+    QSignalSpy roundtripFinishedSpy(m_connection, &ConnectionThread::roundtripFinished);
+    QVERIFY(roundtripFinishedSpy.isValid());
+    QSignalSpy roundtripTimeoutSpy(m_connection, &ConnectionThread::roundtripTimeout);
+    QVERIFY(roundtripTimeoutSpy.isValid());
+
+    // the default queue is dispatched in the connection's thread
+    quint32 first = 0;
+    quint32 second = 0;
+    QMetaObject::invokeMethod(
+        m_connection,
+        [this, &first, &second]() {
+            first = m_connection->roundtripAsync();
+            second = m_connection->roundtripAsync(5000);
+        },
+        Qt::BlockingQueuedConnection);
+    QVERIFY(first != 0);
+    QVERIFY(second != first);
+    QTRY_COMPARE(roundtripFinishedSpy.count(), 2);
+    QCOMPARE(roundtripFinishedSpy.at(0).first().value<quint32>(), first);
+    QCOMPARE(roundtripFinishedSpy.at(1).first().value<quint32>(), second);
+    QCOMPARE(roundtripTimeoutSpy.count(), 0);
+}
+
 void TestWaylandOutput::testModeChange()
 {
     using namespace KWayland::Client;
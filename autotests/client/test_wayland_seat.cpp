@@ -69,6 +69,8 @@ private Q_SLOTS:
     void testPointerHoldGesture_data();
     void testPointerHoldGesture();
     void testPointerAxis();
+    void testPointerEventCoalescing();
+    void testPointerEventCoalescingOrder();
     void testCursor();
     void testCursorDamage();
     void testKeyboard();
@@ -1317,6 +1319,206 @@ void TestWaylandSeat::testPointerAxis()
     QCOMPARE(axisStoppedSpy.count(), 1);
 }
 
+void TestWaylandSeat::testPointerEventCoalescing()
+{
+    using namespace KWayland::Client;
+    using namespace KWaylandServer;
+
+    // first create the pointer
+    QSignalSpy hasPointerChangedSpy(m_seat, &Seat::hasPointerChanged);
+    QVERIFY(hasPointerChangedSpy.isValid());
+    m_seatInterface->setHasPointer(true);
+    QVERIFY(hasPointerChangedSpy.wait());
+    QScopedPointer<Pointer> pointer(m_seat->createPointer());
+    QVERIFY(pointer);
+
+    // now create a surface
+    QSignalSpy surfaceCreatedSpy(m_compositorInterface, &CompositorInterface::surfaceCreated);
+    QVERIFY(surfaceCreatedSpy.isValid());
+    QScopedPointer<Surface> surface(m_compositor->createSurface());
+    QVERIFY(surfaceCreatedSpy.wait());
+    auto serverSurface = surfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+    QVERIFY(serverSurface);
+
+    QImage image(QSize(100, 100), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::black);
+    surface->attachBuffer(m_shm->createBuffer(image));
+    surface->damage(image.rect());
+    surface->commit(Surface::CommitFlag::None);
+    QSignalSpy committedSpy(serverSurface, &KWaylandServer::SurfaceInterface::committed);
+    QVERIFY(committedSpy.wait());
+
+    m_seatInterface->setFocusedPointerSurface(serverSurface);
+    QCOMPARE(m_seatInterface->focusedPointerSurface(), serverSurface);
+    QSignalSpy frameSpy(pointer.data(), &Pointer::frame);
+    QVERIFY(frameSpy.isValid());
+    QVERIFY(frameSpy.wait());
+    QCOMPARE(frameSpy.count(), 1);
+
+    // only flush when told to
+    QVERIFY(!m_seatInterface->isPointerEventCoalescing());
+    QCOMPARE(m_seatInterface->pointerEventCoalescingRate(), 120);
+    m_seatInterface->setPointerEventCoalescingRate(0);
+    m_seatInterface->setPointerEventCoalescing(true);
+    QVERIFY(m_seatInterface->isPointerEventCoalescing());
+    QCOMPARE(m_seatInterface->pointerEventCoalescingRate(), 0);
+
+    QSignalSpy motionSpy(pointer.data(), &Pointer::motion);
+    QVERIFY(motionSpy.isValid());
+    QSignalSpy axisSpy(pointer.data(), &Pointer::axisChanged);
+    QVERIFY(axisSpy.isValid());
+    QSignalSpy buttonSpy(pointer.data(), &Pointer::buttonStateChanged);
+    QVERIFY(buttonSpy.isValid());
+
+    // a burst of motion and scroll events is held back
+    quint32 timestamp = 1;
+    for (int i = 1; i <= 5; ++i) {
+        m_seatInterface->setTimestamp(timestamp++);
+        m_seatInterface->notifyPointerMotion(QPointF(i * 10, i * 5));
+        m_seatInterface->notifyPointerFrame();
+    }
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerAxis(Qt::Vertical, 10, 1, PointerAxisSource::Wheel);
+    m_seatInterface->notifyPointerFrame();
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerAxis(Qt::Vertical, 5, 1, PointerAxisSource::Wheel);
+    m_seatInterface->notifyPointerFrame();
+    QVERIFY(!frameSpy.wait(100));
+    QCOMPARE(motionSpy.count(), 0);
+    QCOMPARE(axisSpy.count(), 0);
+
+    // and arrives merged into a single frame
+    m_seatInterface->flushPointerEvents();
+    QVERIFY(frameSpy.wait());
+    QCOMPARE(frameSpy.count(), 2);
+    QCOMPARE(motionSpy.count(), 1);
+    QCOMPARE(motionSpy.last().first().toPointF(), QPointF(50, 25));
+    QCOMPARE(motionSpy.last().last().value<quint32>(), quint32(5));
+    QCOMPARE(axisSpy.count(), 1);
+    QCOMPARE(axisSpy.last().at(0).value<quint32>(), quint32(7));
+    QCOMPARE(axisSpy.last().at(1).value<Pointer::Axis>(), Pointer::Axis::Vertical);
+    QCOMPARE(axisSpy.last().at(2).value<qreal>(), 15.0);
+
+    SeatInterface::PointerCoalescingStatistics statistics = m_seatInterface->pointerCoalescingStatistics();
+    QCOMPARE(statistics.coalescedMotionEvents, quint64(4));
+    QCOMPARE(statistics.coalescedAxisEvents, quint64(1));
+    QCOMPARE(statistics.coalescedFrames, quint64(6));
+    QCOMPARE(statistics.flushes, quint64(1));
+
+    // a button flushes the pending motion first
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerMotion(QPointF(60, 30));
+    m_seatInterface->notifyPointerFrame();
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerButton(Qt::LeftButton, PointerButtonState::Pressed);
+    m_seatInterface->notifyPointerFrame();
+    QVERIFY(buttonSpy.wait());
+    QCOMPARE(motionSpy.count(), 2);
+    QCOMPARE(motionSpy.last().first().toPointF(), QPointF(60, 30));
+    QCOMPARE(motionSpy.last().last().value<quint32>(), quint32(8));
+    QCOMPARE(buttonSpy.last().at(1).value<quint32>(), quint32(9));
+    QTRY_COMPARE(frameSpy.count(), 4);
+    QCOMPARE(m_seatInterface->pointerCoalescingStatistics().flushes, quint64(2));
+
+    // without coalescing, motion is sent right away again
+    m_seatInterface->setPointerEventCoalescing(false);
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerMotion(QPointF(70, 35));
+    QVERIFY(motionSpy.wait());
+    QCOMPARE(motionSpy.count(), 3);
+    QCOMPARE(motionSpy.last().first().toPointF(), QPointF(70, 35));
+}
+
+void TestWaylandSeat::testPointerEventCoalescingOrder()
+{
+    using namespace KWayland::Client;
+    using namespace KWaylandServer;
+
+    QSignalSpy hasPointerChangedSpy(m_seat, &Seat::hasPointerChanged);
+    QVERIFY(hasPointerChangedSpy.isValid());
+    m_seatInterface->setHasPointer(true);
+    QVERIFY(hasPointerChangedSpy.wait());
+    QScopedPointer<Pointer> pointer(m_seat->createPointer());
+    QVERIFY(pointer);
+    QScopedPointer<RelativePointer> relativePointer(m_relativePointerManager->createRelativePointer(pointer.data()));
+    QVERIFY(relativePointer->isValid());
+    QScopedPointer<PointerSwipeGesture> gesture(m_pointerGestures->createSwipeGesture(pointer.data()));
+    QVERIFY(gesture->isValid());
+
+    QSignalSpy surfaceCreatedSpy(m_compositorInterface, &CompositorInterface::surfaceCreated);
+    QVERIFY(surfaceCreatedSpy.isValid());
+    QScopedPointer<Surface> surface(m_compositor->createSurface());
+    QVERIFY(surfaceCreatedSpy.wait());
+    auto serverSurface = surfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+    QVERIFY(serverSurface);
+
+    QImage image(QSize(100, 100), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::black);
+    surface->attachBuffer(m_shm->createBuffer(image));
+    surface->damage(image.rect());
+    surface->commit(Surface::CommitFlag::None);
+    QSignalSpy committedSpy(serverSurface, &KWaylandServer::SurfaceInterface::committed);
+    QVERIFY(committedSpy.wait());
+
+    m_seatInterface->setFocusedPointerSurface(serverSurface);
+    QSignalSpy frameSpy(pointer.data(), &Pointer::frame);
+    QVERIFY(frameSpy.isValid());
+    QVERIFY(frameSpy.wait());
+
+    m_seatInterface->setPointerEventCoalescingRate(0);
+    m_seatInterface->setPointerEventCoalescing(true);
+
+    // the events of all pointer interfaces in the order the client sees them
+    QStringList events;
+    connect(pointer.data(), &Pointer::motion, this, [&events](const QPointF &position) {
+        events << QStringLiteral("motion %1,%2").arg(position.x()).arg(position.y());
+    });
+    connect(pointer.data(), &Pointer::frame, this, [&events] {
+        events << QStringLiteral("frame");
+    });
+    connect(relativePointer.data(), &RelativePointer::relativeMotion, this, [&events](const QSizeF &delta) {
+        events << QStringLiteral("relative %1,%2").arg(delta.width()).arg(delta.height());
+    });
+    connect(gesture.data(), &PointerSwipeGesture::started, this, [&events] {
+        events << QStringLiteral("swipe started");
+    });
+    connect(gesture.data(), &PointerSwipeGesture::ended, this, [&events] {
+        events << QStringLiteral("swipe ended");
+    });
+    QSignalSpy endedSpy(gesture.data(), &PointerSwipeGesture::ended);
+    QVERIFY(endedSpy.isValid());
+
+    quint32 timestamp = 1;
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerMotion(QPointF(10, 10));
+    m_seatInterface->notifyPointerFrame();
+
+    // relative motion is coalesced as well, the deltas add up
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerMotion(QPointF(20, 20));
+    m_seatInterface->relativePointerMotion(QSizeF(10, 10), QSizeF(10, 10), timestamp);
+    m_seatInterface->notifyPointerFrame();
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->notifyPointerMotion(QPointF(30, 30));
+    m_seatInterface->relativePointerMotion(QSizeF(5, 5), QSizeF(5, 5), timestamp);
+    m_seatInterface->notifyPointerFrame();
+
+    // a gesture flushes the pending motion and its frame first
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->startPointerSwipeGesture(3);
+    m_seatInterface->setTimestamp(timestamp++);
+    m_seatInterface->endPointerSwipeGesture();
+    QVERIFY(endedSpy.wait());
+
+    QCOMPARE(events,
+             QStringList({QStringLiteral("motion 30,30"),
+                          QStringLiteral("relative 15,15"),
+                          QStringLiteral("frame"),
+                          QStringLiteral("swipe started"),
+                          QStringLiteral("swipe ended")}));
+    m_seatInterface->setPointerEventCoalescing(false);
+}
+
 void TestWaylandSeat::testCursor()
 {
     using namespace KWayland::Client;
@@ -2094,7 +2296,8 @@ void TestWaylandSeat::testKeymap()
     QVERIFY(keymapChangedSpy.wait());
     int fd = keymapChangedSpy.first().first().toInt();
     QVERIFY(fd != -1);
-    QCOMPARE(keymapChangedSpy.first().last().value<quint32>(), 3u);
+    // the keymap is sent including the terminating null byte
+    QCOMPARE(keymapChangedSpy.first().last().value<quint32>(), 4u);
     QFile file;
     QVERIFY(file.open(fd, QIODevice::ReadOnly));
     const char *address = reinterpret_cast<char *>(file.map(0, keymapChangedSpy.first().last().value<quint32>()));
@@ -2108,8 +2311,12 @@ void TestWaylandSeat::testKeymap()
     QVERIFY(keymapChangedSpy.wait());
     fd = keymapChangedSpy.first().first().toInt();
     QVERIFY(fd != -1);
-    QCOMPARE(keymapChangedSpy.first().last().value<quint32>(), 3u);
+    QCOMPARE(keymapChangedSpy.first().last().value<quint32>(), 4u);
     QVERIFY(file.open(fd, QIODevice::ReadWrite));
+    // the keymap file is shared by all clients, so it must not be writable
+    QVERIFY(!file.map(0, keymapChangedSpy.first().last().value<quint32>()));
+    file.close();
+    QVERIFY(file.open(fd, QIODevice::ReadOnly));
     address = reinterpret_cast<char *>(file.map(0, keymapChangedSpy.first().last().value<quint32>()));
     QVERIFY(address);
     QCOMPARE(qstrcmp(address, "bar"), 0);
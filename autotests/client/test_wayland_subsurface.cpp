@@ -985,6 +985,27 @@ void TestSubSurface::testSurfaceAt()
     // outside the geometries should be no surface
     QVERIFY(!parentServerSurface->surfaceAt(QPointF(-1, -1)));
     QVERIFY(!parentServerSurface->surfaceAt(QPointF(101, 101)));
+
+    // the tree got flattened once for all of the queries above
+    QCOMPARE(parentServerSurface->hitTestStatistics().queries, quint64(18));
+    QCOMPARE(parentServerSurface->hitTestStatistics().rebuilds, quint64(1));
+    QCOMPARE(parentServerSurface->hitTestStatistics().rejected, quint64(2));
+
+    // a commit that doesn't change the geometry of the tree keeps the cache
+    QSignalSpy childFor1CommittedSpy(childFor1ServerSurface, &SurfaceInterface::committed);
+    childFor1->commit(Surface::CommitFlag::None);
+    QVERIFY(childFor1CommittedSpy.wait());
+    QCOMPARE(parentServerSurface->surfaceAt(QPointF(0, 0)), childFor1ServerSurface);
+    QCOMPARE(parentServerSurface->hitTestStatistics().rebuilds, quint64(1));
+
+    // but moving a sub-surface invalidates it
+    QSignalSpy parentCommittedSpy(parentServerSurface, &SurfaceInterface::committed);
+    directChild2SubSurface->setPosition(QPoint(60, 60));
+    parent->commit(Surface::CommitFlag::None);
+    QVERIFY(parentCommittedSpy.wait());
+    QCOMPARE(parentServerSurface->surfaceAt(QPointF(55, 55)), parentServerSurface);
+    QCOMPARE(parentServerSurface->surfaceAt(QPointF(105, 105)), childFor2ServerSurface);
+    QCOMPARE(parentServerSurface->hitTestStatistics().rebuilds, quint64(2));
 }
 
 void TestSubSurface::testDestroyAttachedBuffer()
@@ -14,6 +14,7 @@
 #include "../../src/server/idleinhibit_v1_interface.h"
 #include "../../src/server/shmclientbuffer.h"
 #include "../../src/server/surface_interface.h"
+#include "../../src/server/viewporter_interface.h"
 #include "../../src/client/compositor.h"
 #include "../../src/client/connection_thread.h"
 #include "../../src/client/event_queue.h"
@@ -26,8 +27,12 @@
 // Wayland
 #include <wayland-client-protocol.h>
 
+#include "qwayland-viewporter.h"
+
 using KWayland::Client::Registry;
 
+Q_DECLARE_METATYPE(KWaylandServer::SurfaceInterface::DamagePolicy)
+
 class TestWaylandSurface : public QObject
 {
     Q_OBJECT
@@ -39,6 +44,9 @@ private Q_SLOTS:
 
     void testStaticAccessor();
     void testDamage();
+    void testBufferTransformMapping();
+    void testDamagePolicy_data();
+    void testDamagePolicy();
     void testFrameCallback();
     void testAttachBuffer();
     void testMultipleSurfaces();
@@ -62,6 +70,7 @@ private:
     KWayland::Client::ShmPool *m_shm;
     KWayland::Client::EventQueue *m_queue;
     KWayland::Client::IdleInhibitManager *m_idleInhibitManager;
+    QtWayland::wp_viewporter *m_viewporter = nullptr;
     QThread *m_thread;
 };
 
@@ -93,6 +102,8 @@ void TestWaylandSurface::init()
     m_idleInhibitInterface = new IdleInhibitManagerV1Interface(m_display, m_display);
     QVERIFY(m_idleInhibitInterface);
 
+    new ViewporterInterface(m_display, m_display);
+
     // setup connection
     m_connection = new KWayland::Client::ConnectionThread;
     QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
@@ -125,6 +136,11 @@ void TestWaylandSurface::init()
     QSignalSpy allAnnounced(&registry, &KWayland::Client::Registry::interfacesAnnounced);
     QVERIFY(allAnnounced.isValid());
     QVERIFY(shmSpy.isValid());
+    connect(&registry, &KWayland::Client::Registry::interfaceAnnounced, this, [this, &registry](const QByteArray &interface, quint32 id, quint32 version) {
+        if (interface == QByteArrayLiteral("wp_viewporter")) {
+            m_viewporter = new QtWayland::wp_viewporter(registry, id, version);
+        }
+    });
     registry.create(m_connection->display());
     QVERIFY(registry.isValid());
     registry.setup();
@@ -141,10 +157,13 @@ void TestWaylandSurface::init()
                                                              registry.interface(Registry::Interface::IdleInhibitManagerUnstableV1).version,
                                                              this);
     QVERIFY(m_idleInhibitManager->isValid());
+    QVERIFY(m_viewporter);
 }
 
 void TestWaylandSurface::cleanup()
 {
+    delete m_viewporter;
+    m_viewporter = nullptr;
     if (m_compositor) {
         delete m_compositor;
         m_compositor = nullptr;
@@ -333,6 +352,97 @@ void TestWaylandSurface::testDamage()
     QVERIFY(serverSurface->isMapped());
 }
 
+void TestWaylandSurface::testBufferTransformMapping()
+{
+    QSignalSpy serverSurfaceCreated(m_compositorInterface, &KWaylandServer::CompositorInterface::surfaceCreated);
+    QVERIFY(serverSurfaceCreated.isValid());
+    QScopedPointer<KWayland::Client::Surface> s(m_compositor->createSurface());
+    QVERIFY(serverSurfaceCreated.wait());
+    KWaylandServer::SurfaceInterface *serverSurface = serverSurfaceCreated.first().first().value<KWaylandServer::SurfaceInterface *>();
+    QVERIFY(serverSurface);
+    QCOMPARE(serverSurface->damagePolicy(), KWaylandServer::SurfaceInterface::DamagePolicy::BoundingRect);
+
+    QSignalSpy committedSpy(serverSurface, &KWaylandServer::SurfaceInterface::committed);
+    QVERIFY(committedSpy.isValid());
+
+    QImage img(QSize(80, 40), QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::black);
+    s->attachBuffer(m_shm->createBuffer(img));
+    s->setScale(2);
+    wl_surface_set_buffer_transform(*s, WL_OUTPUT_TRANSFORM_90);
+    s->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(committedSpy.wait());
+    QCOMPARE(serverSurface->size(), QSize(20, 40));
+
+    // the rectangle mapping has to agree with the surface to buffer matrix
+    QCOMPARE(serverSurface->mapToBuffer(QPointF(16.5, 5.5)), QPointF(11, 7));
+    QCOMPARE(serverSurface->mapFromBuffer(QRegion(10, 6, 20, 10)), QRegion(12, 5, 5, 10));
+    QCOMPARE(serverSurface->mapToBuffer(QRegion(12, 5, 5, 10)), QRegion(10, 6, 20, 10));
+    // partially covered surface pixels are kept
+    QCOMPARE(serverSurface->mapFromBuffer(QRegion(11, 7, 1, 1)), QRegion(16, 5, 1, 1));
+}
+
+void TestWaylandSurface::testDamagePolicy_data()
+{
+    QTest::addColumn<KWaylandServer::SurfaceInterface::DamagePolicy>("policy");
+    QTest::addColumn<QVector<QRect>>("rects");
+    QTest::addColumn<QRegion>("expectedDamage");
+
+    // Attaching the buffer damages the rect of its size, that is the first rect.
+    const QRect attachDamage(0, 0, 16, 16);
+    QVector<QRect> diagonal;
+    QRegion diagonalDamage = attachDamage;
+    for (int i = 0; i < 15; ++i) {
+        diagonal << QRect(32 + i * 8, 32 + i * 8, 4, 4);
+        diagonalDamage += diagonal.last();
+    }
+    QTest::newRow("bounding rect, at limit") << KWaylandServer::SurfaceInterface::DamagePolicy::BoundingRect << diagonal << diagonalDamage;
+    diagonal << QRect(152, 152, 4, 4);
+    QTest::newRow("bounding rect, above limit") << KWaylandServer::SurfaceInterface::DamagePolicy::BoundingRect << diagonal << QRegion(0, 0, 156, 156);
+
+    // A pixel in each of the next 16 tiles of the first row.
+    QVector<QRect> pixels;
+    for (int i = 1; i <= 16; ++i) {
+        pixels << QRect(i * 64 + 1, 1, 1, 1);
+    }
+    QTest::newRow("bounding rect, spread out") << KWaylandServer::SurfaceInterface::DamagePolicy::BoundingRect << pixels << QRegion(0, 0, 1026, 16);
+    QTest::newRow("tiled") << KWaylandServer::SurfaceInterface::DamagePolicy::Tiled << pixels << QRegion(0, 0, 17 * 64, 64);
+}
+
+void TestWaylandSurface::testDamagePolicy()
+{
+    QFETCH(KWaylandServer::SurfaceInterface::DamagePolicy, policy);
+    QFETCH(QVector<QRect>, rects);
+
+    QSignalSpy serverSurfaceCreated(m_compositorInterface, &KWaylandServer::CompositorInterface::surfaceCreated);
+    QVERIFY(serverSurfaceCreated.isValid());
+    QScopedPointer<KWayland::Client::Surface> s(m_compositor->createSurface());
+    QVERIFY(serverSurfaceCreated.wait());
+    KWaylandServer::SurfaceInterface *serverSurface = serverSurfaceCreated.first().first().value<KWaylandServer::SurfaceInterface *>();
+    QVERIFY(serverSurface);
+    serverSurface->setDamagePolicy(policy);
+    QCOMPARE(serverSurface->damagePolicy(), policy);
+
+    QSignalSpy damageSpy(serverSurface, &KWaylandServer::SurfaceInterface::damaged);
+    QVERIFY(damageSpy.isValid());
+
+    // The surface is scaled up, so the damage posted by the client is not covered by
+    // the damage of the buffer size.
+    QtWayland::wp_viewport viewport(m_viewporter->get_viewport(*s));
+    viewport.set_destination(17 * 64, 256);
+    QImage img(QSize(16, 16), QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::black);
+    s->attachBuffer(m_shm->createBuffer(img));
+    for (const QRect &rect : qAsConst(rects)) {
+        s->damage(rect);
+    }
+    s->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(damageSpy.wait());
+    QCOMPARE(serverSurface->size(), QSize(17 * 64, 256));
+    QTEST(serverSurface->damage(), "expectedDamage");
+    viewport.destroy();
+}
+
 void TestWaylandSurface::testFrameCallback()
 {
     QSignalSpy serverSurfaceCreated(m_compositorInterface, &KWaylandServer::CompositorInterface::surfaceCreated);
@@ -4,6 +4,7 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 // Qt
+#include <QScopeGuard>
 #include <QtTest>
 // KWin
 #include "../../src/server/compositor_interface.h"
@@ -14,10 +15,12 @@
 #include "../../src/client/connection_thread.h"
 #include "../../src/client/event_queue.h"
 #include "../../src/client/plasmawindowmanagement.h"
+#include "../../src/client/plasmawindowmodel.h"
 #include "../../src/client/region.h"
 #include "../../src/client/registry.h"
 #include "../../src/client/surface.h"
 #include <wayland-plasma-window-management-client-protocol.h>
+#include <wayland-server.h>
 
 typedef void (KWaylandServer::PlasmaWindowInterface::*ServerWindowSignal)();
 Q_DECLARE_METATYPE(ServerWindowSignal)
@@ -55,6 +58,10 @@ private Q_SLOTS:
     void testIcon();
     void testPid();
     void testApplicationMenu();
+    void testStackingOrderDeltas();
+    void testIconCache();
+    void testGroupedUpdate();
+    void testModelCoalescing();
 
     void cleanup();
 
@@ -622,5 +629,250 @@ void TestWindowManagement::testApplicationMenu()
     QCOMPARE(m_window->applicationMenuObjectPath(), objectPath);
 }
 
+void TestWindowManagement::testStackingOrderDeltas()
+{
+    using namespace KWayland::Client;
+    QVERIFY(m_registry->hasInterface(Registry::Interface::PlasmaWindowManagementExtension));
+
+    QSignalSpy stackingOrderSpy(m_windowManagement, &PlasmaWindowManagement::stackingOrderUuidsChanged);
+    QVERIFY(stackingOrderSpy.isValid());
+
+    const QString a = QStringLiteral("a");
+    const QString b = QStringLiteral("b");
+    const QString c = QStringLiteral("c");
+    const QString d = QStringLiteral("d");
+    const QString e = QStringLiteral("e");
+
+    m_windowManagementInterface->setStackingOrderUuids({a, b, c, d});
+    QVERIFY(stackingOrderSpy.wait());
+    QCOMPARE(m_windowManagement->stackingOrderUuids(), QVector<QByteArray>({"a", "b", "c", "d"}));
+
+    // raise a window
+    m_windowManagementInterface->setStackingOrderUuids({a, c, d, b});
+    QVERIFY(stackingOrderSpy.wait());
+    QCOMPARE(stackingOrderSpy.count(), 2);
+    QCOMPARE(m_windowManagement->stackingOrderUuids(), QVector<QByteArray>({"a", "c", "d", "b"}));
+
+    // lower a window
+    m_windowManagementInterface->setStackingOrderUuids({d, a, c, b});
+    QVERIFY(stackingOrderSpy.wait());
+    QCOMPARE(stackingOrderSpy.count(), 3);
+    QCOMPARE(m_windowManagement->stackingOrderUuids(), QVector<QByteArray>({"d", "a", "c", "b"}));
+
+    // add and remove windows in one go
+    m_windowManagementInterface->setStackingOrderUuids({e, d, a, b});
+    QVERIFY(stackingOrderSpy.wait());
+    QCOMPARE(stackingOrderSpy.count(), 4);
+    QCOMPARE(m_windowManagement->stackingOrderUuids(), QVector<QByteArray>({"e", "d", "a", "b"}));
+
+    // reverse the order
+    m_windowManagementInterface->setStackingOrderUuids({b, a, d, e});
+    QVERIFY(stackingOrderSpy.wait());
+    QCOMPARE(stackingOrderSpy.count(), 5);
+    QCOMPARE(m_windowManagement->stackingOrderUuids(), QVector<QByteArray>({"b", "a", "d", "e"}));
+
+    // clearing is sent as a reset
+    m_windowManagementInterface->setStackingOrderUuids({});
+    QVERIFY(stackingOrderSpy.wait());
+    QCOMPARE(stackingOrderSpy.count(), 6);
+    QVERIFY(m_windowManagement->stackingOrderUuids().isEmpty());
+}
+
+struct IconRequests {
+    int getIcon = 0;
+    int fileDescriptors = 0;
+};
+
+static void countIconRequests(void *userData, wl_protocol_logger_type direction, const wl_protocol_logger_message *message)
+{
+    if (direction != WL_PROTOCOL_LOGGER_REQUEST) {
+        return;
+    }
+    auto requests = static_cast<IconRequests *>(userData);
+    if (qstrcmp(message->message->name, "get_icon") == 0) {
+        requests->getIcon++;
+    }
+    if (strchr(message->message->signature, 'h')) {
+        requests->fileDescriptors++;
+    }
+}
+
+void TestWindowManagement::testIconCache()
+{
+    using namespace KWayland::Client;
+    QVERIFY(m_registry->hasInterface(Registry::Interface::PlasmaWindowManagementExtension));
+
+    QSignalSpy iconChangedSpy(m_window, &PlasmaWindow::iconChanged);
+    QVERIFY(iconChangedSpy.isValid());
+    QSignalSpy titleChangedSpy(m_window, &PlasmaWindow::titleChanged);
+    QVERIFY(titleChangedSpy.isValid());
+
+    IconRequests requests;
+    wl_protocol_logger *logger = wl_display_add_protocol_logger(*m_display, countIconRequests, &requests);
+    auto removeLogger = qScopeGuard([logger] {
+        wl_protocol_logger_destroy(logger);
+    });
+
+    QImage image(32, 32, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::green);
+    const QIcon icon(QPixmap::fromImage(image));
+    m_windowInterface->setIcon(icon);
+    QVERIFY(iconChangedSpy.wait());
+    QCOMPARE(iconChangedSpy.count(), 1);
+    QCOMPARE(m_window->icon().pixmap(32, 32), icon.pixmap(32, 32));
+    QCOMPARE(requests.getIcon, 1);
+    QCOMPARE(requests.fileDescriptors, 1);
+
+    // a different QIcon with the same content is not announced again
+    m_windowInterface->setIcon(QIcon(QPixmap::fromImage(image.copy())));
+    m_windowInterface->setTitle(QStringLiteral("sync"));
+    QVERIFY(titleChangedSpy.wait());
+    QCOMPARE(iconChangedSpy.count(), 1);
+
+    // a new window with the same icon gets it from the cache
+    QSignalSpy windowSpy(m_windowManagement, &PlasmaWindowManagement::windowCreated);
+    QVERIFY(windowSpy.isValid());
+    QScopedPointer<KWaylandServer::PlasmaWindowInterface> newWindowInterface(m_windowManagementInterface->createWindow(this, QUuid::createUuid()));
+    newWindowInterface->setIcon(icon);
+    QVERIFY(windowSpy.wait());
+    auto newWindow = windowSpy.first().first().value<PlasmaWindow *>();
+    QVERIFY(newWindow);
+    QSignalSpy newIconChangedSpy(newWindow, &PlasmaWindow::iconChanged);
+    QVERIFY(newIconChangedSpy.isValid());
+    if (newWindow->icon().isNull()) {
+        QVERIFY(newIconChangedSpy.wait());
+    }
+    QCOMPARE(newWindow->icon().pixmap(32, 32), icon.pixmap(32, 32));
+    // the icon was not transferred again
+    m_connection->flush();
+    m_display->dispatchEvents();
+    QCOMPARE(requests.getIcon, 1);
+    QCOMPARE(requests.fileDescriptors, 1);
+
+    // changing the content is announced
+    image.fill(Qt::blue);
+    const QIcon blueIcon(QPixmap::fromImage(image));
+    m_windowInterface->setIcon(blueIcon);
+    QVERIFY(iconChangedSpy.wait());
+    QCOMPARE(iconChangedSpy.count(), 2);
+    QCOMPARE(m_window->icon().pixmap(32, 32), blueIcon.pixmap(32, 32));
+    QCOMPARE(requests.getIcon, 2);
+    QCOMPARE(requests.fileDescriptors, 2);
+
+    // no icon is announced with an empty hash, there is nothing to fetch
+    m_windowInterface->setIcon(QIcon());
+    QVERIFY(iconChangedSpy.wait());
+    QCOMPARE(iconChangedSpy.count(), 3);
+    QCOMPARE(m_window->icon().name(), QIcon::fromTheme(QStringLiteral("wayland")).name());
+    m_connection->flush();
+    m_display->dispatchEvents();
+    QCOMPARE(requests.getIcon, 2);
+    QCOMPARE(requests.fileDescriptors, 2);
+}
+
+void TestWindowManagement::testGroupedUpdate()
+{
+    using namespace KWayland::Client;
+    QScopedPointer<PlasmaWindowModel> model(m_windowManagement->createWindowModel());
+    QVERIFY(model);
+    QCOMPARE(model->rowCount(), 1);
+
+    QSignalSpy changedSpy(m_window, &PlasmaWindow::changed);
+    QVERIFY(changedSpy.isValid());
+    QSignalSpy titleChangedSpy(m_window, &PlasmaWindow::titleChanged);
+    QVERIFY(titleChangedSpy.isValid());
+    QSignalSpy minimizedChangedSpy(m_window, &PlasmaWindow::minimizedChanged);
+    QVERIFY(minimizedChangedSpy.isValid());
+    QSignalSpy dataChangedSpy(model.data(), &PlasmaWindowModel::dataChanged);
+    QVERIFY(dataChangedSpy.isValid());
+
+    m_windowInterface->beginUpdate();
+    m_windowInterface->setTitle(QStringLiteral("grouped"));
+    m_windowInterface->setMaximized(true);
+    m_windowInterface->setActive(true);
+    m_windowInterface->setGeometry(QRect(10, 20, 300, 400));
+    // set back and forth, nothing to send
+    m_windowInterface->setMinimized(true);
+    m_windowInterface->setMinimized(false);
+    m_windowInterface->commitUpdate();
+
+    QVERIFY(changedSpy.wait());
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(titleChangedSpy.count(), 1);
+    QCOMPARE(minimizedChangedSpy.count(), 0);
+    QCOMPARE(m_window->title(), QStringLiteral("grouped"));
+    QVERIFY(m_window->isMaximized());
+    QVERIFY(m_window->isActive());
+    QCOMPARE(m_window->geometry(), QRect(10, 20, 300, 400));
+
+    QTRY_COMPARE(dataChangedSpy.count(), 1);
+    const QVector<int> roles = dataChangedSpy.first().at(2).value<QVector<int>>();
+    QCOMPARE(roles.count(), 4);
+    QVERIFY(roles.contains(Qt::DisplayRole));
+    QVERIFY(roles.contains(PlasmaWindowModel::IsMaximized));
+    QVERIFY(roles.contains(PlasmaWindowModel::IsActive));
+    QVERIFY(roles.contains(PlasmaWindowModel::Geometry));
+
+    // nested updates are sent by the outermost commit
+    m_windowInterface->beginUpdate();
+    m_windowInterface->beginUpdate();
+    m_windowInterface->setTitle(QStringLiteral("nested"));
+    m_windowInterface->commitUpdate();
+    m_windowInterface->setKeepAbove(true);
+    m_windowInterface->commitUpdate();
+    QVERIFY(changedSpy.wait());
+    QCOMPARE(changedSpy.count(), 2);
+    QTRY_COMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(dataChangedSpy.last().at(2).value<QVector<int>>().count(), 2);
+
+    // a single change outside of an update is a group on its own
+    m_windowInterface->setTitle(QStringLiteral("single"));
+    QVERIFY(changedSpy.wait());
+    QCOMPARE(changedSpy.count(), 3);
+    QTRY_COMPARE(dataChangedSpy.count(), 3);
+    QCOMPARE(dataChangedSpy.last().at(2).value<QVector<int>>(), QVector<int>{Qt::DisplayRole});
+}
+
+void TestWindowManagement::testModelCoalescing()
+{
+    using namespace KWayland::Client;
+    QSignalSpy windowSpy(m_windowManagement, &PlasmaWindowManagement::windowCreated);
+    QVERIFY(windowSpy.isValid());
+    QScopedPointer<KWaylandServer::PlasmaWindowInterface> secondWindowInterface(m_windowManagementInterface->createWindow(this, QUuid::createUuid()));
+    QScopedPointer<KWaylandServer::PlasmaWindowInterface> thirdWindowInterface(m_windowManagementInterface->createWindow(this, QUuid::createUuid()));
+    QTRY_COMPARE(windowSpy.count(), 2);
+    auto thirdWindow = windowSpy.last().first().value<PlasmaWindow *>();
+
+    QScopedPointer<PlasmaWindowModel> model(m_windowManagement->createWindowModel());
+    QCOMPARE(model->rowCount(), 3);
+    QSignalSpy dataChangedSpy(model.data(), &PlasmaWindowModel::dataChanged);
+    QVERIFY(dataChangedSpy.isValid());
+
+    // changes of adjacent rows in one go end up in one range
+    QSignalSpy geometrySpy(thirdWindow, &PlasmaWindow::geometryChanged);
+    QVERIFY(geometrySpy.isValid());
+    m_windowInterface->setGeometry(QRect(0, 0, 10, 10));
+    secondWindowInterface->setTitle(QStringLiteral("second"));
+    thirdWindowInterface->setGeometry(QRect(0, 0, 30, 30));
+    QVERIFY(geometrySpy.wait());
+    QTRY_COMPARE(dataChangedSpy.count(), 1);
+    QCOMPARE(dataChangedSpy.first().at(0).toModelIndex(), model->index(0));
+    QCOMPARE(dataChangedSpy.first().at(1).toModelIndex(), model->index(2));
+    QCOMPARE(dataChangedSpy.first().at(2).value<QVector<int>>().count(), 2);
+
+    // the rows after a removed window move up
+    QSignalSpy rowsRemovedSpy(model.data(), &PlasmaWindowModel::rowsRemoved);
+    QVERIFY(rowsRemovedSpy.isValid());
+    secondWindowInterface->unmap();
+    QVERIFY(rowsRemovedSpy.wait());
+    QCOMPARE(model->rowCount(), 2);
+    thirdWindowInterface->setGeometry(QRect(0, 0, 40, 40));
+    QVERIFY(geometrySpy.wait());
+    QTRY_COMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(dataChangedSpy.last().at(0).toModelIndex(), model->index(1));
+    QCOMPARE(dataChangedSpy.last().at(1).toModelIndex(), model->index(1));
+    QCOMPARE(model->data(model->index(1), PlasmaWindowModel::Geometry).toRect(), QRect(0, 0, 40, 40));
+}
+
 QTEST_MAIN(TestWindowManagement)
 #include "test_wayland_windowmanagement.moc"
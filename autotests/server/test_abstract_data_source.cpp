@@ -0,0 +1,179 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+// Qt
+#include <QFutureWatcher>
+#include <QThread>
+#include <QTimer>
+#include <QtTest>
+
+// WaylandServer
+#include "../../src/server/abstract_data_source.h"
+
+// system
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace KWaylandServer;
+
+class TestDataSource : public AbstractDataSource
+{
+    Q_OBJECT
+public:
+    TestDataSource(const QByteArray &data, int memfd)
+        : AbstractDataSource(nullptr)
+        , m_data(data)
+        , m_memfd(memfd)
+    {
+    }
+    ~TestDataSource()
+    {
+        Q_EMIT aboutToBeDestroyed();
+    }
+    void requestData(const QString &mimeType, qint32 fd) override
+    {
+        if (mimeType == QLatin1String("image/png")) {
+            m_transfer = writeFile(m_memfd, fd);
+        } else {
+            m_transfer = writeData(m_data, fd);
+        }
+    }
+    void cancel() override{};
+    QStringList mimeTypes() const override
+    {
+        return {"text/plain", "image/png"};
+    }
+
+    QFuture<bool> transfer() const
+    {
+        return m_transfer;
+    }
+
+private:
+    QByteArray m_data;
+    int m_memfd;
+    QFuture<bool> m_transfer;
+};
+
+class AbstractDataSourceTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testTransfer_data();
+    void testTransfer();
+    void testReceiverGone();
+
+private:
+    QByteArray m_payload;
+    int m_memfd = -1;
+};
+
+void AbstractDataSourceTest::initTestCase()
+{
+    m_payload.resize(100 * 1024 * 1024);
+    for (int i = 0; i < m_payload.size(); ++i) {
+        m_payload[i] = char(i * 31 + 7);
+    }
+
+    m_memfd = memfd_create("test-data-source", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    QVERIFY(m_memfd != -1);
+    QCOMPARE(pwrite(m_memfd, m_payload.constData(), m_payload.size(), 0), ssize_t(m_payload.size()));
+    QCOMPARE(fcntl(m_memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL), 0);
+}
+
+void AbstractDataSourceTest::cleanupTestCase()
+{
+    close(m_memfd);
+}
+
+void AbstractDataSourceTest::testTransfer_data()
+{
+    QTest::addColumn<QString>("mimeType");
+
+    QTest::newRow("buffer") << QStringLiteral("text/plain");
+    QTest::newRow("sealed file") << QStringLiteral("image/png");
+}
+
+void AbstractDataSourceTest::testTransfer()
+{
+    QFETCH(QString, mimeType);
+    TestDataSource source(m_payload, m_memfd);
+
+    int pipeFds[2];
+    QVERIFY(pipe2(pipeFds, O_CLOEXEC) == 0);
+
+    // a receiver which is slower than the sender, so the transfer has to wait for it
+    qint64 received = 0;
+    bool matches = true;
+    QScopedPointer<QThread> reader(QThread::create([this, &received, &matches, fd = pipeFds[0]] {
+        QByteArray buffer(64 * 1024, Qt::Uninitialized);
+        ssize_t n;
+        while ((n = read(fd, buffer.data(), buffer.size())) > 0) {
+            if (received + n > m_payload.size() || memcmp(buffer.constData(), m_payload.constData() + received, n) != 0) {
+                matches = false;
+            }
+            received += n;
+            if (received % (10 * 1024 * 1024) < n) {
+                QThread::msleep(20);
+            }
+        }
+        close(fd);
+    }));
+    QSignalSpy readerFinishedSpy(reader.data(), &QThread::finished);
+    QVERIFY(readerFinishedSpy.isValid());
+
+    // the event loop keeps running while the data is transferred
+    int ticksDuringTransfer = 0;
+    QTimer ticker;
+    ticker.setInterval(5);
+    connect(&ticker, &QTimer::timeout, this, [&source, &ticksDuringTransfer] {
+        if (!source.transfer().isFinished()) {
+            ticksDuringTransfer++;
+        }
+    });
+
+    reader->start();
+    ticker.start();
+    source.requestData(mimeType, pipeFds[1]);
+    // the pipe only holds a fraction of the payload, so the reader is still busy with it
+    QVERIFY(!source.transfer().isFinished());
+    QVERIFY(readerFinishedSpy.wait(30000));
+    ticker.stop();
+
+    QFutureWatcher<bool> watcher;
+    QSignalSpy transferFinishedSpy(&watcher, &QFutureWatcher<bool>::finished);
+    watcher.setFuture(source.transfer());
+    if (!watcher.isFinished()) {
+        QVERIFY(transferFinishedSpy.wait());
+    }
+    QVERIFY(watcher.result());
+    QCOMPARE(received, qint64(m_payload.size()));
+    QVERIFY(matches);
+    QVERIFY(ticksDuringTransfer > 0);
+}
+
+void AbstractDataSourceTest::testReceiverGone()
+{
+    // the compositor must survive the receiver closing its end, without SIGPIPE
+    TestDataSource source(m_payload, m_memfd);
+    const QStringList mimeTypes = source.mimeTypes();
+    for (const QString &mimeType : mimeTypes) {
+        int pipeFds[2];
+        QVERIFY(pipe2(pipeFds, O_CLOEXEC) == 0);
+        close(pipeFds[0]);
+        source.requestData(mimeType, pipeFds[1]);
+        QFuture<bool> transfer = source.transfer();
+        transfer.waitForFinished();
+        QVERIFY(!transfer.result());
+    }
+}
+
+QTEST_GUILESS_MAIN(AbstractDataSourceTest)
+#include "test_abstract_data_source.moc"
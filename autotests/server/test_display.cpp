@@ -11,6 +11,7 @@
 #include "../../src/server/output_interface.h"
 #include "../../src/server/outputmanagement_v2_interface.h"
 // Wayland
+#include <wayland-client.h>
 #include <wayland-server.h>
 // system
 #include <sys/socket.h>
@@ -27,6 +28,7 @@ private Q_SLOTS:
     void testStartStop();
     void testAddRemoveOutput();
     void testClientConnection();
+    void testClientStatistics();
     void testConnectNoSocket();
     void testOutputManagement();
     void testAutoSocketName();
@@ -161,6 +163,60 @@ void TestWaylandServerDisplay::testClientConnection()
     QVERIFY(display.connections().isEmpty());
 }
 
+void TestWaylandServerDisplay::testClientStatistics()
+{
+    Display display;
+    display.start();
+    QVERIFY(!display.isClientStatisticsEnabled());
+    display.setClientStatisticsEnabled(true);
+    QVERIFY(display.isClientStatisticsEnabled());
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    ClientConnection *connection = display.createClient(sv[0]);
+    QVERIFY(connection);
+    wl_display *clientDisplay = wl_display_connect_to_fd(sv[1]);
+    QVERIFY(clientDisplay);
+
+    // one request on wl_display, answered with wl_callback.done and wl_display.delete_id
+    wl_callback *callback = wl_display_sync(clientDisplay);
+    QCOMPARE(wl_display_flush(clientDisplay), 12);
+    display.dispatchEvents();
+
+    ClientConnectionStatistics statistics = connection->statistics();
+    QCOMPARE(statistics.requests, quint64(1));
+    QCOMPARE(statistics.requestBytes, quint64(12));
+    QCOMPARE(statistics.interfaces.value("wl_display").requests, quint64(1));
+    QCOMPARE(statistics.interfaces.value("wl_display").events, quint64(1));
+    QCOMPARE(statistics.interfaces.value("wl_callback").events, quint64(1));
+    QCOMPARE(statistics.events, quint64(2));
+    QCOMPARE(statistics.eventBytes, quint64(24));
+    QVERIFY(statistics.handlerTime > 0);
+    QCOMPARE(statistics.handlerTime, statistics.interfaces.value("wl_display").handlerTime);
+
+    // the client doesn't read its events, so they stay unread
+    display.flush();
+    statistics = connection->statistics();
+    QCOMPARE(statistics.backloggedFlushes, quint64(1));
+    QCOMPARE(statistics.unreadBytes, 24u);
+
+    connection->resetStatistics();
+    QCOMPARE(connection->statistics().requests, quint64(0));
+    QVERIFY(connection->statistics().interfaces.isEmpty());
+
+    // nothing is counted while disabled
+    display.setClientStatisticsEnabled(false);
+    wl_callback_destroy(wl_display_sync(clientDisplay));
+    wl_display_flush(clientDisplay);
+    display.dispatchEvents();
+    QCOMPARE(connection->statistics().requests, quint64(0));
+
+    wl_callback_destroy(callback);
+    // both ends of the socket are closed by now
+    wl_display_disconnect(clientDisplay);
+    connection->destroy();
+}
+
 void TestWaylandServerDisplay::testConnectNoSocket()
 {
     Display display;
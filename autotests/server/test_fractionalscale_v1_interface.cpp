@@ -0,0 +1,237 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QThread>
+#include <QtTest>
+
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/display.h"
+#include "../../src/server/fractionalscale_v1_interface.h"
+#include "../../src/server/output_interface.h"
+#include "../../src/server/surface_interface.h"
+#include "../../src/server/viewporter_interface.h"
+
+#include "../../src/client/compositor.h"
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/fractionalscale.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/shm_pool.h"
+#include "../../src/client/surface.h"
+
+#include "qwayland-viewporter.h"
+
+using namespace KWaylandServer;
+
+class Viewporter : public QtWayland::wp_viewporter
+{
+};
+
+class Viewport : public QtWayland::wp_viewport
+{
+};
+
+class TestFractionalScaleV1Interface : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~TestFractionalScaleV1Interface() override;
+
+private Q_SLOTS:
+    void initTestCase();
+    void testPreferredScale();
+    void testViewport();
+
+private:
+    SurfaceInterface *createSurface(QScopedPointer<KWayland::Client::Surface> &surface);
+
+    KWayland::Client::ConnectionThread *m_connection;
+    KWayland::Client::EventQueue *m_queue;
+    KWayland::Client::Compositor *m_clientCompositor;
+    KWayland::Client::ShmPool *m_shm;
+    KWayland::Client::FractionalScaleManager *m_fractionalScaleManager;
+
+    QThread *m_thread;
+    Display m_display;
+    CompositorInterface *m_serverCompositor;
+    OutputInterface *m_firstOutput;
+    OutputInterface *m_secondOutput;
+    Viewporter *m_viewporter = nullptr;
+};
+
+static const QString s_socketName = QStringLiteral("kwin-wayland-server-fractional-scale-test-0");
+
+void TestFractionalScaleV1Interface::initTestCase()
+{
+    m_display.addSocketName(s_socketName);
+    m_display.start();
+    QVERIFY(m_display.isRunning());
+
+    m_display.createShm();
+    new ViewporterInterface(&m_display, this);
+    new FractionalScaleManagerV1Interface(&m_display, this);
+
+    m_serverCompositor = new CompositorInterface(&m_display, this);
+    m_firstOutput = new OutputInterface(&m_display, this);
+    m_secondOutput = new OutputInterface(&m_display, this);
+
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketName(s_socketName);
+
+    m_thread = new QThread(this);
+    m_connection->moveToThread(m_thread);
+    m_thread->start();
+
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    auto registry = new KWayland::Client::Registry(this);
+    connect(registry, &KWayland::Client::Registry::interfaceAnnounced, this, [this, registry](const QByteArray &interface, quint32 id, quint32 version) {
+        if (interface == QByteArrayLiteral("wp_viewporter")) {
+            m_viewporter = new Viewporter();
+            m_viewporter->init(*registry, id, version);
+        }
+    });
+    QSignalSpy interfacesAnnouncedSpy(registry, &KWayland::Client::Registry::interfacesAnnounced);
+    registry->setEventQueue(m_queue);
+    registry->create(m_connection->display());
+    QVERIFY(registry->isValid());
+    registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+    QVERIFY(m_viewporter);
+
+    const auto compositor = registry->interface(KWayland::Client::Registry::Interface::Compositor);
+    m_clientCompositor = registry->createCompositor(compositor.name, compositor.version, this);
+    QVERIFY(m_clientCompositor->isValid());
+
+    const auto shm = registry->interface(KWayland::Client::Registry::Interface::Shm);
+    m_shm = registry->createShmPool(shm.name, shm.version, this);
+    QVERIFY(m_shm->isValid());
+
+    const auto fractionalScale = registry->interface(KWayland::Client::Registry::Interface::FractionalScaleManagerV1);
+    m_fractionalScaleManager = registry->createFractionalScaleManager(fractionalScale.name, fractionalScale.version, this);
+    QVERIFY(m_fractionalScaleManager->isValid());
+}
+
+TestFractionalScaleV1Interface::~TestFractionalScaleV1Interface()
+{
+    delete m_viewporter;
+    m_viewporter = nullptr;
+    delete m_fractionalScaleManager;
+    m_fractionalScaleManager = nullptr;
+    delete m_shm;
+    m_shm = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    m_connection->deleteLater();
+    m_connection = nullptr;
+}
+
+SurfaceInterface *TestFractionalScaleV1Interface::createSurface(QScopedPointer<KWayland::Client::Surface> &surface)
+{
+    QSignalSpy serverSurfaceCreatedSpy(m_serverCompositor, &CompositorInterface::surfaceCreated);
+    surface.reset(m_clientCompositor->createSurface());
+    if (!serverSurfaceCreatedSpy.wait()) {
+        return nullptr;
+    }
+    return serverSurfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+}
+
+void TestFractionalScaleV1Interface::testPreferredScale()
+{
+    m_firstOutput->setFractionalScale(1.25);
+    QCOMPARE(m_firstOutput->scale(), 2);
+    m_secondOutput->setScale(1);
+    QCOMPARE(m_secondOutput->fractionalScale(), 1.0);
+
+    QScopedPointer<KWayland::Client::Surface> clientSurface;
+    SurfaceInterface *serverSurface = createSurface(clientSurface);
+    QVERIFY(serverSurface);
+    QCOMPARE(serverSurface->preferredScale(), 1.0);
+
+    // The scale is announced when the surface enters an output.
+    QScopedPointer<KWayland::Client::FractionalScale> fractionalScale(m_fractionalScaleManager->createFractionalScale(clientSurface.data()));
+    QSignalSpy preferredScaleChangedSpy(fractionalScale.data(), &KWayland::Client::FractionalScale::preferredScaleChanged);
+    serverSurface->setOutputs({m_firstOutput});
+    QCOMPARE(serverSurface->preferredScale(), 1.25);
+    QVERIFY(preferredScaleChangedSpy.wait());
+    QCOMPARE(fractionalScale->preferredScale(), 1.25);
+
+    // The highest scale of all outputs is preferred.
+    m_secondOutput->setFractionalScale(1.5);
+    serverSurface->setOutputs({m_firstOutput, m_secondOutput});
+    QVERIFY(preferredScaleChangedSpy.wait());
+    QCOMPARE(fractionalScale->preferredScale(), 1.5);
+
+    // Changing the scale of an output updates the surfaces on it.
+    m_secondOutput->setFractionalScale(1.75);
+    QVERIFY(preferredScaleChangedSpy.wait());
+    QCOMPARE(fractionalScale->preferredScale(), 1.75);
+
+    // The scale is kept while the surface is not on any output.
+    serverSurface->setOutputs({});
+    QCOMPARE(serverSurface->preferredScale(), 1.75);
+    serverSurface->setOutputs({m_firstOutput});
+    QVERIFY(preferredScaleChangedSpy.wait());
+    QCOMPARE(fractionalScale->preferredScale(), 1.25);
+    QCOMPARE(preferredScaleChangedSpy.count(), 4);
+
+    // A fractional scale created later gets the current scale right away.
+    fractionalScale.reset();
+    fractionalScale.reset(m_fractionalScaleManager->createFractionalScale(clientSurface.data()));
+    QSignalSpy recreatedSpy(fractionalScale.data(), &KWayland::Client::FractionalScale::preferredScaleChanged);
+    QVERIFY(recreatedSpy.wait());
+    QCOMPARE(fractionalScale->preferredScale(), 1.25);
+}
+
+void TestFractionalScaleV1Interface::testViewport()
+{
+    m_firstOutput->setFractionalScale(1.25);
+
+    QScopedPointer<KWayland::Client::Surface> clientSurface;
+    SurfaceInterface *serverSurface = createSurface(clientSurface);
+    QVERIFY(serverSurface);
+    serverSurface->setOutputs({m_firstOutput});
+
+    QScopedPointer<KWayland::Client::FractionalScale> fractionalScale(m_fractionalScaleManager->createFractionalScale(clientSurface.data()));
+    QSignalSpy preferredScaleChangedSpy(fractionalScale.data(), &KWayland::Client::FractionalScale::preferredScaleChanged);
+    QVERIFY(preferredScaleChangedSpy.wait());
+
+    // A 100x50 surface at 1.25 is backed by a 125x63 buffer (62.5 rounded away from zero).
+    QScopedPointer<Viewport> clientViewport(new Viewport);
+    clientViewport->init(m_viewporter->get_viewport(*clientSurface));
+    clientViewport->set_destination(100, 50);
+
+    QSignalSpy serverSurfaceMappedSpy(serverSurface, &SurfaceInterface::mapped);
+    QImage image(QSize(125, 63), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::black);
+    clientSurface->attachBuffer(m_shm->createBuffer(image));
+    clientSurface->damage(image.rect());
+    clientSurface->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(serverSurfaceMappedSpy.wait());
+
+    QCOMPARE(serverSurface->bufferScale(), 1);
+    QCOMPARE(serverSurface->bufferSize(), QSize(125, 63));
+    QCOMPARE(serverSurface->size(), QSize(100, 50));
+    QCOMPARE(serverSurface->mapToBuffer(QPointF(100, 50)), QPointF(125, 63));
+    QCOMPARE(serverSurface->mapToBuffer(QPointF(80, 40)), QPointF(100, 50.4));
+}
+
+QTEST_GUILESS_MAIN(TestFractionalScaleV1Interface)
+
+#include "test_fractionalscale_v1_interface.moc"
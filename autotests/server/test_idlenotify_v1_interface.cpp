@@ -0,0 +1,332 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QThread>
+#include <QtTest>
+
+#include "../../src/server/display.h"
+#include "../../src/server/idle_interface.h"
+#include "../../src/server/idlenotify_v1_interface.h"
+#include "../../src/server/seat_interface.h"
+
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/idle.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/seat.h"
+
+#include "qwayland-ext-idle-notify-v1.h"
+
+using namespace KWaylandServer;
+
+class IdleNotifier : public QtWayland::ext_idle_notifier_v1
+{
+};
+
+class IdleNotification : public QObject, public QtWayland::ext_idle_notification_v1
+{
+    Q_OBJECT
+public:
+    IdleNotification(::ext_idle_notification_v1 *notification)
+        : QtWayland::ext_idle_notification_v1(notification)
+    {
+    }
+    ~IdleNotification() override
+    {
+        destroy();
+    }
+
+Q_SIGNALS:
+    void idled();
+    void resumed();
+
+protected:
+    void ext_idle_notification_v1_idled() override
+    {
+        Q_EMIT idled();
+    }
+    void ext_idle_notification_v1_resumed() override
+    {
+        Q_EMIT resumed();
+    }
+};
+
+class TestIdleNotifyV1Interface : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~TestIdleNotifyV1Interface() override;
+
+private Q_SLOTS:
+    void initTestCase();
+    void testIdle();
+    void testOtherSeat();
+    void testInhibit();
+    void testOrder();
+    void testActivityBeforeDeadline();
+    void testMinimumTimeout();
+    void testTimeoutActivityBeforeDeadline();
+
+private:
+    IdleNotification *createNotification(quint32 timeout);
+
+    KWayland::Client::ConnectionThread *m_connection;
+    KWayland::Client::EventQueue *m_queue;
+    KWayland::Client::Seat *m_clientSeat = nullptr;
+    IdleNotifier *m_idleNotifier = nullptr;
+    KWayland::Client::Idle *m_clientIdle = nullptr;
+
+    QThread *m_thread;
+    Display m_display;
+    SeatInterface *m_seat;
+    IdleNotifyV1Interface *m_idleNotify;
+    IdleInterface *m_idle;
+};
+
+static const QString s_socketName = QStringLiteral("kwin-wayland-server-idle-notify-test-0");
+
+void TestIdleNotifyV1Interface::initTestCase()
+{
+    m_display.addSocketName(s_socketName);
+    m_display.start();
+    QVERIFY(m_display.isRunning());
+
+    m_seat = new SeatInterface(&m_display, this);
+    m_idleNotify = new IdleNotifyV1Interface(&m_display, this);
+    m_idle = new IdleInterface(&m_display, this);
+
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketName(s_socketName);
+
+    m_thread = new QThread(this);
+    m_connection->moveToThread(m_thread);
+    m_thread->start();
+
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    auto registry = new KWayland::Client::Registry(this);
+    connect(registry, &KWayland::Client::Registry::interfaceAnnounced, this, [this, registry](const QByteArray &interface, quint32 id, quint32 version) {
+        if (interface == QByteArrayLiteral("ext_idle_notifier_v1")) {
+            m_idleNotifier = new IdleNotifier();
+            m_idleNotifier->init(*registry, id, version);
+        }
+    });
+    QSignalSpy interfacesAnnouncedSpy(registry, &KWayland::Client::Registry::interfacesAnnounced);
+    registry->setEventQueue(m_queue);
+    registry->create(m_connection->display());
+    QVERIFY(registry->isValid());
+    registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+    QVERIFY(m_idleNotifier);
+
+    const auto seat = registry->interface(KWayland::Client::Registry::Interface::Seat);
+    m_clientSeat = registry->createSeat(seat.name, seat.version, this);
+    QVERIFY(m_clientSeat->isValid());
+
+    const auto idle = registry->interface(KWayland::Client::Registry::Interface::Idle);
+    m_clientIdle = registry->createIdle(idle.name, idle.version, this);
+    QVERIFY(m_clientIdle->isValid());
+}
+
+TestIdleNotifyV1Interface::~TestIdleNotifyV1Interface()
+{
+    delete m_idleNotifier;
+    m_idleNotifier = nullptr;
+    delete m_clientIdle;
+    m_clientIdle = nullptr;
+    delete m_clientSeat;
+    m_clientSeat = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    m_connection->deleteLater();
+    m_connection = nullptr;
+}
+
+IdleNotification *TestIdleNotifyV1Interface::createNotification(quint32 timeout)
+{
+    return new IdleNotification(m_idleNotifier->get_idle_notification(timeout, *m_clientSeat));
+}
+
+void TestIdleNotifyV1Interface::testIdle()
+{
+    QScopedPointer<IdleNotification> notification(createNotification(500));
+    QSignalSpy idledSpy(notification.data(), &IdleNotification::idled);
+    QSignalSpy resumedSpy(notification.data(), &IdleNotification::resumed);
+    QVERIFY(idledSpy.wait());
+    QVERIFY(resumedSpy.isEmpty());
+
+    // idle is only sent once
+    QVERIFY(!idledSpy.wait(300));
+    QCOMPARE(idledSpy.count(), 1);
+
+    m_idleNotify->simulateUserActivity(m_seat);
+    QVERIFY(resumedSpy.wait());
+    QCOMPARE(resumedSpy.count(), 1);
+
+    // the activity restarted the timeout
+    QVERIFY(idledSpy.wait());
+    QCOMPARE(idledSpy.count(), 2);
+
+    // activity on all seats resumes as well, so does the activity reported to IdleInterface
+    m_idleNotify->simulateUserActivity();
+    QVERIFY(resumedSpy.wait());
+    QVERIFY(idledSpy.wait());
+    m_idle->simulateUserActivity();
+    QVERIFY(resumedSpy.wait());
+    QCOMPARE(resumedSpy.count(), 3);
+}
+
+void TestIdleNotifyV1Interface::testOtherSeat()
+{
+    SeatInterface otherSeat(&m_display);
+
+    QScopedPointer<IdleNotification> notification(createNotification(500));
+    QSignalSpy idledSpy(notification.data(), &IdleNotification::idled);
+    QSignalSpy resumedSpy(notification.data(), &IdleNotification::resumed);
+    QVERIFY(idledSpy.wait());
+
+    // activity on another seat does not concern the notification
+    m_idleNotify->simulateUserActivity(&otherSeat);
+    QVERIFY(!resumedSpy.wait(200));
+
+    m_idleNotify->simulateUserActivity(m_seat);
+    QVERIFY(resumedSpy.wait());
+}
+
+void TestIdleNotifyV1Interface::testInhibit()
+{
+    QScopedPointer<IdleNotification> notification(createNotification(500));
+    QSignalSpy idledSpy(notification.data(), &IdleNotification::idled);
+    QSignalSpy resumedSpy(notification.data(), &IdleNotification::resumed);
+    QVERIFY(idledSpy.wait());
+
+    // inhibiting resumes idle notifications, the inhibition is shared with IdleInterface
+    QSignalSpy inhibitedChangedSpy(m_idle, &IdleInterface::inhibitedChanged);
+    m_idleNotify->inhibit();
+    QVERIFY(m_idleNotify->isInhibited());
+    QVERIFY(m_idle->isInhibited());
+    QCOMPARE(inhibitedChangedSpy.count(), 1);
+    QVERIFY(resumedSpy.wait());
+
+    // no idle while inhibited
+    QVERIFY(!idledSpy.wait(300));
+    QCOMPARE(idledSpy.count(), 1);
+
+    m_idle->uninhibit();
+    QVERIFY(!m_idleNotify->isInhibited());
+    QCOMPARE(inhibitedChangedSpy.count(), 2);
+    QVERIFY(idledSpy.wait());
+    QCOMPARE(idledSpy.count(), 2);
+}
+
+void TestIdleNotifyV1Interface::testOrder()
+{
+    QStringList events;
+    QScopedPointer<IdleNotification> slow(createNotification(700));
+    QScopedPointer<IdleNotification> fast(createNotification(500));
+    QScopedPointer<IdleNotification> medium(createNotification(600));
+    connect(slow.data(), &IdleNotification::idled, this, [&events] {
+        events << QStringLiteral("slow");
+    });
+    connect(fast.data(), &IdleNotification::idled, this, [&events] {
+        events << QStringLiteral("fast");
+    });
+    connect(medium.data(), &IdleNotification::idled, this, [&events] {
+        events << QStringLiteral("medium");
+    });
+
+    // a notification that goes away doesn't disturb the others
+    QScopedPointer<IdleNotification> destroyed(createNotification(500));
+    destroyed.reset();
+
+    QSignalSpy slowIdledSpy(slow.data(), &IdleNotification::idled);
+    QVERIFY(slowIdledSpy.wait());
+    QCOMPARE(events, QStringList({QStringLiteral("fast"), QStringLiteral("medium"), QStringLiteral("slow")}));
+
+    // activity resumes all of them and the deadlines start over
+    QSignalSpy fastResumedSpy(fast.data(), &IdleNotification::resumed);
+    events.clear();
+    m_idleNotify->simulateUserActivity(m_seat);
+    QVERIFY(fastResumedSpy.wait());
+    QVERIFY(slowIdledSpy.wait());
+    QCOMPARE(events, QStringList({QStringLiteral("fast"), QStringLiteral("medium"), QStringLiteral("slow")}));
+}
+
+void TestIdleNotifyV1Interface::testActivityBeforeDeadline()
+{
+    QScopedPointer<IdleNotification> notification(createNotification(1000));
+    QSignalSpy idledSpy(notification.data(), &IdleNotification::idled);
+    QSignalSpy resumedSpy(notification.data(), &IdleNotification::resumed);
+
+    // The timer is still armed for the original deadline, when it fires the notification
+    // has to be moved to the deadline after the activity instead of going idle.
+    QTest::qWait(500);
+    QVERIFY(idledSpy.isEmpty());
+    m_idleNotify->simulateUserActivity(m_seat);
+    QElapsedTimer sinceActivity;
+    sinceActivity.start();
+
+    QVERIFY(idledSpy.wait());
+    // the scheduler counts in whole msec
+    QVERIFY(sinceActivity.elapsed() >= 999);
+    QCOMPARE(idledSpy.count(), 1);
+    // the notification was never idle, so there is nothing to resume from
+    QVERIFY(resumedSpy.isEmpty());
+}
+
+void TestIdleNotifyV1Interface::testMinimumTimeout()
+{
+    // a zero timeout is raised to the minimum, like for org_kde_kwin_idle
+    QElapsedTimer sinceCreation;
+    sinceCreation.start();
+    QScopedPointer<IdleNotification> notification(createNotification(0));
+    QSignalSpy idledSpy(notification.data(), &IdleNotification::idled);
+    QVERIFY(idledSpy.wait());
+    QVERIFY(sinceCreation.elapsed() >= 499);
+}
+
+void TestIdleNotifyV1Interface::testTimeoutActivityBeforeDeadline()
+{
+    // org_kde_kwin_idle_timeout can report activity for itself, the other timeouts keep their deadline
+    QScopedPointer<KWayland::Client::IdleTimeout> timeout(m_clientIdle->getTimeout(1000, m_clientSeat));
+    QVERIFY(timeout->isValid());
+    QScopedPointer<KWayland::Client::IdleTimeout> otherTimeout(m_clientIdle->getTimeout(1000, m_clientSeat));
+    QVERIFY(otherTimeout->isValid());
+    QSignalSpy idleSpy(timeout.data(), &KWayland::Client::IdleTimeout::idle);
+    QSignalSpy resumeFromIdleSpy(timeout.data(), &KWayland::Client::IdleTimeout::resumeFromIdle);
+    QSignalSpy otherIdleSpy(otherTimeout.data(), &KWayland::Client::IdleTimeout::idle);
+
+    QTest::qWait(500);
+    QVERIFY(idleSpy.isEmpty());
+    // the server gets the request after this point, so the deadline is at least a full timeout away
+    QElapsedTimer sinceActivity;
+    sinceActivity.start();
+    timeout->simulateUserActivity();
+
+    QVERIFY(otherIdleSpy.wait());
+    QVERIFY(idleSpy.isEmpty());
+    QVERIFY(idleSpy.wait());
+    QVERIFY(sinceActivity.elapsed() >= 999);
+    QCOMPARE(idleSpy.count(), 1);
+    QVERIFY(resumeFromIdleSpy.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestIdleNotifyV1Interface)
+
+#include "test_idlenotify_v1_interface.moc"
@@ -0,0 +1,227 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include <QThread>
+#include <QtTest>
+
+#include "../../src/server/compositor_interface.h"
+#include "../../src/server/display.h"
+#include "../../src/server/singlepixelbufferv1clientbuffer.h"
+#include "../../src/server/surface_interface.h"
+#include "../../src/server/viewporter_interface.h"
+
+#include "../../src/client/compositor.h"
+#include "../../src/client/connection_thread.h"
+#include "../../src/client/event_queue.h"
+#include "../../src/client/registry.h"
+#include "../../src/client/singlepixelbuffer.h"
+#include "../../src/client/surface.h"
+
+#include "qwayland-viewporter.h"
+
+#include <wayland-client-protocol.h>
+
+using namespace KWaylandServer;
+
+class Viewporter : public QtWayland::wp_viewporter
+{
+};
+
+class Viewport : public QtWayland::wp_viewport
+{
+};
+
+class TestSinglePixelBufferV1Interface : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~TestSinglePixelBufferV1Interface() override;
+
+private Q_SLOTS:
+    void initTestCase();
+    void testSolidColor();
+    void testTranslucentColor();
+    void testDestroyBuffer();
+
+private:
+    SurfaceInterface *createSurface(QScopedPointer<KWayland::Client::Surface> &surface);
+
+    KWayland::Client::ConnectionThread *m_connection;
+    KWayland::Client::EventQueue *m_queue;
+    KWayland::Client::Compositor *m_clientCompositor;
+    KWayland::Client::SinglePixelBufferManager *m_singlePixelBufferManager;
+
+    QThread *m_thread;
+    Display m_display;
+    CompositorInterface *m_serverCompositor;
+    Viewporter *m_viewporter = nullptr;
+};
+
+static const QString s_socketName = QStringLiteral("kwin-wayland-server-single-pixel-buffer-test-0");
+
+void TestSinglePixelBufferV1Interface::initTestCase()
+{
+    m_display.addSocketName(s_socketName);
+    m_display.start();
+    QVERIFY(m_display.isRunning());
+
+    new ViewporterInterface(&m_display, this);
+    new SinglePixelBufferV1ClientBufferIntegration(&m_display);
+
+    m_serverCompositor = new CompositorInterface(&m_display, this);
+
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketName(s_socketName);
+
+    m_thread = new QThread(this);
+    m_connection->moveToThread(m_thread);
+    m_thread->start();
+
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    auto registry = new KWayland::Client::Registry(this);
+    connect(registry, &KWayland::Client::Registry::interfaceAnnounced, this, [this, registry](const QByteArray &interface, quint32 id, quint32 version) {
+        if (interface == QByteArrayLiteral("wp_viewporter")) {
+            m_viewporter = new Viewporter();
+            m_viewporter->init(*registry, id, version);
+        }
+    });
+    QSignalSpy interfacesAnnouncedSpy(registry, &KWayland::Client::Registry::interfacesAnnounced);
+    registry->setEventQueue(m_queue);
+    registry->create(m_connection->display());
+    QVERIFY(registry->isValid());
+    registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+    QVERIFY(m_viewporter);
+
+    const auto compositor = registry->interface(KWayland::Client::Registry::Interface::Compositor);
+    m_clientCompositor = registry->createCompositor(compositor.name, compositor.version, this);
+    QVERIFY(m_clientCompositor->isValid());
+
+    QVERIFY(registry->hasInterface(KWayland::Client::Registry::Interface::SinglePixelBufferManagerV1));
+    const auto singlePixelBuffer = registry->interface(KWayland::Client::Registry::Interface::SinglePixelBufferManagerV1);
+    m_singlePixelBufferManager = registry->createSinglePixelBufferManager(singlePixelBuffer.name, singlePixelBuffer.version, this);
+    QVERIFY(m_singlePixelBufferManager->isValid());
+}
+
+TestSinglePixelBufferV1Interface::~TestSinglePixelBufferV1Interface()
+{
+    delete m_viewporter;
+    m_viewporter = nullptr;
+    delete m_singlePixelBufferManager;
+    m_singlePixelBufferManager = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    m_connection->deleteLater();
+    m_connection = nullptr;
+}
+
+SurfaceInterface *TestSinglePixelBufferV1Interface::createSurface(QScopedPointer<KWayland::Client::Surface> &surface)
+{
+    QSignalSpy serverSurfaceCreatedSpy(m_serverCompositor, &CompositorInterface::surfaceCreated);
+    surface.reset(m_clientCompositor->createSurface());
+    if (!serverSurfaceCreatedSpy.wait()) {
+        return nullptr;
+    }
+    return serverSurfaceCreatedSpy.first().first().value<SurfaceInterface *>();
+}
+
+void TestSinglePixelBufferV1Interface::testSolidColor()
+{
+    QScopedPointer<KWayland::Client::Surface> clientSurface;
+    SurfaceInterface *serverSurface = createSurface(clientSurface);
+    QVERIFY(serverSurface);
+
+    // The single pixel gets scaled to the surface size with a viewport.
+    QScopedPointer<Viewport> clientViewport(new Viewport);
+    clientViewport->init(m_viewporter->get_viewport(*clientSurface));
+    clientViewport->set_destination(100, 50);
+
+    wl_buffer *buffer = m_singlePixelBufferManager->createBuffer(Qt::red);
+    QSignalSpy serverSurfaceMappedSpy(serverSurface, &SurfaceInterface::mapped);
+    clientSurface->attachBuffer(buffer);
+    clientSurface->damage(QRect(0, 0, 100, 50));
+    clientSurface->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(serverSurfaceMappedSpy.wait());
+
+    auto serverBuffer = qobject_cast<SinglePixelBufferV1ClientBuffer *>(serverSurface->buffer());
+    QVERIFY(serverBuffer);
+    QCOMPARE(serverBuffer->size(), QSize(1, 1));
+    QCOMPARE(serverBuffer->color(), QRgba64::fromRgba64(0xffff, 0, 0, 0xffff));
+    QVERIFY(!serverBuffer->hasAlphaChannel());
+    QCOMPARE(serverBuffer->origin(), ClientBuffer::Origin::TopLeft);
+    QCOMPARE(serverSurface->bufferSize(), QSize(1, 1));
+    QCOMPARE(serverSurface->size(), QSize(100, 50));
+
+    wl_buffer_destroy(buffer);
+}
+
+void TestSinglePixelBufferV1Interface::testTranslucentColor()
+{
+    QScopedPointer<KWayland::Client::Surface> clientSurface;
+    SurfaceInterface *serverSurface = createSurface(clientSurface);
+    QVERIFY(serverSurface);
+
+    // The color is premultiplied by alpha on the client side.
+    wl_buffer *buffer = m_singlePixelBufferManager->createBuffer(QColor::fromRgba64(0xffff, 0x8000, 0, 0x8000));
+    QSignalSpy serverSurfaceMappedSpy(serverSurface, &SurfaceInterface::mapped);
+    clientSurface->attachBuffer(buffer);
+    clientSurface->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(serverSurfaceMappedSpy.wait());
+
+    auto serverBuffer = qobject_cast<SinglePixelBufferV1ClientBuffer *>(serverSurface->buffer());
+    QVERIFY(serverBuffer);
+    QCOMPARE(serverBuffer->color(), QRgba64::fromRgba64(0xffff, 0x8000, 0, 0x8000).premultiplied());
+    QVERIFY(serverBuffer->hasAlphaChannel());
+
+    wl_buffer_destroy(buffer);
+}
+
+void TestSinglePixelBufferV1Interface::testDestroyBuffer()
+{
+    QScopedPointer<KWayland::Client::Surface> clientSurface;
+    SurfaceInterface *serverSurface = createSurface(clientSurface);
+    QVERIFY(serverSurface);
+
+    wl_buffer *buffer = m_singlePixelBufferManager->createBuffer(0, 0, 0xffffffff, 0xffffffff);
+    QSignalSpy serverSurfaceMappedSpy(serverSurface, &SurfaceInterface::mapped);
+    clientSurface->attachBuffer(buffer);
+    clientSurface->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(serverSurfaceMappedSpy.wait());
+
+    QPointer<ClientBuffer> serverBuffer = serverSurface->buffer();
+    QVERIFY(serverBuffer);
+    QVERIFY(serverBuffer->isReferenced());
+    QVERIFY(!serverBuffer->isDestroyed());
+
+    // The buffer stays alive while the surface still references it.
+    wl_buffer_destroy(buffer);
+    QTRY_VERIFY(serverBuffer->isDestroyed());
+    QCOMPARE(serverSurface->buffer(), serverBuffer.data());
+
+    QSignalSpy serverSurfaceUnmappedSpy(serverSurface, &SurfaceInterface::unmapped);
+    clientSurface->attachBuffer((wl_buffer *)nullptr);
+    clientSurface->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(serverSurfaceUnmappedSpy.wait());
+    QTRY_VERIFY(!serverBuffer);
+}
+
+QTEST_GUILESS_MAIN(TestSinglePixelBufferV1Interface)
+
+#include "test_singlepixelbuffer_v1_interface.moc"
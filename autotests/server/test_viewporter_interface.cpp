@@ -172,6 +172,8 @@ void TestViewporterInterface::testCropScale()
     QCOMPARE(surfaceToBufferMatrixChangedSpy.count(), 2);
     QCOMPARE(serverSurface->size(), QSize(30, 20));
     QCOMPARE(serverSurface->mapToBuffer(QPointF(0, 0)), QPointF(20, 20));
+    QCOMPARE(serverSurface->mapToBuffer(QRect(0, 0, 30, 20)), QRect(20, 20, 60, 40));
+    QCOMPARE(serverSurface->mapFromBuffer(QRect(21, 21, 2, 2)), QRect(0, 0, 2, 2));
 
     // Scale the surface.
     clientViewport->set_destination(500, 250);
@@ -14,14 +14,119 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
 #include <qpa/qplatformnativeinterface.h>
 // Wayland
 #include <wayland-client-protocol.h>
+// system
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <functional>
 
 namespace KWayland
 {
 namespace Client
 {
+/**
+ * Reads the events from the Wayland socket into their queues, but never dispatches them.
+ *
+ * The read is prepared on an own queue which never gets any events, so that
+ * wl_display_prepare_read_queue cannot fail because of events pending in a queue which
+ * belongs to another thread.
+ **/
+class Q_DECL_HIDDEN ReaderThread : public QThread
+{
+public:
+    explicit ReaderThread(wl_display *display);
+    ~ReaderThread() override;
+
+    void stop();
+
+    std::function<void()> eventsRead;
+    std::function<void()> failed;
+
+protected:
+    void run() override;
+
+private:
+    wl_display *m_display;
+    wl_event_queue *m_queue;
+    int m_wakeupFd;
+};
+
+ReaderThread::ReaderThread(wl_display *display)
+    : m_display(display)
+    , m_queue(wl_display_create_queue(display))
+    , m_wakeupFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    setObjectName(QStringLiteral("WaylandReader"));
+}
+
+ReaderThread::~ReaderThread()
+{
+    stop();
+    wl_event_queue_destroy(m_queue);
+    close(m_wakeupFd);
+}
+
+void ReaderThread::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+    const quint64 value = 1;
+    if (write(m_wakeupFd, &value, sizeof(value)) != sizeof(value)) {
+        qCWarning(KWAYLAND_CLIENT) << "Failed to wake up the Wayland reader thread";
+    }
+    wait();
+}
+
+void ReaderThread::run()
+{
+    const int fd = wl_display_get_fd(m_display);
+    while (true) {
+        if (wl_display_prepare_read_queue(m_display, m_queue) != 0) {
+            wl_display_dispatch_queue_pending(m_display, m_queue);
+            continue;
+        }
+        // requests from all threads have to be sent out before waiting for their replies
+        if (wl_display_flush(m_display) == -1 && errno != EAGAIN) {
+            wl_display_cancel_read(m_display);
+            failed();
+            return;
+        }
+
+        pollfd fds[2] = {{fd, POLLIN, 0}, {m_wakeupFd, POLLIN, 0}};
+        if (poll(fds, 2, -1) == -1) {
+            wl_display_cancel_read(m_display);
+            if (errno == EINTR) {
+                continue;
+            }
+            failed();
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            wl_display_cancel_read(m_display);
+            return;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            wl_display_cancel_read(m_display);
+            failed();
+            return;
+        }
+        if (wl_display_read_events(m_display) == -1) {
+            failed();
+            return;
+        }
+        eventsRead();
+    }
+}
+
 class Q_DECL_HIDDEN ConnectionThread::Private
 {
 public:
@@ -29,16 +134,33 @@ public:
     ~Private();
     void doInitConnection();
     void setupSocketNotifier();
+    void setupReaderThread();
     void setupSocketFileWatcher();
+    void dispatchDefaultQueue();
+    bool handleDisplayError();
+    void timeoutRoundtrip(quint32 id);
+    void cancelRoundtrips();
+    static void roundtripDone(void *data, wl_callback *callback, uint32_t serial);
+    static const struct wl_callback_listener s_roundtripListener;
+
+    struct Roundtrip {
+        quint32 id = 0;
+        wl_callback *callback = nullptr;
+        QTimer *timer = nullptr;
+    };
+    QVector<Roundtrip> roundtrips;
+    quint32 lastRoundtripId = 0;
 
     wl_display *display = nullptr;
     int fd = -1;
     QString socketName;
     QDir runtimeDir;
     QScopedPointer<QSocketNotifier> socketNotifier;
+    QScopedPointer<ReaderThread> readerThread;
     QScopedPointer<QFileSystemWatcher> socketWatcher;
     bool serverDied = false;
     bool foreign = false;
+    bool useReaderThread = false;
     QMetaObject::Connection eventDispatcherConnection;
     int error = 0;
     static QVector<ConnectionThread *> connections;
@@ -51,6 +173,8 @@ private:
 QVector<ConnectionThread *> ConnectionThread::Private::connections = QVector<ConnectionThread *>{};
 QRecursiveMutex ConnectionThread::Private::mutex;
 
+const struct wl_callback_listener ConnectionThread::Private::s_roundtripListener = {roundtripDone};
+
 ConnectionThread::Private::Private(ConnectionThread *q)
     : socketName(QString::fromUtf8(qgetenv("WAYLAND_DISPLAY")))
     , runtimeDir(QString::fromUtf8(qgetenv("XDG_RUNTIME_DIR")))
@@ -71,6 +195,8 @@ ConnectionThread::Private::~Private()
         QMutexLocker lock(&mutex);
         connections.removeOne(q);
     }
+    readerThread.reset();
+    cancelRoundtrips();
     if (display && !foreign) {
         wl_display_flush(display);
         wl_display_disconnect(display);
@@ -96,7 +222,11 @@ void ConnectionThread::Private::doInitConnection()
     }
 
     // setup socket notifier
-    setupSocketNotifier();
+    if (useReaderThread) {
+        setupReaderThread();
+    } else {
+        setupSocketNotifier();
+    }
     setupSocketFileWatcher();
     Q_EMIT q->connected();
 }
@@ -110,13 +240,7 @@ void ConnectionThread::Private::setupSocketNotifier()
             return;
         }
         if (wl_display_dispatch(display) == -1) {
-            error = wl_display_get_error(display);
-            if (error != 0) {
-                if (display) {
-                    free(display);
-                    display = nullptr;
-                }
-                Q_EMIT q->errorOccurred();
+            if (handleDisplayError()) {
                 return;
             }
         }
@@ -124,6 +248,106 @@ void ConnectionThread::Private::setupSocketNotifier()
     });
 }
 
+void ConnectionThread::Private::setupReaderThread()
+{
+    ReaderThread *reader = new ReaderThread(display);
+    reader->eventsRead = [this]() {
+        // the default queue belongs to the thread of the ConnectionThread,
+        // every EventQueue dispatches itself in its own thread
+        QMetaObject::invokeMethod(
+            q,
+            [this]() {
+                dispatchDefaultQueue();
+            },
+            Qt::QueuedConnection);
+        Q_EMIT q->eventsRead();
+    };
+    reader->failed = [this, reader]() {
+        QMetaObject::invokeMethod(
+            q,
+            [this, reader]() {
+                if (readerThread.data() != reader) {
+                    // reconnected in the meantime
+                    return;
+                }
+                readerThread.reset();
+                if (display && !handleDisplayError()) {
+                    qCWarning(KWAYLAND_CLIENT) << "Stopped reading events from the Wayland socket";
+                }
+            },
+            Qt::QueuedConnection);
+    };
+    readerThread.reset(reader);
+    readerThread->start();
+}
+
+void ConnectionThread::Private::dispatchDefaultQueue()
+{
+    if (!display) {
+        return;
+    }
+    if (wl_display_dispatch_pending(display) == -1) {
+        handleDisplayError();
+    }
+}
+
+bool ConnectionThread::Private::handleDisplayError()
+{
+    error = wl_display_get_error(display);
+    if (error == 0) {
+        return false;
+    }
+    readerThread.reset();
+    cancelRoundtrips();
+    if (display) {
+        free(display);
+        display = nullptr;
+    }
+    Q_EMIT q->errorOccurred();
+    return true;
+}
+
+void ConnectionThread::Private::roundtripDone(void *data, wl_callback *callback, uint32_t serial)
+{
+    Q_UNUSED(serial)
+    auto d = reinterpret_cast<ConnectionThread::Private *>(data);
+    auto it = std::find_if(d->roundtrips.begin(), d->roundtrips.end(), [callback](const Roundtrip &roundtrip) {
+        return roundtrip.callback == callback;
+    });
+    wl_callback_destroy(callback);
+    if (it == d->roundtrips.end()) {
+        return;
+    }
+    const quint32 id = it->id;
+    delete it->timer;
+    d->roundtrips.erase(it);
+    Q_EMIT d->q->roundtripFinished(id);
+}
+
+void ConnectionThread::Private::timeoutRoundtrip(quint32 id)
+{
+    auto it = std::find_if(roundtrips.begin(), roundtrips.end(), [id](const Roundtrip &roundtrip) {
+        return roundtrip.id == id;
+    });
+    if (it == roundtrips.end()) {
+        return;
+    }
+    // destroying the proxy makes libwayland drop the late reply
+    wl_callback_destroy(it->callback);
+    it->timer->deleteLater();
+    roundtrips.erase(it);
+    Q_EMIT q->roundtripTimeout(id);
+}
+
+void ConnectionThread::Private::cancelRoundtrips()
+{
+    for (const Roundtrip &roundtrip : qAsConst(roundtrips)) {
+        wl_callback_destroy(roundtrip.callback);
+        delete roundtrip.timer;
+    }
+    roundtrips.clear();
+}
+
 void ConnectionThread::Private::setupSocketFileWatcher()
 {
     if (!runtimeDir.exists() || fd != -1) {
@@ -137,6 +361,8 @@ void ConnectionThread::Private::setupSocketFileWatcher()
         }
         qCWarning(KWAYLAND_CLIENT) << "Connection to server went away";
         serverDied = true;
+        readerThread.reset();
+        cancelRoundtrips();
         if (display) {
             free(display);
             display = nullptr;
@@ -189,6 +415,8 @@ ConnectionThread::ConnectionThread(wl_display *display, QObject *parent)
 ConnectionThread::~ConnectionThread()
 {
     disconnect(d->eventDispatcherConnection);
+    // the reader thread emits eventsRead on this object
+    d->readerThread.reset();
 }
 
 ConnectionThread *ConnectionThread::fromApplication(QObject *parent)
@@ -234,6 +462,20 @@ void ConnectionThread::setSocketFd(int fd)
     d->fd = fd;
 }
 
+void ConnectionThread::setUseReaderThread(bool use)
+{
+    if (d->display) {
+        // already initialized
+        return;
+    }
+    d->useReaderThread = use;
+}
+
+bool ConnectionThread::usesReaderThread() const
+{
+    return d->useReaderThread && !d->foreign;
+}
+
 wl_display *ConnectionThread::display()
 {
     return d->display;
@@ -271,6 +513,33 @@ void ConnectionThread::roundtrip()
     wl_display_roundtrip(d->display);
 }
 
+quint32 ConnectionThread::roundtripAsync(int timeout)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+    if (!d->display) {
+        return 0;
+    }
+    Private::Roundtrip roundtrip;
+    roundtrip.id = ++d->lastRoundtripId;
+    if (roundtrip.id == 0) {
+        roundtrip.id = ++d->lastRoundtripId;
+    }
+    roundtrip.callback = wl_display_sync(d->display);
+    wl_callback_add_listener(roundtrip.callback, &Private::s_roundtripListener, d.data());
+    if (timeout >= 0) {
+        const quint32 id = roundtrip.id;
+        roundtrip.timer = new QTimer(this);
+        roundtrip.timer->setSingleShot(true);
+        connect(roundtrip.timer, &QTimer::timeout, this, [this, id]() {
+            d->timeoutRoundtrip(id);
+        });
+        roundtrip.timer->start(timeout);
+    }
+    d->roundtrips << roundtrip;
+    wl_display_flush(d->display);
+    return roundtrip.id;
+}
+
 bool ConnectionThread::hasError() const
 {
     return d->error != 0;
@@ -75,6 +75,19 @@ namespace Client
  * the Wayland socket, it will be dispatched and the signal @link ::eventsRead @endlink is emitted.
  * This allows further event queues in other threads to also dispatch their events.
  *
+ * By default the Wayland socket is read from the thread the ConnectionThread lives in, so
+ * a busy thread delays the events of all event queues. With @link ::setUseReaderThread @endlink
+ * the socket is read by a dedicated thread instead and each EventQueue gets dispatched in the
+ * thread it lives in, independent of the thread of the ConnectionThread:
+ *
+ * @code
+ * connection->setUseReaderThread(true);
+ * connection->initConnection();
+ * // later, in the render thread
+ * EventQueue *queue = new EventQueue;
+ * queue->setup(connection);
+ * @endcode
+ *
  * Furthermore this class flushes the Wayland connection whenever the QAbstractEventDispatcher
  * is about to block.
  *
@@ -159,6 +172,25 @@ public:
      * @see setSocketName
      **/
     void setSocketFd(int fd);
+    /**
+     * Sets whether a dedicated reader thread should read the events from the Wayland socket.
+     * Only applies if called before calling initConnection and is ignored for a
+     * ConnectionThread created through @link fromApplication @endlink.
+     *
+     * The reader thread only reads the events into their queues, it never dispatches them. The
+     * default queue is dispatched in the thread of the ConnectionThread, every EventQueue in its
+     * own thread. In this mode @link ::eventsRead @endlink is emitted from the reader thread.
+     *
+     * The default is @c false, the socket is read in the thread of the ConnectionThread.
+     *
+     * @see usesReaderThread
+     **/
+    void setUseReaderThread(bool use);
+    /**
+     * @returns whether a dedicated reader thread reads the events from the Wayland socket
+     * @see setUseReaderThread
+     **/
+    bool usesReaderThread() const;
 
     /**
      * Trigger a blocking roundtrip to the Wayland server. Ensures that all events are processed
@@ -168,6 +200,25 @@ public:
      **/
     void roundtrip();
 
+    /**
+     * Triggers a non-blocking roundtrip to the Wayland server.
+     *
+     * A wl_display.sync request is sent and the method returns right away. Once the server
+     * has processed all requests sent before and the events it sent in response got dispatched
+     * on the default queue, the signal @link ::roundtripFinished @endlink is emitted with the
+     * returned identifier. If that does not happen within @p timeout milliseconds, the signal
+     * @link ::roundtripTimeout @endlink is emitted instead and a late reply is ignored. A
+     * negative @p timeout waits forever.
+     *
+     * This method must be called from the thread the ConnectionThread lives in, as the default
+     * queue is dispatched in that thread.
+     *
+     * @returns an identifier for the roundtrip or @c 0 if there is no connection
+     * @see roundtrip
+     * @see Registry::sync
+     **/
+    quint32 roundtripAsync(int timeout = -1);
+
     /**
      * @returns whether the Wayland connection experienced an error
      * @see errorCode
@@ -220,6 +271,10 @@ Q_SIGNALS:
     void failed();
     /**
      * Emitted whenever new events are ready to be read.
+     *
+     * If the ConnectionThread uses a reader thread, this signal is emitted from the reader
+     * thread. Functors connected without a context object are invoked in the reader thread.
+     * @see setUseReaderThread
      **/
     void eventsRead();
     /**
@@ -237,6 +292,18 @@ Q_SIGNALS:
      * @since 5.23
      **/
     void errorOccurred();
+    /**
+     * Emitted when the roundtrip with the given @p id triggered by @link roundtripAsync @endlink
+     * finished.
+     * @see roundtripAsync
+     **/
+    void roundtripFinished(quint32 id);
+    /**
+     * Emitted when the roundtrip with the given @p id triggered by @link roundtripAsync @endlink
+     * did not finish in time.
+     * @see roundtripAsync
+     **/
+    void roundtripTimeout(quint32 id);
 
 protected:
     /*
@@ -0,0 +1,236 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#ifndef KWAYLAND_CLIENT_CURSORSHAPE_H
+#define KWAYLAND_CLIENT_CURSORSHAPE_H
+
+#include <QObject>
+
+#include <DWayland/Client/kwaylandclient_export.h>
+
+struct wp_cursor_shape_manager_v1;
+struct wp_cursor_shape_device_v1;
+
+namespace KWayland
+{
+namespace Client
+{
+class CursorShapeDevice;
+class EventQueue;
+class Pointer;
+
+/**
+ * @short Wrapper for the wp_cursor_shape_manager_v1 interface.
+ *
+ * This class provides a convenient wrapper for the wp_cursor_shape_manager_v1 interface.
+ *
+ * To use this class one needs to interact with the Registry. There are two
+ * possible ways to create the CursorShapeManager interface:
+ * @code
+ * CursorShapeManager *c = registry->createCursorShapeManager(name, version);
+ * @endcode
+ *
+ * This creates the CursorShapeManager and sets it up directly. As an alternative this
+ * can also be done in a more low level way:
+ * @code
+ * CursorShapeManager *c = new CursorShapeManager;
+ * c->setup(registry->bindCursorShapeManager(name, version));
+ * @endcode
+ *
+ * The CursorShapeManager can be used as a drop-in replacement for any wp_cursor_shape_manager_v1
+ * pointer as it provides matching cast operators.
+ *
+ * @see Registry
+ **/
+class KWAYLANDCLIENT_EXPORT CursorShapeManager : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Creates a new CursorShapeManager.
+     * Note: after constructing the CursorShapeManager it is not yet valid and one needs
+     * to call setup. In order to get a ready to use CursorShapeManager prefer using
+     * Registry::createCursorShapeManager.
+     **/
+    explicit CursorShapeManager(QObject *parent = nullptr);
+    ~CursorShapeManager() override;
+
+    /**
+     * Setup this CursorShapeManager to manage the @p manager.
+     * When using Registry::createCursorShapeManager there is no need to call this
+     * method.
+     **/
+    void setup(wp_cursor_shape_manager_v1 *manager);
+    /**
+     * @returns @c true if managing a wp_cursor_shape_manager_v1.
+     **/
+    bool isValid() const;
+    /**
+     * Releases the wp_cursor_shape_manager_v1 interface.
+     * After the interface has been released the CursorShapeManager instance is no
+     * longer valid and can be setup with another wp_cursor_shape_manager_v1 interface.
+     **/
+    void release();
+    /**
+     * Destroys the data held by this CursorShapeManager.
+     * This method is supposed to be used when the connection to the Wayland
+     * server goes away. If the connection is not valid anymore, it's not
+     * possible to call release anymore as that calls into the Wayland
+     * connection and the call would fail. This method cleans up the data, so
+     * that the instance can be deleted or set up to a new wp_cursor_shape_manager_v1 interface
+     * once there is a new connection available.
+     *
+     * It is suggested to connect this method to ConnectionThread::connectionDied:
+     * @code
+     * connect(connection, &ConnectionThread::connectionDied, manager, &CursorShapeManager::destroy);
+     * @endcode
+     *
+     * @see release
+     **/
+    void destroy();
+
+    /**
+     * Sets the @p queue to use for creating objects with this CursorShapeManager.
+     **/
+    void setEventQueue(EventQueue *queue);
+    /**
+     * @returns The event queue to use for creating objects with this CursorShapeManager.
+     **/
+    EventQueue *eventQueue();
+
+    /**
+     * Creates a CursorShapeDevice to set predefined cursor shapes for @p pointer.
+     * @param pointer The Pointer whose cursor should be set
+     * @param parent The parent object for the CursorShapeDevice
+     * @returns The created CursorShapeDevice
+     **/
+    CursorShapeDevice *createDevice(Pointer *pointer, QObject *parent = nullptr);
+
+    operator wp_cursor_shape_manager_v1 *();
+    operator wp_cursor_shape_manager_v1 *() const;
+
+Q_SIGNALS:
+    /**
+     * The corresponding global for this interface on the Registry got removed.
+     *
+     * This signal gets only emitted if the CursorShapeManager got created by
+     * Registry::createCursorShapeManager
+     **/
+    void removed();
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+/**
+ * The CursorShapeDevice sets the cursor of a Pointer to one of the predefined shapes.
+ *
+ * Unlike Pointer::setCursor no Surface and no buffers are needed, the compositor renders
+ * the shape from its own cursor theme. Shapes and cursor surfaces can be mixed, the last
+ * request wins.
+ *
+ * @see CursorShapeManager
+ * @see Pointer
+ **/
+class KWAYLANDCLIENT_EXPORT CursorShapeDevice : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * The predefined cursor shapes, named after the CSS cursor property.
+     **/
+    enum class Shape {
+        Default = 1,
+        ContextMenu,
+        Help,
+        Pointer,
+        Progress,
+        Wait,
+        Cell,
+        Crosshair,
+        Text,
+        VerticalText,
+        Alias,
+        Copy,
+        Move,
+        NoDrop,
+        NotAllowed,
+        Grab,
+        Grabbing,
+        EResize,
+        NResize,
+        NeResize,
+        NwResize,
+        SResize,
+        SeResize,
+        SwResize,
+        WResize,
+        EwResize,
+        NsResize,
+        NeswResize,
+        NwseResize,
+        ColResize,
+        RowResize,
+        AllScroll,
+        ZoomIn,
+        ZoomOut,
+    };
+    Q_ENUM(Shape)
+
+    ~CursorShapeDevice() override;
+
+    /**
+     * Setup this CursorShapeDevice to manage the @p device.
+     * When using CursorShapeManager::createDevice there is no need to call this
+     * method.
+     **/
+    void setup(wp_cursor_shape_device_v1 *device);
+    /**
+     * @returns @c true if managing a wp_cursor_shape_device_v1.
+     **/
+    bool isValid() const;
+    /**
+     * Releases the wp_cursor_shape_device_v1 interface.
+     * After the interface has been released the CursorShapeDevice instance is no
+     * longer valid and can be setup with another wp_cursor_shape_device_v1 interface.
+     **/
+    void release();
+    /**
+     * Destroys the data held by this CursorShapeDevice.
+     * This method is supposed to be used when the connection to the Wayland
+     * server goes away. If the connection is not valid anymore, it's not
+     * possible to call release anymore as that calls into the Wayland
+     * connection and the call would fail. This method cleans up the data, so
+     * that the instance can be deleted or set up to a new wp_cursor_shape_device_v1 interface
+     * once there is a new connection available.
+     *
+     * @see release
+     **/
+    void destroy();
+
+    /**
+     * Sets the cursor to @p shape.
+     *
+     * This has only an effect if a Surface of the same client is focused.
+     * @param serial The serial of the last Pointer::entered signal
+     * @param shape The shape the cursor should have
+     **/
+    void setShape(quint32 serial, Shape shape);
+
+    operator wp_cursor_shape_device_v1 *();
+    operator wp_cursor_shape_device_v1 *() const;
+
+private:
+    friend class CursorShapeManager;
+    explicit CursorShapeDevice(QObject *parent = nullptr);
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+}
+
+#endif
@@ -24,6 +24,7 @@ License along with this library.  If not, see <http://www.gnu.org/licenses/>.
 #include "wayland_pointer_p.h"
 // Qt
 #include <QDebug>
+#include <QHash>
 #include <QVector>
 // wayland
 #include "wayland-dde-shell-client-protocol.h"
@@ -75,6 +76,9 @@ public:
     bool onAllDesktops = false;
     int splitable = 0;
 
+    void setParentSurface(Surface *surface);
+    void forgetParentSurface();
+
     static DDEShellSurface *get(wl_surface *surface);
     static DDEShellSurface *get(Surface *surface);
 
@@ -102,11 +106,12 @@ private:
     }
 
     DDEShellSurface *q;
-    static QVector<Private*> s_ddeShellSurfaces;
+    // keyed by the parent Surface, looked up whenever a DDEShellSurface is created
+    static QMultiHash<Surface *, Private *> s_ddeShellSurfaces;
     static const dde_shell_surface_listener s_listener;
 };
 
-QVector<DDEShellSurface::Private*> DDEShellSurface::Private::s_ddeShellSurfaces;
+QMultiHash<Surface *, DDEShellSurface::Private *> DDEShellSurface::Private::s_ddeShellSurfaces;
 
 DDEShell::Private::Private(DDEShell *q)
     : q(q)
@@ -199,7 +204,7 @@ DDEShellSurface *DDEShell::createShellSurface(wl_surface *surface, QObject *pare
         d->queue->addProxy(w);
     }
     s->setup(w);
-    s->d->parentSurface = QPointer<Surface>(kwS);
+    s->d->setParentSurface(kwS);
     return s;
 }
 
@@ -212,38 +217,52 @@ DDEShellSurface *DDEShell::createShellSurface(Surface *surface, QObject *parent)
 DDEShellSurface::Private::Private(DDEShellSurface *q)
     : q(q)
 {
-    s_ddeShellSurfaces << this;
 }
 
 DDEShellSurface::Private::~Private()
 {
-    s_ddeShellSurfaces.removeAll(this);
+    forgetParentSurface();
 }
 
-DDEShellSurface *DDEShellSurface::Private::get(wl_surface *surface)
+void DDEShellSurface::Private::setParentSurface(Surface *surface)
 {
+    forgetParentSurface();
+    parentSurface = QPointer<Surface>(surface);
     if (!surface) {
-        return nullptr;
+        return;
     }
-    for (auto it = s_ddeShellSurfaces.constBegin(); it != s_ddeShellSurfaces.constEnd(); ++it) {
-        if ((*it)->parentSurface == Surface::get(surface)) {
-            return (*it)->q;
-        }
+    s_ddeShellSurfaces.insert(surface, this);
+    // the address may be reused by another Surface once this one is gone
+    QObject::connect(surface, &QObject::destroyed, q, [this, surface]() {
+        s_ddeShellSurfaces.remove(surface, this);
+    });
+}
+
+void DDEShellSurface::Private::forgetParentSurface()
+{
+    if (!parentSurface) {
+        return;
     }
-    return nullptr;
+    QObject::disconnect(parentSurface, &QObject::destroyed, q, nullptr);
+    s_ddeShellSurfaces.remove(parentSurface, this);
 }
 
-DDEShellSurface *DDEShellSurface::Private::get(Surface *surface)
+DDEShellSurface *DDEShellSurface::Private::get(wl_surface *surface)
 {
     if (!surface) {
         return nullptr;
     }
-    for (auto it = s_ddeShellSurfaces.constBegin(); it != s_ddeShellSurfaces.constEnd(); ++it) {
-        if ((*it)->parentSurface == surface) {
-            return (*it)->q;
-        }
+    return get(Surface::get(surface));
+}
+
+DDEShellSurface *DDEShellSurface::Private::get(Surface *surface)
+{
+    // The oldest shell surface of the surface is the last of the key.
+    Private *p = nullptr;
+    for (auto it = s_ddeShellSurfaces.constFind(surface); it != s_ddeShellSurfaces.constEnd() && it.key() == surface; ++it) {
+        p = it.value();
     }
-    return nullptr;
+    return p ? p->q : nullptr;
 }
 
 void DDEShellSurface::Private::setup(dde_shell_surface *s)
@@ -462,6 +481,11 @@ void DDEShellSurface::setup(dde_shell_surface *ddeShellSurface)
     d->setup(ddeShellSurface);
 }
 
+DDEShellSurface *DDEShellSurface::get(wl_surface *surface)
+{
+    return DDEShellSurface::Private::get(surface);
+}
+
 DDEShellSurface *DDEShellSurface::get(Surface *surface)
 {
     if (auto s = DDEShellSurface::Private::get(surface)) {
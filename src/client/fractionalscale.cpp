@@ -0,0 +1,189 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#include "fractionalscale.h"
+#include "event_queue.h"
+#include "surface.h"
+#include "wayland_pointer_p.h"
+
+#include <wayland-fractional-scale-v1-client-protocol.h>
+
+namespace KWayland
+{
+namespace Client
+{
+class Q_DECL_HIDDEN FractionalScaleManager::Private
+{
+public:
+    Private() = default;
+
+    void setup(wp_fractional_scale_manager_v1 *arg);
+
+    WaylandPointer<wp_fractional_scale_manager_v1, wp_fractional_scale_manager_v1_destroy> manager;
+    EventQueue *queue = nullptr;
+};
+
+FractionalScaleManager::FractionalScaleManager(QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+}
+
+void FractionalScaleManager::Private::setup(wp_fractional_scale_manager_v1 *arg)
+{
+    Q_ASSERT(arg);
+    Q_ASSERT(!manager);
+    manager.setup(arg);
+}
+
+FractionalScaleManager::~FractionalScaleManager()
+{
+    release();
+}
+
+void FractionalScaleManager::setup(wp_fractional_scale_manager_v1 *manager)
+{
+    d->setup(manager);
+}
+
+void FractionalScaleManager::release()
+{
+    d->manager.release();
+}
+
+void FractionalScaleManager::destroy()
+{
+    d->manager.destroy();
+}
+
+FractionalScaleManager::operator wp_fractional_scale_manager_v1 *()
+{
+    return d->manager;
+}
+
+FractionalScaleManager::operator wp_fractional_scale_manager_v1 *() const
+{
+    return d->manager;
+}
+
+bool FractionalScaleManager::isValid() const
+{
+    return d->manager.isValid();
+}
+
+void FractionalScaleManager::setEventQueue(EventQueue *queue)
+{
+    d->queue = queue;
+}
+
+EventQueue *FractionalScaleManager::eventQueue()
+{
+    return d->queue;
+}
+
+FractionalScale *FractionalScaleManager::createFractionalScale(Surface *surface, QObject *parent)
+{
+    Q_ASSERT(isValid());
+    auto p = new FractionalScale(parent);
+    auto w = wp_fractional_scale_manager_v1_get_fractional_scale(d->manager, *surface);
+    if (d->queue) {
+        d->queue->addProxy(w);
+    }
+    p->setup(w);
+    return p;
+}
+
+class Q_DECL_HIDDEN FractionalScale::Private
+{
+public:
+    explicit Private(FractionalScale *q);
+    void setup(wp_fractional_scale_v1 *arg);
+
+    WaylandPointer<wp_fractional_scale_v1, wp_fractional_scale_v1_destroy> fractionalscale;
+    qreal preferredScale = 1;
+
+private:
+    static void preferredScaleCallback(void *data, wp_fractional_scale_v1 *wp_fractional_scale_v1, uint32_t scale);
+    static const struct wp_fractional_scale_v1_listener s_listener;
+
+    FractionalScale *q;
+};
+
+const wp_fractional_scale_v1_listener FractionalScale::Private::s_listener = {preferredScaleCallback};
+
+void FractionalScale::Private::preferredScaleCallback(void *data, wp_fractional_scale_v1 *wp_fractional_scale_v1, uint32_t scale)
+{
+    Q_UNUSED(wp_fractional_scale_v1)
+    auto p = reinterpret_cast<Private *>(data);
+    // the scale is sent in units of 1/120
+    const qreal preferredScale = scale / 120.0;
+    if (qFuzzyCompare(p->preferredScale, preferredScale)) {
+        return;
+    }
+    p->preferredScale = preferredScale;
+    Q_EMIT p->q->preferredScaleChanged(p->preferredScale);
+}
+
+FractionalScale::Private::Private(FractionalScale *q)
+    : q(q)
+{
+}
+
+void FractionalScale::Private::setup(wp_fractional_scale_v1 *arg)
+{
+    Q_ASSERT(arg);
+    Q_ASSERT(!fractionalscale);
+    fractionalscale.setup(arg);
+    wp_fractional_scale_v1_add_listener(fractionalscale, &s_listener, this);
+}
+
+FractionalScale::FractionalScale(QObject *parent)
+    : QObject(parent)
+    , d(new Private(this))
+{
+}
+
+FractionalScale::~FractionalScale()
+{
+    release();
+}
+
+void FractionalScale::setup(wp_fractional_scale_v1 *fractionalscale)
+{
+    d->setup(fractionalscale);
+}
+
+void FractionalScale::release()
+{
+    d->fractionalscale.release();
+}
+
+void FractionalScale::destroy()
+{
+    d->fractionalscale.destroy();
+}
+
+qreal FractionalScale::preferredScale() const
+{
+    return d->preferredScale;
+}
+
+FractionalScale::operator wp_fractional_scale_v1 *()
+{
+    return d->fractionalscale;
+}
+
+FractionalScale::operator wp_fractional_scale_v1 *() const
+{
+    return d->fractionalscale;
+}
+
+bool FractionalScale::isValid() const
+{
+    return d->fractionalscale.isValid();
+}
+
+}
+}
@@ -0,0 +1,201 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#ifndef KWAYLAND_CLIENT_FRACTIONALSCALE_H
+#define KWAYLAND_CLIENT_FRACTIONALSCALE_H
+
+#include <QObject>
+
+#include <DWayland/Client/kwaylandclient_export.h>
+
+struct wp_fractional_scale_manager_v1;
+struct wp_fractional_scale_v1;
+
+namespace KWayland
+{
+namespace Client
+{
+class EventQueue;
+class FractionalScale;
+class Surface;
+
+/**
+ * @short Wrapper for the wp_fractional_scale_manager_v1 interface.
+ *
+ * This class provides a convenient wrapper for the wp_fractional_scale_manager_v1 interface.
+ *
+ * To use this class one needs to interact with the Registry. There are two
+ * possible ways to create the FractionalScaleManager interface:
+ * @code
+ * FractionalScaleManager *c = registry->createFractionalScaleManager(name, version);
+ * @endcode
+ *
+ * This creates the FractionalScaleManager and sets it up directly. As an alternative this
+ * can also be done in a more low level way:
+ * @code
+ * FractionalScaleManager *c = new FractionalScaleManager;
+ * c->setup(registry->bindFractionalScaleManager(name, version));
+ * @endcode
+ *
+ * The FractionalScaleManager can be used as a drop-in replacement for any wp_fractional_scale_manager_v1
+ * pointer as it provides matching cast operators.
+ *
+ * @see Registry
+ **/
+class KWAYLANDCLIENT_EXPORT FractionalScaleManager : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Creates a new FractionalScaleManager.
+     * Note: after constructing the FractionalScaleManager it is not yet valid and one needs
+     * to call setup. In order to get a ready to use FractionalScaleManager prefer using
+     * Registry::createFractionalScaleManager.
+     **/
+    explicit FractionalScaleManager(QObject *parent = nullptr);
+    ~FractionalScaleManager() override;
+
+    /**
+     * Setup this FractionalScaleManager to manage the @p manager.
+     * When using Registry::createFractionalScaleManager there is no need to call this
+     * method.
+     **/
+    void setup(wp_fractional_scale_manager_v1 *manager);
+    /**
+     * @returns @c true if managing a wp_fractional_scale_manager_v1.
+     **/
+    bool isValid() const;
+    /**
+     * Releases the wp_fractional_scale_manager_v1 interface.
+     * After the interface has been released the FractionalScaleManager instance is no
+     * longer valid and can be setup with another wp_fractional_scale_manager_v1 interface.
+     **/
+    void release();
+    /**
+     * Destroys the data held by this FractionalScaleManager.
+     * This method is supposed to be used when the connection to the Wayland
+     * server goes away. If the connection is not valid anymore, it's not
+     * possible to call release anymore as that calls into the Wayland
+     * connection and the call would fail. This method cleans up the data, so
+     * that the instance can be deleted or set up to a new wp_fractional_scale_manager_v1 interface
+     * once there is a new connection available.
+     *
+     * It is suggested to connect this method to ConnectionThread::connectionDied:
+     * @code
+     * connect(connection, &ConnectionThread::connectionDied, manager, &FractionalScaleManager::destroy);
+     * @endcode
+     *
+     * @see release
+     **/
+    void destroy();
+
+    /**
+     * Sets the @p queue to use for creating objects with this FractionalScaleManager.
+     **/
+    void setEventQueue(EventQueue *queue);
+    /**
+     * @returns The event queue to use for creating objects with this FractionalScaleManager.
+     **/
+    EventQueue *eventQueue();
+
+    /**
+     * Creates a FractionalScale for the given @p surface, which tells the scale the
+     * compositor prefers for the @p surface. Only one FractionalScale may exist per Surface.
+     * @param surface The Surface to get the preferred scale for
+     * @param parent The parent object for the FractionalScale
+     * @returns The created FractionalScale
+     **/
+    FractionalScale *createFractionalScale(Surface *surface, QObject *parent = nullptr);
+
+    operator wp_fractional_scale_manager_v1 *();
+    operator wp_fractional_scale_manager_v1 *() const;
+
+Q_SIGNALS:
+    /**
+     * The corresponding global for this interface on the Registry got removed.
+     *
+     * This signal gets only emitted if the FractionalScaleManager got created by
+     * Registry::createFractionalScaleManager
+     **/
+    void removed();
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+/**
+ * The FractionalScale tells the scale the compositor prefers for a Surface, which may be
+ * fractional, e.g. @c 1.25.
+ *
+ * To make use of it, the client renders buffers of the surface size multiplied by the
+ * preferredScale, keeps the buffer scale of the Surface at @c 1 and sets the surface size
+ * as the destination of a wp_viewport. Rounding the buffer size halfway away from zero
+ * gives buffers which map exactly to the physical pixels of the output.
+ *
+ * @see FractionalScaleManager
+ * @see Surface
+ **/
+class KWAYLANDCLIENT_EXPORT FractionalScale : public QObject
+{
+    Q_OBJECT
+public:
+    ~FractionalScale() override;
+
+    /**
+     * Setup this FractionalScale to manage the @p fractionalscale.
+     * When using FractionalScaleManager::createFractionalScale there is no need to call this
+     * method.
+     **/
+    void setup(wp_fractional_scale_v1 *fractionalscale);
+    /**
+     * @returns @c true if managing a wp_fractional_scale_v1.
+     **/
+    bool isValid() const;
+    /**
+     * Releases the wp_fractional_scale_v1 interface.
+     * After the interface has been released the FractionalScale instance is no
+     * longer valid and can be setup with another wp_fractional_scale_v1 interface.
+     **/
+    void release();
+    /**
+     * Destroys the data held by this FractionalScale.
+     * This method is supposed to be used when the connection to the Wayland
+     * server goes away. If the connection is not valid anymore, it's not
+     * possible to call release anymore as that calls into the Wayland
+     * connection and the call would fail. This method cleans up the data, so
+     * that the instance can be deleted or set up to a new wp_fractional_scale_v1 interface
+     * once there is a new connection available.
+     *
+     * @see release
+     **/
+    void destroy();
+
+    /**
+     * The scale the compositor prefers for the Surface, @c 1 until the compositor told otherwise.
+     * @see preferredScaleChanged
+     **/
+    qreal preferredScale() const;
+
+    operator wp_fractional_scale_v1 *();
+    operator wp_fractional_scale_v1 *() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted whenever the preferredScale changed.
+     **/
+    void preferredScaleChanged(qreal scale);
+
+private:
+    friend class FractionalScaleManager;
+    explicit FractionalScale(QObject *parent = nullptr);
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "output.h"
 #include "wayland_pointer_p.h"
 // Qt
+#include <QHash>
 #include <QPoint>
 #include <QRect>
 #include <QVector>
@@ -27,6 +28,7 @@ public:
     Private(Output *q);
     ~Private();
     void setup(wl_output *o);
+    void forgetNative();
 
     WaylandPointer<wl_output, wl_output_release> output;
     EventQueue *queue = nullptr;
@@ -68,32 +70,28 @@ private:
     Output *q;
     static struct wl_output_listener s_outputListener;
 
-    static QVector<Private *> s_allOutputs;
+    static QMultiHash<wl_output *, Private *> s_allOutputs;
 };
 
-QVector<Output::Private *> Output::Private::s_allOutputs;
+QMultiHash<wl_output *, Output::Private *> Output::Private::s_allOutputs;
 
 Output::Private::Private(Output *q)
     : q(q)
 {
-    s_allOutputs << this;
 }
 
 Output::Private::~Private()
 {
-    s_allOutputs.removeOne(this);
 }
 
 Output *Output::Private::get(wl_output *o)
 {
-    auto it = std::find_if(s_allOutputs.constBegin(), s_allOutputs.constEnd(), [o](Private *p) {
-        const wl_output *reference = p->output;
-        return reference == o;
-    });
-    if (it != s_allOutputs.constEnd()) {
-        return (*it)->q;
+    // A proxy can be wrapped more than once, the oldest wrapper is the last of the key.
+    Private *p = nullptr;
+    for (auto it = s_allOutputs.constFind(o); it != s_allOutputs.constEnd() && it.key() == o; ++it) {
+        p = it.value();
     }
-    return nullptr;
+    return p ? p->q : nullptr;
 }
 
 void Output::Private::setup(wl_output *o)
@@ -101,9 +99,15 @@ void Output::Private::setup(wl_output *o)
     Q_ASSERT(o);
     Q_ASSERT(!output);
     output.setup(o);
+    s_allOutputs.insert(o, this);
     wl_output_add_listener(output, &s_outputListener, this);
 }
 
+void Output::Private::forgetNative()
+{
+    s_allOutputs.remove(output, this);
+}
+
 bool Output::Mode::operator==(const Output::Mode &m) const
 {
     return size == m.size && refreshRate == m.refreshRate && flags == m.flags && output == m.output;
@@ -117,6 +121,7 @@ Output::Output(QObject *parent)
 
 Output::~Output()
 {
+    d->forgetNative();
     d->output.release();
 }
 
@@ -382,6 +387,7 @@ Output *Output::get(wl_output *o)
 
 void Output::destroy()
 {
+    d->forgetNative();
     d->output.destroy();
 }
 
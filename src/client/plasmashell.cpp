@@ -8,6 +8,8 @@
 #include "output.h"
 #include "surface.h"
 #include "wayland_pointer_p.h"
+// Qt
+#include <QHash>
 // Wayland
 #include <wayland-plasma-shell-client-protocol.h>
 
@@ -34,6 +36,9 @@ public:
     QPointer<Surface> parentSurface;
     PlasmaShellSurface::Role role;
 
+    void setParentSurface(Surface *surface);
+    void forgetParentSurface();
+
     static PlasmaShellSurface *get(Surface *surface);
 
 private:
@@ -41,11 +46,12 @@ private:
     static void autoHidingPanelShownCallback(void *data, org_kde_plasma_surface *org_kde_plasma_surface);
 
     PlasmaShellSurface *q;
-    static QVector<Private *> s_surfaces;
+    // keyed by the parent Surface, looked up whenever a PlasmaShellSurface is created
+    static QMultiHash<Surface *, Private *> s_surfaces;
     static const org_kde_plasma_surface_listener s_listener;
 };
 
-QVector<PlasmaShellSurface::Private *> PlasmaShellSurface::Private::s_surfaces;
+QMultiHash<Surface *, PlasmaShellSurface::Private *> PlasmaShellSurface::Private::s_surfaces;
 
 PlasmaShell::PlasmaShell(QObject *parent)
     : QObject(parent)
@@ -110,7 +116,7 @@ PlasmaShellSurface *PlasmaShell::createSurface(wl_surface *surface, QObject *par
         d->queue->addProxy(w);
     }
     s->setup(w);
-    s->d->parentSurface = QPointer<Surface>(kwS);
+    s->d->setParentSurface(kwS);
     return s;
 }
 
@@ -138,25 +144,44 @@ PlasmaShellSurface::Private::Private(PlasmaShellSurface *q)
     : role(PlasmaShellSurface::Role::Normal)
     , q(q)
 {
-    s_surfaces << this;
 }
 
 PlasmaShellSurface::Private::~Private()
 {
-    s_surfaces.removeAll(this);
+    forgetParentSurface();
 }
 
-PlasmaShellSurface *PlasmaShellSurface::Private::get(Surface *surface)
+void PlasmaShellSurface::Private::setParentSurface(Surface *surface)
 {
+    forgetParentSurface();
+    parentSurface = QPointer<Surface>(surface);
     if (!surface) {
-        return nullptr;
+        return;
     }
-    for (auto it = s_surfaces.constBegin(); it != s_surfaces.constEnd(); ++it) {
-        if ((*it)->parentSurface == surface) {
-            return (*it)->q;
-        }
+    s_surfaces.insert(surface, this);
+    // the address may be reused by another Surface once this one is gone
+    QObject::connect(surface, &QObject::destroyed, q, [this, surface]() {
+        s_surfaces.remove(surface, this);
+    });
+}
+
+void PlasmaShellSurface::Private::forgetParentSurface()
+{
+    if (!parentSurface) {
+        return;
     }
-    return nullptr;
+    QObject::disconnect(parentSurface, &QObject::destroyed, q, nullptr);
+    s_surfaces.remove(parentSurface, this);
+}
+
+PlasmaShellSurface *PlasmaShellSurface::Private::get(Surface *surface)
+{
+    // The oldest shell surface of the surface is the last of the key.
+    Private *p = nullptr;
+    for (auto it = s_surfaces.constFind(surface); it != s_surfaces.constEnd() && it.key() == surface; ++it) {
+        p = it.value();
+    }
+    return p ? p->q : nullptr;
 }
 
 void PlasmaShellSurface::Private::setup(org_kde_plasma_surface *s)
@@ -5,14 +5,17 @@
 */
 #include "plasmawindowmanagement.h"
 #include "event_queue.h"
+#include "logging.h"
 #include "output.h"
 #include "plasmavirtualdesktop.h"
 #include "plasmawindowmodel.h"
 #include "surface.h"
 #include "wayland_pointer_p.h"
 // Wayland
+#include <wayland-dde-plasma-window-management-client-protocol.h>
 #include <wayland-plasma-window-management-client-protocol.h>
 
+#include <QCache>
 #include <QFutureWatcher>
 #include <QTimer>
 #include <QtConcurrentRun>
@@ -35,8 +38,17 @@ public:
     PlasmaWindow *activeWindow = nullptr;
     QVector<quint32> stackingOrder;
     QVector<QByteArray> stackingOrderUuids;
+    WaylandPointer<dde_plasma_window_management, dde_plasma_window_management_destroy> extension;
+    WaylandPointer<dde_plasma_stacking_order, dde_plasma_stacking_order_destroy> stackingOrderDeltas;
+    bool stackingOrderUuidsDirty = false;
+    // Icons by content hash. Most windows of an application have the same icon, so the
+    // cache does not need to be large.
+    QCache<QByteArray, QIcon> iconCache;
+    // Windows waiting for an icon which is being fetched already, by hash.
+    QHash<QByteArray, QVector<QPointer<PlasmaWindow>>> pendingIcons;
 
     void setup(org_kde_plasma_window_management *wm);
+    void setupExtension(dde_plasma_window_management *extension);
 
 private:
     static void showDesktopCallback(void *data, org_kde_plasma_window_management *org_kde_plasma_window_management, uint32_t state);
@@ -48,8 +60,17 @@ private:
     void windowCreated(org_kde_plasma_window *id, quint32 internalId, const char *uuid);
     void setStackingOrder(const QVector<quint32> &ids);
     void setStackingOrder(const QVector<QByteArray> &uuids);
+    void setupStackingOrderDeltas();
+    void placeInStackingOrder(const char *uuid, const char *sibling);
+
+    static void stackingOrderResetCallback(void *data, dde_plasma_stacking_order *dde_plasma_stacking_order);
+    static void stackingOrderInsertCallback(void *data, dde_plasma_stacking_order *dde_plasma_stacking_order, const char *uuid, const char *sibling);
+    static void stackingOrderMoveCallback(void *data, dde_plasma_stacking_order *dde_plasma_stacking_order, const char *uuid, const char *sibling);
+    static void stackingOrderRemoveCallback(void *data, dde_plasma_stacking_order *dde_plasma_stacking_order, const char *uuid);
+    static void stackingOrderDoneCallback(void *data, dde_plasma_stacking_order *dde_plasma_stacking_order);
 
     static struct org_kde_plasma_window_management_listener s_listener;
+    static struct dde_plasma_stacking_order_listener s_stackingOrderListener;
     PlasmaWindowManagement *q;
 };
 
@@ -94,8 +115,14 @@ public:
     QString applicationMenuServiceName;
     QString applicationMenuObjectPath;
     quint32 windowId = 0;
+    WaylandPointer<dde_plasma_window, dde_plasma_window_destroy> extension;
+    QByteArray iconHash;
+
+    void setupExtension(dde_plasma_window *windowExtension, EventQueue *queue);
 
 private:
+    static void iconHashCallback(void *data, dde_plasma_window *dde_plasma_window, const char *hash);
+    static void doneCallback(void *data, dde_plasma_window *dde_plasma_window);
     static void titleChangedCallback(void *data, org_kde_plasma_window *window, const char *title);
     static void appIdChangedCallback(void *data, org_kde_plasma_window *window, const char *app_id);
     static void pidChangedCallback(void *data, org_kde_plasma_window *window, uint32_t pid);
@@ -134,6 +161,10 @@ private:
     void setVirtualDesktopChangeable(bool set);
     void setParentWindow(PlasmaWindow *parentWindow);
     void setPid(const quint32 pid);
+    void fetchIcon();
+    void setFetchedIcon(const QIcon &icon);
+    bool groupsUpdates() const;
+    void updated();
 
     static Private *cast(void *data)
     {
@@ -143,10 +174,14 @@ private:
     PlasmaWindow *q;
 
     static struct org_kde_plasma_window_listener s_listener;
+    static struct dde_plasma_window_listener s_extensionListener;
 };
 
+static const int s_iconCacheSize = 64;
+
 PlasmaWindowManagement::Private::Private(PlasmaWindowManagement *q)
-    : q(q)
+    : iconCache(s_iconCacheSize)
+    , q(q)
 {
 }
 
@@ -164,6 +199,97 @@ void PlasmaWindowManagement::Private::setup(org_kde_plasma_window_management *wi
     Q_ASSERT(windowManagement);
     wm.setup(windowManagement);
     org_kde_plasma_window_management_add_listener(windowManagement, &s_listener, this);
+    if (extension) {
+        setupStackingOrderDeltas();
+    }
+}
+
+void PlasmaWindowManagement::Private::setupExtension(dde_plasma_window_management *windowManagementExtension)
+{
+    Q_ASSERT(!extension);
+    Q_ASSERT(windowManagementExtension);
+    extension.setup(windowManagementExtension);
+    if (wm) {
+        setupStackingOrderDeltas();
+    }
+}
+
+dde_plasma_stacking_order_listener PlasmaWindowManagement::Private::s_stackingOrderListener = {
+    stackingOrderResetCallback,
+    stackingOrderInsertCallback,
+    stackingOrderMoveCallback,
+    stackingOrderRemoveCallback,
+    stackingOrderDoneCallback,
+};
+
+void PlasmaWindowManagement::Private::setupStackingOrderDeltas()
+{
+    // From now on the compositor sends the changes of the stacking order instead of
+    // stacking_order_uuid_changed, starting with a reset to the current order.
+    stackingOrderDeltas.setup(dde_plasma_window_management_get_stacking_order(extension, wm));
+    if (queue) {
+        queue->addProxy(stackingOrderDeltas);
+    }
+    dde_plasma_stacking_order_add_listener(stackingOrderDeltas, &s_stackingOrderListener, this);
+}
+
+void PlasmaWindowManagement::Private::placeInStackingOrder(const char *uuid, const char *sibling)
+{
+    int index = 0;
+    if (*sibling) {
+        index = stackingOrderUuids.indexOf(QByteArray::fromRawData(sibling, qstrlen(sibling))) + 1;
+        if (index == 0) {
+            qCWarning(KWAYLAND_CLIENT) << "Unknown stacking order sibling" << sibling;
+            index = stackingOrderUuids.size();
+        }
+    }
+    stackingOrderUuids.insert(index, QByteArray(uuid));
+    stackingOrderUuidsDirty = true;
+}
+
+void PlasmaWindowManagement::Private::stackingOrderResetCallback(void *data, dde_plasma_stacking_order *deltas)
+{
+    auto wm = reinterpret_cast<PlasmaWindowManagement::Private *>(data);
+    Q_ASSERT(wm->stackingOrderDeltas == deltas);
+    if (!wm->stackingOrderUuids.isEmpty()) {
+        wm->stackingOrderUuids.clear();
+        wm->stackingOrderUuidsDirty = true;
+    }
+}
+
+void PlasmaWindowManagement::Private::stackingOrderInsertCallback(void *data, dde_plasma_stacking_order *deltas, const char *uuid, const char *sibling)
+{
+    auto wm = reinterpret_cast<PlasmaWindowManagement::Private *>(data);
+    Q_ASSERT(wm->stackingOrderDeltas == deltas);
+    wm->placeInStackingOrder(uuid, sibling);
+}
+
+void PlasmaWindowManagement::Private::stackingOrderMoveCallback(void *data, dde_plasma_stacking_order *deltas, const char *uuid, const char *sibling)
+{
+    auto wm = reinterpret_cast<PlasmaWindowManagement::Private *>(data);
+    Q_ASSERT(wm->stackingOrderDeltas == deltas);
+    wm->stackingOrderUuids.removeOne(QByteArray::fromRawData(uuid, qstrlen(uuid)));
+    wm->placeInStackingOrder(uuid, sibling);
+}
+
+void PlasmaWindowManagement::Private::stackingOrderRemoveCallback(void *data, dde_plasma_stacking_order *deltas, const char *uuid)
+{
+    auto wm = reinterpret_cast<PlasmaWindowManagement::Private *>(data);
+    Q_ASSERT(wm->stackingOrderDeltas == deltas);
+    if (wm->stackingOrderUuids.removeOne(QByteArray::fromRawData(uuid, qstrlen(uuid)))) {
+        wm->stackingOrderUuidsDirty = true;
+    }
+}
+
+void PlasmaWindowManagement::Private::stackingOrderDoneCallback(void *data, dde_plasma_stacking_order *deltas)
+{
+    auto wm = reinterpret_cast<PlasmaWindowManagement::Private *>(data);
+    Q_ASSERT(wm->stackingOrderDeltas == deltas);
+    if (!wm->stackingOrderUuidsDirty) {
+        return;
+    }
+    wm->stackingOrderUuidsDirty = false;
+    Q_EMIT wm->q->stackingOrderUuidsChanged();
 }
 
 void PlasmaWindowManagement::Private::showDesktopCallback(void *data, org_kde_plasma_window_management *org_kde_plasma_window_management, uint32_t state)
@@ -238,6 +364,10 @@ void PlasmaWindowManagement::Private::windowCreated(org_kde_plasma_window *id, q
     }
     PlasmaWindow *window = new PlasmaWindow(q, id, internalId, uuid);
     window->d->wm = q;
+    if (extension && dde_plasma_window_management_get_version(extension) >= DDE_PLASMA_WINDOW_MANAGEMENT_GET_WINDOW_SINCE_VERSION) {
+        // Before any event of the window is dispatched, see iconChangedCallback.
+        window->d->setupExtension(dde_plasma_window_management_get_window(extension, id), queue);
+    }
     windows << window;
     QObject::connect(window, &QObject::destroyed, q, [this, window] {
         windows.removeAll(window);
@@ -320,6 +450,8 @@ void PlasmaWindowManagement::destroy()
         return;
     }
     Q_EMIT interfaceAboutToBeDestroyed();
+    d->stackingOrderDeltas.destroy();
+    d->extension.destroy();
     d->wm.destroy();
 }
 
@@ -329,6 +461,8 @@ void PlasmaWindowManagement::release()
         return;
     }
     Q_EMIT interfaceAboutToBeReleased();
+    d->stackingOrderDeltas.release();
+    d->extension.release();
     d->wm.release();
 }
 
@@ -337,6 +471,11 @@ void PlasmaWindowManagement::setup(org_kde_plasma_window_management *wm)
     d->setup(wm);
 }
 
+void PlasmaWindowManagement::setupExtension(dde_plasma_window_management *extension)
+{
+    d->setupExtension(extension);
+}
+
 void PlasmaWindowManagement::setEventQueue(EventQueue *queue)
 {
     d->queue = queue;
@@ -439,6 +578,7 @@ void PlasmaWindow::Private::appmenuChangedCallback(void *data, org_kde_plasma_wi
     p->applicationMenuObjectPath = QString::fromUtf8(object_path);
 
     Q_EMIT p->q->applicationMenuChanged();
+    p->updated();
 }
 
 void PlasmaWindow::Private::parentWindowCallback(void *data, org_kde_plasma_window *window, org_kde_plasma_window *parent)
@@ -462,6 +602,7 @@ void PlasmaWindow::Private::windowGeometryCallback(void *data, org_kde_plasma_wi
     }
     p->geometry = geo;
     Q_EMIT p->q->geometryChanged();
+    p->updated();
 }
 
 void PlasmaWindow::Private::setParentWindow(PlasmaWindow *parent)
@@ -479,6 +620,7 @@ void PlasmaWindow::Private::setParentWindow(PlasmaWindow *parent)
     }
     if (parentWindow.data() != old.data()) {
         Q_EMIT q->parentWindowChanged();
+        Q_EMIT q->changed();
     }
 }
 
@@ -501,6 +643,7 @@ void PlasmaWindow::Private::titleChangedCallback(void *data, org_kde_plasma_wind
     }
     p->title = t;
     Q_EMIT p->q->titleChanged();
+    p->updated();
 }
 
 void PlasmaWindow::Private::appIdChangedCallback(void *data, org_kde_plasma_window *window, const char *appId)
@@ -513,6 +656,7 @@ void PlasmaWindow::Private::appIdChangedCallback(void *data, org_kde_plasma_wind
     }
     p->appId = s;
     Q_EMIT p->q->appIdChanged();
+    p->updated();
 }
 
 void PlasmaWindow::Private::pidChangedCallback(void *data, org_kde_plasma_window *window, uint32_t pid)
@@ -534,6 +678,7 @@ void PlasmaWindow::Private::virtualDesktopChangedCallback(void *data, org_kde_pl
     }
     p->desktop = number;
     Q_EMIT p->q->virtualDesktopChanged();
+    Q_EMIT p->q->changed();
 }
 
 void PlasmaWindow::Private::unmappedCallback(void *data, org_kde_plasma_window *window)
@@ -555,6 +700,7 @@ void PlasmaWindow::Private::virtualDesktopEnteredCallback(void *data, org_kde_pl
     if (p->plasmaVirtualDesktops.count() == 1) {
         Q_EMIT p->q->onAllDesktopsChanged();
     }
+    Q_EMIT p->q->changed();
 }
 
 void PlasmaWindow::Private::virtualDesktopLeftCallback(void *data, org_kde_plasma_window *window, const char *id)
@@ -567,6 +713,7 @@ void PlasmaWindow::Private::virtualDesktopLeftCallback(void *data, org_kde_plasm
     if (p->plasmaVirtualDesktops.isEmpty()) {
         Q_EMIT p->q->onAllDesktopsChanged();
     }
+    Q_EMIT p->q->changed();
 }
 
 void PlasmaWindow::Private::activityEnteredCallback(void *data, org_kde_plasma_window *window, const char *id)
@@ -576,6 +723,7 @@ void PlasmaWindow::Private::activityEnteredCallback(void *data, org_kde_plasma_w
     const QString stringId(QString::fromUtf8(id));
     p->plasmaActivities << stringId;
     Q_EMIT p->q->plasmaActivityEntered(stringId);
+    Q_EMIT p->q->changed();
 }
 
 void PlasmaWindow::Private::activityLeftCallback(void *data, org_kde_plasma_window *window, const char *id)
@@ -585,6 +733,7 @@ void PlasmaWindow::Private::activityLeftCallback(void *data, org_kde_plasma_wind
     const QString stringId(QString::fromUtf8(id));
     p->plasmaActivities.removeAll(stringId);
     Q_EMIT p->q->plasmaActivityLeft(stringId);
+    Q_EMIT p->q->changed();
 }
 
 void PlasmaWindow::Private::windowIdCallback(void *data, org_kde_plasma_window *window, uint32_t winid)
@@ -617,6 +766,7 @@ void PlasmaWindow::Private::stateChangedCallback(void *data, org_kde_plasma_wind
     p->setMovable(state & ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STATE_MOVABLE);
     p->setResizable(state & ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STATE_RESIZABLE);
     p->setVirtualDesktopChangeable(state & ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STATE_VIRTUAL_DESKTOP_CHANGEABLE);
+    p->updated();
 }
 
 void PlasmaWindow::Private::themedIconNameChangedCallback(void *data, org_kde_plasma_window *window, const char *name)
@@ -631,6 +781,7 @@ void PlasmaWindow::Private::themedIconNameChangedCallback(void *data, org_kde_pl
         p->icon = QIcon();
     }
     Q_EMIT p->q->iconChanged();
+    p->updated();
 }
 
 static int readData(int fd, QByteArray &data)
@@ -654,15 +805,101 @@ static int readData(int fd, QByteArray &data)
     return n;
 }
 
+void PlasmaWindow::Private::setupExtension(dde_plasma_window *windowExtension, EventQueue *queue)
+{
+    Q_ASSERT(!extension);
+    extension.setup(windowExtension);
+    if (queue) {
+        queue->addProxy(windowExtension);
+    }
+    dde_plasma_window_add_listener(windowExtension, &s_extensionListener, this);
+}
+
+dde_plasma_window_listener PlasmaWindow::Private::s_extensionListener = {
+    iconHashCallback,
+    doneCallback,
+};
+
+bool PlasmaWindow::Private::groupsUpdates() const
+{
+    return extension && dde_plasma_window_get_version(extension) >= DDE_PLASMA_WINDOW_DONE_SINCE_VERSION;
+}
+
+void PlasmaWindow::Private::updated()
+{
+    // Otherwise the done event follows.
+    if (!groupsUpdates()) {
+        Q_EMIT q->changed();
+    }
+}
+
+void PlasmaWindow::Private::doneCallback(void *data, dde_plasma_window *dde_plasma_window)
+{
+    auto p = cast(data);
+    Q_ASSERT(p->extension == dde_plasma_window);
+    Q_EMIT p->q->changed();
+}
+
+void PlasmaWindow::Private::iconHashCallback(void *data, dde_plasma_window *dde_plasma_window, const char *hash)
+{
+    auto p = cast(data);
+    Q_ASSERT(p->extension == dde_plasma_window);
+    p->iconHash = QByteArray(hash);
+    if (p->iconHash.isEmpty()) {
+        // The window has no icon, there is nothing to fetch.
+        p->icon = QIcon::fromTheme(QStringLiteral("wayland"));
+        Q_EMIT p->q->iconChanged();
+        p->updated();
+        return;
+    }
+    auto wm = p->wm->d.data();
+    if (QIcon *icon = wm->iconCache.object(p->iconHash)) {
+        p->icon = *icon;
+        Q_EMIT p->q->iconChanged();
+        p->updated();
+        return;
+    }
+    auto it = wm->pendingIcons.find(p->iconHash);
+    if (it != wm->pendingIcons.end()) {
+        it->append(QPointer<PlasmaWindow>(p->q));
+        return;
+    }
+    wm->pendingIcons.insert(p->iconHash, {QPointer<PlasmaWindow>(p->q)});
+    p->fetchIcon();
+}
+
 void PlasmaWindow::Private::iconChangedCallback(void *data, org_kde_plasma_window *window)
 {
     auto p = cast(data);
     Q_UNUSED(window);
+    if (p->extension) {
+        // Followed by dde_plasma_window.icon if the window has an icon.
+        return;
+    }
+    p->iconHash.clear();
+    p->fetchIcon();
+}
+
+void PlasmaWindow::Private::setFetchedIcon(const QIcon &fetchedIcon)
+{
+    if (!fetchedIcon.isNull()) {
+        icon = fetchedIcon;
+    } else {
+        icon = QIcon::fromTheme(QStringLiteral("wayland"));
+    }
+    Q_EMIT q->iconChanged();
+    Q_EMIT q->changed();
+}
+
+void PlasmaWindow::Private::fetchIcon()
+{
+    auto p = this;
     int pipeFds[2];
     if (pipe2(pipeFds, O_CLOEXEC | O_NONBLOCK) != 0) {
+        wm->d->pendingIcons.remove(iconHash);
         return;
     }
-    org_kde_plasma_window_get_icon(p->window, pipeFds[1]);
+    org_kde_plasma_window_get_icon(window, pipeFds[1]);
     close(pipeFds[1]);
     const int pipeFd = pipeFds[0];
     auto readIcon = [pipeFd]() -> QIcon {
@@ -677,16 +914,32 @@ void PlasmaWindow::Private::iconChangedCallback(void *data, org_kde_plasma_windo
         ds >> icon;
         return icon;
     };
-    QFutureWatcher<QIcon> *watcher = new QFutureWatcher<QIcon>(p->q);
-    QObject::connect(watcher, &QFutureWatcher<QIcon>::finished, p->q, [p, watcher] {
+    const QByteArray hash = p->iconHash;
+    if (hash.isEmpty()) {
+        QFutureWatcher<QIcon> *watcher = new QFutureWatcher<QIcon>(p->q);
+        QObject::connect(watcher, &QFutureWatcher<QIcon>::finished, p->q, [p, watcher] {
+            watcher->deleteLater();
+            p->setFetchedIcon(watcher->result());
+        });
+        watcher->setFuture(QtConcurrent::run(readIcon));
+        return;
+    }
+
+    // Other windows might be waiting for this icon, so it must not go away with this window.
+    QFutureWatcher<QIcon> *watcher = new QFutureWatcher<QIcon>(p->wm);
+    auto wmPrivate = p->wm->d.data();
+    QObject::connect(watcher, &QFutureWatcher<QIcon>::finished, watcher, [watcher, wmPrivate, hash] {
         watcher->deleteLater();
-        QIcon icon = watcher->result();
+        const QIcon icon = watcher->result();
         if (!icon.isNull()) {
-            p->icon = icon;
-        } else {
-            p->icon = QIcon::fromTheme(QStringLiteral("wayland"));
+            wmPrivate->iconCache.insert(hash, new QIcon(icon));
+        }
+        const auto windows = wmPrivate->pendingIcons.take(hash);
+        for (const QPointer<PlasmaWindow> &window : windows) {
+            if (window && window->d->iconHash == hash) {
+                window->d->setFetchedIcon(icon);
+            }
         }
-        Q_EMIT p->q->iconChanged();
     });
     watcher->setFuture(QtConcurrent::run(readIcon));
 }
@@ -885,11 +1138,13 @@ PlasmaWindow::~PlasmaWindow()
 
 void PlasmaWindow::destroy()
 {
+    d->extension.destroy();
     d->window.destroy();
 }
 
 void PlasmaWindow::release()
 {
+    d->extension.release();
     d->window.release();
 }
 
@@ -16,6 +16,7 @@ struct org_kde_plasma_activation_feedback;
 struct org_kde_plasma_activation;
 struct org_kde_plasma_window_management;
 struct org_kde_plasma_window;
+struct dde_plasma_window_management;
 
 namespace KWayland
 {
@@ -102,6 +103,14 @@ public:
      * method.
      **/
     void setup(org_kde_plasma_window_management *shell);
+    /**
+     * Uses the dde_plasma_window_management @p extension, so that the compositor only sends
+     * the changes of the stacking order instead of the complete list. Takes ownership
+     * of @p extension.
+     * When using Registry::createPlasmaWindowManagement there is no need to call this
+     * method, it's called as soon as the compositor announces the extension.
+     **/
+    void setupExtension(dde_plasma_window_management *extension);
 
     /**
      * Sets the @p queue to use for creating a Surface.
@@ -232,6 +241,7 @@ public:
     class Private;
 
 private:
+    friend class PlasmaWindow;
     QScopedPointer<Private> d;
 };
 
@@ -800,6 +810,16 @@ Q_SIGNALS:
      **/
     void applicationMenuChanged();
 
+    /**
+     * This signal is emitted after an update of the window was applied, the signals of
+     * the individual properties have been emitted before.
+     *
+     * If the compositor groups the changes, e.g. because a window got maximized and
+     * activated at the same time, this is emitted once for the whole group. Otherwise it
+     * is emitted once per change.
+     **/
+    void changed();
+
 private:
     friend class PlasmaWindowManagement;
     explicit PlasmaWindow(PlasmaWindowManagement *parent, org_kde_plasma_window *activation, quint32 internalId, const char *uuid);
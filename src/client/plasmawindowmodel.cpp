@@ -7,6 +7,9 @@
 #include "plasmawindowmanagement.h"
 
 #include <QMetaEnum>
+#include <QSet>
+
+#include <algorithm>
 
 namespace KWayland
 {
@@ -17,10 +20,20 @@ class Q_DECL_HIDDEN PlasmaWindowModel::Private
 public:
     Private(PlasmaWindowModel *q);
     QList<PlasmaWindow *> windows;
+    QHash<PlasmaWindow *, int> rows;
     PlasmaWindow *window = nullptr;
+    // Roles changed per window, not yet announced through dataChanged.
+    QHash<PlasmaWindow *, QVector<int>> changedRoles;
+    // Windows done with an update since the last flushChangedRoles.
+    QSet<PlasmaWindow *> changedWindows;
+    bool flushScheduled = false;
 
     void addWindow(PlasmaWindow *window);
+    void removeWindow(PlasmaWindow *window);
     void dataChanged(PlasmaWindow *window, int role);
+    void windowChanged(PlasmaWindow *window);
+    void flushChangedRoles();
+    void clear();
 
 private:
     PlasmaWindowModel *q;
@@ -33,27 +46,27 @@ PlasmaWindowModel::Private::Private(PlasmaWindowModel *q)
 
 void PlasmaWindowModel::Private::addWindow(PlasmaWindow *window)
 {
-    if (windows.indexOf(window) != -1) {
+    if (rows.contains(window)) {
         return;
     }
 
     const int count = windows.count();
     q->beginInsertRows(QModelIndex(), count, count);
     windows.append(window);
+    rows.insert(window, count);
     q->endInsertRows();
 
     auto removeWindow = [window, this] {
-        const int row = windows.indexOf(window);
-        if (row != -1) {
-            q->beginRemoveRows(QModelIndex(), row, row);
-            windows.removeAt(row);
-            q->endRemoveRows();
-        }
+        this->removeWindow(window);
     };
 
     QObject::connect(window, &PlasmaWindow::unmapped, q, removeWindow);
     QObject::connect(window, &QObject::destroyed, q, removeWindow);
 
+    QObject::connect(window, &PlasmaWindow::changed, q, [window, this] {
+        this->windowChanged(window);
+    });
+
     QObject::connect(window, &PlasmaWindow::titleChanged, q, [window, this] {
         this->dataChanged(window, Qt::DisplayRole);
     });
@@ -159,10 +172,99 @@ void PlasmaWindowModel::Private::addWindow(PlasmaWindow *window)
     });
 }
 
+void PlasmaWindowModel::Private::removeWindow(PlasmaWindow *window)
+{
+    const auto it = rows.find(window);
+    if (it == rows.end()) {
+        return;
+    }
+    const int row = *it;
+    q->beginRemoveRows(QModelIndex(), row, row);
+    windows.removeAt(row);
+    rows.erase(it);
+    for (int i = row; i < windows.count(); ++i) {
+        rows[windows.at(i)] = i;
+    }
+    q->endRemoveRows();
+    changedRoles.remove(window);
+    changedWindows.remove(window);
+}
+
+void PlasmaWindowModel::Private::clear()
+{
+    windows.clear();
+    rows.clear();
+    changedRoles.clear();
+    changedWindows.clear();
+}
+
 void PlasmaWindowModel::Private::dataChanged(PlasmaWindow *window, int role)
 {
-    QModelIndex idx = q->index(windows.indexOf(window));
-    Q_EMIT q->dataChanged(idx, idx, QVector<int>() << role);
+    // Announced once the window is done with the update, see windowChanged.
+    QVector<int> &roles = changedRoles[window];
+    if (!roles.contains(role)) {
+        roles.append(role);
+    }
+}
+
+void PlasmaWindowModel::Private::windowChanged(PlasmaWindow *window)
+{
+    if (!changedRoles.contains(window) || changedWindows.contains(window)) {
+        return;
+    }
+    changedWindows.insert(window);
+    // All updates read from the connection in one go end up in one dataChanged per range.
+    if (!flushScheduled) {
+        flushScheduled = true;
+        QMetaObject::invokeMethod(
+            q,
+            [this] {
+                flushChangedRoles();
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+void PlasmaWindowModel::Private::flushChangedRoles()
+{
+    flushScheduled = false;
+    if (changedWindows.isEmpty()) {
+        return;
+    }
+
+    struct Change {
+        int row;
+        QVector<int> roles;
+    };
+    QVector<Change> changes;
+    changes.reserve(changedWindows.count());
+    for (PlasmaWindow *window : qAsConst(changedWindows)) {
+        changes.append({rows.value(window), changedRoles.take(window)});
+    }
+    changedWindows.clear();
+    std::sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) {
+        return a.row < b.row;
+    });
+
+    // Adjacent rows are merged into one range with the roles of all of them.
+    int first = changes.first().row;
+    int last = first;
+    QVector<int> roles = changes.first().roles;
+    for (int i = 1; i < changes.count(); ++i) {
+        const Change &change = changes.at(i);
+        if (change.row != last + 1) {
+            Q_EMIT q->dataChanged(q->index(first), q->index(last), roles);
+            first = change.row;
+            roles.clear();
+        }
+        last = change.row;
+        for (int role : change.roles) {
+            if (!roles.contains(role)) {
+                roles.append(role);
+            }
+        }
+    }
+    Q_EMIT q->dataChanged(q->index(first), q->index(last), roles);
 }
 
 PlasmaWindowModel::PlasmaWindowModel(PlasmaWindowManagement *parent)
@@ -171,7 +273,7 @@ PlasmaWindowModel::PlasmaWindowModel(PlasmaWindowManagement *parent)
 {
     connect(parent, &PlasmaWindowManagement::interfaceAboutToBeReleased, this, [this] {
         beginResetModel();
-        d->windows.clear();
+        d->clear();
         endResetModel();
     });
 
@@ -0,0 +1,249 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#include "presentationtime.h"
+#include "event_queue.h"
+#include "output.h"
+#include "surface.h"
+#include "wayland_pointer_p.h"
+
+#include <wayland-presentation-time-client-protocol.h>
+
+namespace KWayland
+{
+namespace Client
+{
+class Q_DECL_HIDDEN PresentationTime::Private
+{
+public:
+    explicit Private(PresentationTime *q);
+    void setup(wp_presentation *arg);
+
+    WaylandPointer<wp_presentation, wp_presentation_destroy> presentation;
+    EventQueue *queue = nullptr;
+    clockid_t clockId = CLOCK_MONOTONIC;
+
+private:
+    static void clockIdCallback(void *data, wp_presentation *wp_presentation, uint32_t clk_id);
+    static const struct wp_presentation_listener s_listener;
+
+    PresentationTime *q;
+};
+
+const wp_presentation_listener PresentationTime::Private::s_listener = {clockIdCallback};
+
+void PresentationTime::Private::clockIdCallback(void *data, wp_presentation *wp_presentation, uint32_t clk_id)
+{
+    Q_UNUSED(wp_presentation)
+    auto p = reinterpret_cast<Private *>(data);
+    if (p->clockId == clockid_t(clk_id)) {
+        return;
+    }
+    p->clockId = clk_id;
+    Q_EMIT p->q->clockIdChanged(p->clockId);
+}
+
+PresentationTime::Private::Private(PresentationTime *q)
+    : q(q)
+{
+}
+
+void PresentationTime::Private::setup(wp_presentation *arg)
+{
+    Q_ASSERT(arg);
+    Q_ASSERT(!presentation);
+    presentation.setup(arg);
+    wp_presentation_add_listener(presentation, &s_listener, this);
+}
+
+PresentationTime::PresentationTime(QObject *parent)
+    : QObject(parent)
+    , d(new Private(this))
+{
+}
+
+PresentationTime::~PresentationTime()
+{
+    release();
+}
+
+void PresentationTime::setup(wp_presentation *presentation)
+{
+    d->setup(presentation);
+}
+
+void PresentationTime::release()
+{
+    d->presentation.release();
+}
+
+void PresentationTime::destroy()
+{
+    d->presentation.destroy();
+}
+
+PresentationTime::operator wp_presentation *()
+{
+    return d->presentation;
+}
+
+PresentationTime::operator wp_presentation *() const
+{
+    return d->presentation;
+}
+
+bool PresentationTime::isValid() const
+{
+    return d->presentation.isValid();
+}
+
+void PresentationTime::setEventQueue(EventQueue *queue)
+{
+    d->queue = queue;
+}
+
+EventQueue *PresentationTime::eventQueue()
+{
+    return d->queue;
+}
+
+clockid_t PresentationTime::clockId() const
+{
+    return d->clockId;
+}
+
+PresentationFeedback *PresentationTime::createFeedback(Surface *surface, QObject *parent)
+{
+    Q_ASSERT(isValid());
+    auto p = new PresentationFeedback(parent);
+    auto w = wp_presentation_feedback(d->presentation, *surface);
+    if (d->queue) {
+        d->queue->addProxy(w);
+    }
+    p->setup(w);
+    return p;
+}
+
+class Q_DECL_HIDDEN PresentationFeedback::Private
+{
+public:
+    explicit Private(PresentationFeedback *q);
+    void setup(wp_presentation_feedback *arg);
+
+    WaylandPointer<wp_presentation_feedback, wp_presentation_feedback_destroy> feedback;
+
+private:
+    static void syncOutputCallback(void *data, wp_presentation_feedback *wp_presentation_feedback, wl_output *output);
+    static void presentedCallback(void *data,
+                                  wp_presentation_feedback *wp_presentation_feedback,
+                                  uint32_t tv_sec_hi,
+                                  uint32_t tv_sec_lo,
+                                  uint32_t tv_nsec,
+                                  uint32_t refresh,
+                                  uint32_t seq_hi,
+                                  uint32_t seq_lo,
+                                  uint32_t flags);
+    static void discardedCallback(void *data, wp_presentation_feedback *wp_presentation_feedback);
+    static const struct wp_presentation_feedback_listener s_listener;
+
+    PresentationFeedback *q;
+};
+
+const wp_presentation_feedback_listener PresentationFeedback::Private::s_listener = {
+    syncOutputCallback,
+    presentedCallback,
+    discardedCallback,
+};
+
+void PresentationFeedback::Private::syncOutputCallback(void *data, wp_presentation_feedback *wp_presentation_feedback, wl_output *output)
+{
+    Q_UNUSED(wp_presentation_feedback)
+    auto p = reinterpret_cast<Private *>(data);
+    Q_EMIT p->q->syncOutput(Output::get(output));
+}
+
+void PresentationFeedback::Private::presentedCallback(void *data,
+                                                      wp_presentation_feedback *wp_presentation_feedback,
+                                                      uint32_t tv_sec_hi,
+                                                      uint32_t tv_sec_lo,
+                                                      uint32_t tv_nsec,
+                                                      uint32_t refresh,
+                                                      uint32_t seq_hi,
+                                                      uint32_t seq_lo,
+                                                      uint32_t flags)
+{
+    Q_UNUSED(wp_presentation_feedback)
+    auto p = reinterpret_cast<Private *>(data);
+    // the server destroyed the object after sending the event
+    p->feedback.release();
+    const std::chrono::seconds seconds((quint64(tv_sec_hi) << 32) | tv_sec_lo);
+    const quint64 sequence = (quint64(seq_hi) << 32) | seq_lo;
+    Q_EMIT p->q->presented(seconds + std::chrono::nanoseconds(tv_nsec), std::chrono::nanoseconds(refresh), sequence, Kinds(int(flags)));
+}
+
+void PresentationFeedback::Private::discardedCallback(void *data, wp_presentation_feedback *wp_presentation_feedback)
+{
+    Q_UNUSED(wp_presentation_feedback)
+    auto p = reinterpret_cast<Private *>(data);
+    p->feedback.release();
+    Q_EMIT p->q->discarded();
+}
+
+PresentationFeedback::Private::Private(PresentationFeedback *q)
+    : q(q)
+{
+}
+
+void PresentationFeedback::Private::setup(wp_presentation_feedback *arg)
+{
+    Q_ASSERT(arg);
+    Q_ASSERT(!feedback);
+    feedback.setup(arg);
+    wp_presentation_feedback_add_listener(feedback, &s_listener, this);
+}
+
+PresentationFeedback::PresentationFeedback(QObject *parent)
+    : QObject(parent)
+    , d(new Private(this))
+{
+}
+
+PresentationFeedback::~PresentationFeedback()
+{
+    release();
+}
+
+void PresentationFeedback::setup(wp_presentation_feedback *feedback)
+{
+    d->setup(feedback);
+}
+
+void PresentationFeedback::release()
+{
+    d->feedback.release();
+}
+
+void PresentationFeedback::destroy()
+{
+    d->feedback.destroy();
+}
+
+PresentationFeedback::operator wp_presentation_feedback *()
+{
+    return d->feedback;
+}
+
+PresentationFeedback::operator wp_presentation_feedback *() const
+{
+    return d->feedback;
+}
+
+bool PresentationFeedback::isValid() const
+{
+    return d->feedback.isValid();
+}
+
+}
+}
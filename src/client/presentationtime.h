@@ -0,0 +1,238 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#ifndef KWAYLAND_CLIENT_PRESENTATIONTIME_H
+#define KWAYLAND_CLIENT_PRESENTATIONTIME_H
+
+#include <QObject>
+
+#include <DWayland/Client/kwaylandclient_export.h>
+
+#include <chrono>
+#include <time.h>
+
+struct wp_presentation;
+struct wp_presentation_feedback;
+
+namespace KWayland
+{
+namespace Client
+{
+class EventQueue;
+class Output;
+class PresentationFeedback;
+class Surface;
+
+/**
+ * @short Wrapper for the wp_presentation interface.
+ *
+ * This class provides a convenient wrapper for the wp_presentation interface.
+ *
+ * To use this class one needs to interact with the Registry. There are two
+ * possible ways to create the PresentationTime interface:
+ * @code
+ * PresentationTime *c = registry->createPresentationTime(name, version);
+ * @endcode
+ *
+ * This creates the PresentationTime and sets it up directly. As an alternative this
+ * can also be done in a more low level way:
+ * @code
+ * PresentationTime *c = new PresentationTime;
+ * c->setup(registry->bindPresentationTime(name, version));
+ * @endcode
+ *
+ * The PresentationTime can be used as a drop-in replacement for any wp_presentation
+ * pointer as it provides matching cast operators.
+ *
+ * @see Registry
+ **/
+class KWAYLANDCLIENT_EXPORT PresentationTime : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Creates a new PresentationTime.
+     * Note: after constructing the PresentationTime it is not yet valid and one needs
+     * to call setup. In order to get a ready to use PresentationTime prefer using
+     * Registry::createPresentationTime.
+     **/
+    explicit PresentationTime(QObject *parent = nullptr);
+    ~PresentationTime() override;
+
+    /**
+     * Setup this PresentationTime to manage the @p presentation.
+     * When using Registry::createPresentationTime there is no need to call this
+     * method.
+     **/
+    void setup(wp_presentation *presentation);
+    /**
+     * @returns @c true if managing a wp_presentation.
+     **/
+    bool isValid() const;
+    /**
+     * Releases the wp_presentation interface.
+     * After the interface has been released the PresentationTime instance is no
+     * longer valid and can be setup with another wp_presentation interface.
+     **/
+    void release();
+    /**
+     * Destroys the data held by this PresentationTime.
+     * This method is supposed to be used when the connection to the Wayland
+     * server goes away. If the connection is not valid anymore, it's not
+     * possible to call release anymore as that calls into the Wayland
+     * connection and the call would fail. This method cleans up the data, so
+     * that the instance can be deleted or set up to a new wp_presentation interface
+     * once there is a new connection available.
+     *
+     * It is suggested to connect this method to ConnectionThread::connectionDied:
+     * @code
+     * connect(connection, &ConnectionThread::connectionDied, presentationtime, &PresentationTime::destroy);
+     * @endcode
+     *
+     * @see release
+     **/
+    void destroy();
+
+    /**
+     * Sets the @p queue to use for creating objects with this PresentationTime.
+     **/
+    void setEventQueue(EventQueue *queue);
+    /**
+     * @returns The event queue to use for creating objects with this PresentationTime.
+     **/
+    EventQueue *eventQueue();
+
+    /**
+     * The clock the timestamps of PresentationFeedback::presented are based on.
+     * It is announced by the compositor right after binding, until then it is @c CLOCK_MONOTONIC.
+     * @see clockIdChanged
+     **/
+    clockid_t clockId() const;
+
+    /**
+     * Requests feedback for the next content update of @p surface, that is the content
+     * which gets committed next.
+     * @param surface The Surface whose next content update should be reported
+     * @param parent The parent object for the PresentationFeedback
+     * @returns The created PresentationFeedback
+     **/
+    PresentationFeedback *createFeedback(Surface *surface, QObject *parent = nullptr);
+
+    operator wp_presentation *();
+    operator wp_presentation *() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the compositor announced the clock it uses for the timestamps.
+     * @see clockId
+     **/
+    void clockIdChanged(clockid_t clockId);
+
+    /**
+     * The corresponding global for this interface on the Registry got removed.
+     *
+     * This signal gets only emitted if the PresentationTime got created by
+     * Registry::createPresentationTime
+     **/
+    void removed();
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+/**
+ * The PresentationFeedback reports when and where one content update of a Surface was shown.
+ *
+ * Zero or more syncOutput signals are followed by either presented or discarded. After that
+ * the compositor destroyed the wp_presentation_feedback and the PresentationFeedback is no
+ * longer valid, it can be deleted.
+ *
+ * @see PresentationTime
+ * @see Surface
+ **/
+class KWAYLANDCLIENT_EXPORT PresentationFeedback : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * How the content update was presented, see @c wp_presentation_feedback.kind.
+     **/
+    enum class Kind {
+        Vsync = 0x1, ///< the presentation was synchronized to the vertical retrace
+        HardwareClock = 0x2, ///< the timestamp comes from the display hardware
+        HardwareCompletion = 0x4, ///< the display hardware signalled the completion
+        ZeroCopy = 0x8, ///< the buffer was scanned out without a copy
+    };
+    Q_DECLARE_FLAGS(Kinds, Kind)
+
+    ~PresentationFeedback() override;
+
+    /**
+     * Setup this PresentationFeedback to manage the @p feedback.
+     * When using PresentationTime::createFeedback there is no need to call this
+     * method.
+     **/
+    void setup(wp_presentation_feedback *feedback);
+    /**
+     * @returns @c true if managing a wp_presentation_feedback.
+     **/
+    bool isValid() const;
+    /**
+     * Releases the wp_presentation_feedback interface.
+     * After the interface has been released the PresentationFeedback instance is no
+     * longer valid and can be setup with another wp_presentation_feedback interface.
+     **/
+    void release();
+    /**
+     * Destroys the data held by this PresentationFeedback.
+     * This method is supposed to be used when the connection to the Wayland
+     * server goes away. If the connection is not valid anymore, it's not
+     * possible to call release anymore as that calls into the Wayland
+     * connection and the call would fail. This method cleans up the data, so
+     * that the instance can be deleted or set up to a new wp_presentation_feedback interface
+     * once there is a new connection available.
+     *
+     * @see release
+     **/
+    void destroy();
+
+    operator wp_presentation_feedback *();
+    operator wp_presentation_feedback *() const;
+
+Q_SIGNALS:
+    /**
+     * The content update was shown on @p output. The Output is @c nullptr if the
+     * wl_output was not bound through an Output.
+     **/
+    void syncOutput(KWayland::Client::Output *output);
+    /**
+     * The content update was shown at @p timestamp, in the clock of PresentationTime::clockId.
+     * @param refresh the duration of a refresh cycle of the output, zero if unknown
+     * @param sequence the vertical retrace counter of the output, zero if unknown
+     **/
+    void presented(std::chrono::nanoseconds timestamp,
+                   std::chrono::nanoseconds refresh,
+                   quint64 sequence,
+                   KWayland::Client::PresentationFeedback::Kinds kinds);
+    /**
+     * The content update was never shown.
+     **/
+    void discarded();
+
+private:
+    friend class PresentationTime;
+    explicit PresentationFeedback(QObject *parent = nullptr);
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+}
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(KWayland::Client::PresentationFeedback::Kinds)
+Q_DECLARE_METATYPE(KWayland::Client::PresentationFeedback::Kinds)
+
+#endif
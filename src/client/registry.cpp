@@ -10,11 +10,13 @@
 #include "compositor.h"
 #include "connection_thread.h"
 #include "contrast.h"
+#include "cursorshape.h"
 #include "datacontroldevicemanager.h"
 #include "datadevicemanager.h"
 #include "dpms.h"
 #include "event_queue.h"
 #include "fakeinput.h"
+#include "fractionalscale.h"
 #include "fullscreen_shell.h"
 #include "idle.h"
 #include "idleinhibit.h"
@@ -31,6 +33,7 @@
 #include "plasmawindowmanagement.h"
 #include "pointerconstraints.h"
 #include "pointergestures.h"
+#include "presentationtime.h"
 #include "primaryoutput_v1.h"
 #include "relativepointer.h"
 #include "remote_access.h"
@@ -40,6 +43,7 @@
 #include "shadow.h"
 #include "shell.h"
 #include "shm_pool.h"
+#include "singlepixelbuffer.h"
 #include "slide.h"
 #include "subcompositor.h"
 #include "textinput_p.h"
@@ -65,6 +69,9 @@
 #include <wayland-contrast-client-protocol.h>
 #include <wayland-dpms-client-protocol.h>
 #include <wayland-fake-input-client-protocol.h>
+#include <wayland-fractional-scale-v1-client-protocol.h>
+#include <wayland-single-pixel-buffer-v1-client-protocol.h>
+#include <wayland-cursor-shape-v1-client-protocol.h>
 #include <wayland-fullscreen-shell-client-protocol.h>
 #include <wayland-idle-client-protocol.h>
 #include <wayland-idle-inhibit-unstable-v1-client-protocol.h>
@@ -77,8 +84,10 @@
 #include <wayland-plasma-shell-client-protocol.h>
 #include <wayland-plasma-virtual-desktop-client-protocol.h>
 #include <wayland-plasma-window-management-client-protocol.h>
+#include <wayland-dde-plasma-window-management-client-protocol.h>
 #include <wayland-pointer-constraints-unstable-v1-client-protocol.h>
 #include <wayland-pointer-gestures-unstable-v1-client-protocol.h>
+#include <wayland-presentation-time-client-protocol.h>
 #include <wayland-relativepointer-unstable-v1-client-protocol.h>
 #include <wayland-remote-access-client-protocol.h>
 #include <wayland-server-decoration-client-protocol.h>
@@ -99,6 +108,8 @@
 #include <wayland-dde-globalproperty-client-protocol.h>
 #include <wayland-wlr-data-control-unstable-v1-client-protocol.h>
 #include <wayland-xwayland-keyboard-grab-v1-client-protocol.h>
+// std
+#include <memory>
 
 /*****
  * How to add another interface:
@@ -471,6 +482,41 @@ static const QMap<Registry::Interface, SuppertedInterfaceData> s_interfaces = {
         &Registry::xwaylandKeyboardGrabV1Announced,
         &Registry::xwaylandKeyboardGrabV1Removed
     }},
+    {Registry::Interface::PlasmaWindowManagementExtension, {
+        3,
+        QByteArrayLiteral("dde_plasma_window_management"),
+        &dde_plasma_window_management_interface,
+        &Registry::plasmaWindowManagementExtensionAnnounced,
+        &Registry::plasmaWindowManagementExtensionRemoved
+    }},
+    {Registry::Interface::PresentationTime, {
+        1,
+        QByteArrayLiteral("wp_presentation"),
+        &wp_presentation_interface,
+        &Registry::presentationTimeAnnounced,
+        &Registry::presentationTimeRemoved
+    }},
+    {Registry::Interface::FractionalScaleManagerV1, {
+        1,
+        QByteArrayLiteral("wp_fractional_scale_manager_v1"),
+        &wp_fractional_scale_manager_v1_interface,
+        &Registry::fractionalScaleManagerAnnounced,
+        &Registry::fractionalScaleManagerRemoved
+    }},
+    {Registry::Interface::SinglePixelBufferManagerV1, {
+        1,
+        QByteArrayLiteral("wp_single_pixel_buffer_manager_v1"),
+        &wp_single_pixel_buffer_manager_v1_interface,
+        &Registry::singlePixelBufferManagerAnnounced,
+        &Registry::singlePixelBufferManagerRemoved
+    }},
+    {Registry::Interface::CursorShapeManagerV1, {
+        1,
+        QByteArrayLiteral("wp_cursor_shape_manager_v1"),
+        &wp_cursor_shape_manager_v1_interface,
+        &Registry::cursorShapeManagerAnnounced,
+        &Registry::cursorShapeManagerRemoved
+    }},
 };
 // clang-format on
 
@@ -501,6 +547,9 @@ public:
     WaylandPointer<wl_registry, wl_registry_destroy> registry;
     static const struct wl_callback_listener s_callbackListener;
     WaylandPointer<wl_callback, wl_callback_destroy> callback;
+    static const struct wl_callback_listener s_syncListener;
+    QVector<wl_callback *> syncCallbacks;
+    wl_display *display = nullptr;
     EventQueue *queue = nullptr;
 
 private:
@@ -510,6 +559,7 @@ private:
     static void globalAnnounce(void *data, struct wl_registry *registry, uint32_t name, const char *interface, uint32_t version);
     static void globalRemove(void *data, struct wl_registry *registry, uint32_t name);
     static void globalSync(void *data, struct wl_callback *callback, uint32_t serial);
+    static void syncDone(void *data, struct wl_callback *callback, uint32_t serial);
 
     Registry *q;
     struct InterfaceData {
@@ -547,6 +597,11 @@ void Registry::release()
 {
     d->registry.release();
     d->callback.release();
+    for (wl_callback *callback : qAsConst(d->syncCallbacks)) {
+        wl_callback_destroy(callback);
+    }
+    d->syncCallbacks.clear();
+    d->display = nullptr;
 }
 
 void Registry::destroy()
@@ -554,12 +609,18 @@ void Registry::destroy()
     Q_EMIT registryDestroyed();
     d->registry.destroy();
     d->callback.destroy();
+    for (wl_callback *callback : qAsConst(d->syncCallbacks)) {
+        free(callback);
+    }
+    d->syncCallbacks.clear();
+    d->display = nullptr;
 }
 
 void Registry::create(wl_display *display)
 {
     Q_ASSERT(display);
     Q_ASSERT(!isValid());
+    d->display = display;
     d->registry.setup(wl_display_get_registry(display));
     d->callback.setup(wl_display_sync(display));
     if (d->queue) {
@@ -580,6 +641,22 @@ void Registry::setup()
     d->setup();
 }
 
+void Registry::sync()
+{
+    Q_ASSERT(isValid());
+    // create the callback on a wrapper, so that no other thread can read its reply into the
+    // default queue before it has been moved to our queue
+    wl_display *wrapper = static_cast<wl_display *>(wl_proxy_create_wrapper(d->display));
+    if (d->queue) {
+        wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(wrapper), *d->queue);
+    }
+    wl_callback *callback = wl_display_sync(wrapper);
+    wl_proxy_wrapper_destroy(wrapper);
+    wl_callback_add_listener(callback, &Private::s_syncListener, d.data());
+    d->syncCallbacks << callback;
+    wl_display_flush(d->display);
+}
+
 void Registry::setEventQueue(EventQueue *queue)
 {
     d->queue = queue;
@@ -603,6 +680,8 @@ EventQueue *Registry::eventQueue()
 const struct wl_registry_listener Registry::Private::s_registryListener = {globalAnnounce, globalRemove};
 
 const struct wl_callback_listener Registry::Private::s_callbackListener = {globalSync};
+
+const struct wl_callback_listener Registry::Private::s_syncListener = {syncDone};
 #endif
 
 void Registry::Private::globalAnnounce(void *data, wl_registry *registry, uint32_t name, const char *interface, uint32_t version)
@@ -628,6 +707,16 @@ void Registry::Private::globalSync(void *data, wl_callback *callback, uint32_t s
     r->callback.release();
 }
 
+void Registry::Private::syncDone(void *data, wl_callback *callback, uint32_t serial)
+{
+    Q_UNUSED(serial)
+    auto r = reinterpret_cast<Registry::Private *>(data);
+    Q_ASSERT(r->syncCallbacks.contains(callback));
+    r->syncCallbacks.removeOne(callback);
+    wl_callback_destroy(callback);
+    Q_EMIT r->q->synced();
+}
+
 void Registry::Private::handleGlobalSync()
 {
     Q_EMIT q->interfacesAnnounced();
@@ -755,6 +844,7 @@ BIND(PlasmaShell, org_kde_plasma_shell)
 BIND(PlasmaActivationFeedback, org_kde_plasma_activation_feedback)
 BIND(PlasmaVirtualDesktopManagement, org_kde_plasma_virtual_desktop_management)
 BIND(PlasmaWindowManagement, org_kde_plasma_window_management)
+BIND(PlasmaWindowManagementExtension, dde_plasma_window_management)
 BIND(Idle, org_kde_kwin_idle)
 BIND(RemoteAccessManager, org_kde_kwin_remote_access_manager)
 BIND(FakeInput, org_kde_kwin_fake_input)
@@ -792,6 +882,10 @@ BIND(Strut, com_deepin_kwin_strut)
 BIND(GlobalProperty, dde_globalproperty)
 BIND(DataControlDeviceManager, zwlr_data_control_manager_v1)
 BIND2(ZWPXwaylandKeyboardGrabManagerV1, ZWPXwaylandKeyboardGrabV1, zwp_xwayland_keyboard_grab_manager_v1)
+BIND(PresentationTime, wp_presentation)
+BIND2(FractionalScaleManager, FractionalScaleManagerV1, wp_fractional_scale_manager_v1)
+BIND2(SinglePixelBufferManager, SinglePixelBufferManagerV1, wp_single_pixel_buffer_manager_v1)
+BIND2(CursorShapeManager, CursorShapeManagerV1, wp_cursor_shape_manager_v1)
 
 #undef BIND
 #undef BIND2
@@ -831,7 +925,6 @@ CREATE(DataDeviceManager)
 CREATE(PlasmaShell)
 CREATE(PlasmaActivationFeedback)
 CREATE(PlasmaVirtualDesktopManagement)
-CREATE(PlasmaWindowManagement)
 CREATE(Idle)
 CREATE(RemoteAccessManager)
 CREATE(FakeInput)
@@ -856,10 +949,33 @@ CREATE(DDEShell)
 CREATE(Strut)
 CREATE(GlobalProperty)
 CREATE(ZWPXwaylandKeyboardGrabManagerV1)
+CREATE(PresentationTime)
+CREATE(FractionalScaleManager)
+CREATE(SinglePixelBufferManager)
+CREATE(CursorShapeManager)
 
 #undef CREATE
 #undef CREATE2
 
+PlasmaWindowManagement *Registry::createPlasmaWindowManagement(quint32 name, quint32 version, QObject *parent)
+{
+    PlasmaWindowManagement *wm = d->create<PlasmaWindowManagement>(name, version, parent, &Registry::bindPlasmaWindowManagement);
+    // The extension is announced after the window management global, so it might not be known yet
+    const AnnouncedInterface extension = interface(Interface::PlasmaWindowManagementExtension);
+    if (extension.name != 0) {
+        wm->setupExtension(bindPlasmaWindowManagementExtension(extension.name, extension.version));
+    } else {
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(this, &Registry::plasmaWindowManagementExtensionAnnounced, wm, [this, wm, connection](quint32 name, quint32 version) {
+            QObject::disconnect(*connection);
+            if (wm->isValid()) {
+                wm->setupExtension(bindPlasmaWindowManagementExtension(name, version));
+            }
+        });
+    }
+    return wm;
+}
+
 XdgExporter *Registry::createXdgExporter(quint32 name, quint32 version, QObject *parent)
 {
     // only V1 supported for now
@@ -43,6 +43,7 @@ struct org_kde_plasma_activation_feedback;
 struct org_kde_plasma_shell;
 struct org_kde_plasma_virtual_desktop_management;
 struct org_kde_plasma_window_management;
+struct dde_plasma_window_management;
 struct org_kde_kwin_server_decoration_manager;
 struct org_kde_kwin_server_decoration_palette_manager;
 struct xdg_shell;
@@ -63,6 +64,10 @@ struct com_deepin_kwin_strut;
 struct dde_globalproperty;
 struct zwlr_data_control_manager_v1;
 struct zwp_xwayland_keyboard_grab_manager_v1;
+struct wp_presentation;
+struct wp_fractional_scale_manager_v1;
+struct wp_single_pixel_buffer_manager_v1;
+struct wp_cursor_shape_manager_v1;
 
 namespace KWayland
 {
@@ -70,11 +75,13 @@ namespace Client
 {
 class AppMenuManager;
 class Compositor;
+class CursorShapeManager;
 class ConnectionThread;
 class DataDeviceManager;
 class DpmsManager;
 class EventQueue;
 class FakeInput;
+class FractionalScaleManager;
 class FullscreenShell;
 class OutputManagement;
 class OutputManagementV2;
@@ -91,6 +98,7 @@ class PlasmaVirtualDesktopManagement;
 class PlasmaWindowManagement;
 class PointerConstraints;
 class PointerGestures;
+class PresentationTime;
 class PrimaryOutputV1;
 class Seat;
 class ShadowManager;
@@ -99,6 +107,7 @@ class ContrastManager;
 class SlideManager;
 class Shell;
 class ShmPool;
+class SinglePixelBufferManager;
 class ServerSideDecorationManager;
 class ServerSideDecorationPaletteManager;
 class SubCompositor;
@@ -206,6 +215,11 @@ public:
         GlobalProperty,
         DataControlDeviceManager, /// refers to zwlr_data_control_manager_v1
         ZWPXwaylandKeyboardGrabV1, ///< refers to xwayland-keyboard-grab-unstable-v1 interface
+        PlasmaWindowManagementExtension, ///< refers to dde_plasma_window_management interface
+        PresentationTime, ///< refers to wp_presentation interface
+        FractionalScaleManagerV1, ///< refers to wp_fractional_scale_manager_v1 interface
+        SinglePixelBufferManagerV1, ///< refers to wp_single_pixel_buffer_manager_v1 interface
+        CursorShapeManagerV1, ///< refers to wp_cursor_shape_manager_v1 interface
     };
     explicit Registry(QObject *parent = nullptr);
     ~Registry() override;
@@ -248,6 +262,29 @@ public:
      * @see create
      **/
     void setup();
+    /**
+     * Requests a non-blocking roundtrip on the EventQueue of this Registry.
+     *
+     * Once the server has processed all requests sent before and the events sent in response
+     * got dispatched, the signal @link synced @endlink is emitted. This allows to bind all needed
+     * globals after @link interfacesAnnounced @endlink and to wait for their initial state in a
+     * single roundtrip, without blocking:
+     *
+     * @code
+     * connect(registry, &Registry::interfacesAnnounced, registry, [registry] {
+     *     // create all needed interfaces
+     *     registry->sync();
+     * });
+     * connect(registry, &Registry::synced, registry, [] {
+     *     // the initial state of the created interfaces is known
+     * });
+     * @endcode
+     *
+     * The Registry must have been created when calling this method.
+     * @see synced
+     * @see ConnectionThread::roundtripAsync
+     **/
+    void sync();
 
     /**
      * Sets the @p queue to use for this Registry.
@@ -457,6 +494,16 @@ public:
      * @since 5.46
      **/
     org_kde_plasma_window_management *bindPlasmaWindowManagement(uint32_t name, uint32_t version) const;
+    /**
+     * Binds the dde_plasma_window_management with @p name and @p version.
+     * If the @p name does not exist or is not for the Plasma window management extension,
+     * @c null will be returned.
+     *
+     * There is no need to call this, createPlasmaWindowManagement sets up the extension
+     * whenever the compositor announces it.
+     * @see PlasmaWindowManagement::setupExtension
+     **/
+    dde_plasma_window_management *bindPlasmaWindowManagementExtension(uint32_t name, uint32_t version) const;
     /**
      * Binds the org_kde_kwin_idle with @p name and @p version.
      * If the @p name does not exist or is not for the idle interface,
@@ -790,6 +837,42 @@ public:
      * @since 5.54
      **/
     zwp_xwayland_keyboard_grab_manager_v1 *bindZWPXwaylandKeyboardGrabManagerV1(uint32_t name, uint32_t version) const;
+    /**
+     * Binds the wp_presentation with @p name and @p version.
+     * If the @p name does not exist or is not for the wp_presentation interface,
+     * @c null will be returned.
+     *
+     * Prefer using createPresentationTime instead.
+     * @see createPresentationTime
+     **/
+    wp_presentation *bindPresentationTime(uint32_t name, uint32_t version) const;
+    /**
+     * Binds the wp_fractional_scale_manager_v1 with @p name and @p version.
+     * If the @p name does not exist or is not for the wp_fractional_scale_manager_v1 interface,
+     * @c null will be returned.
+     *
+     * Prefer using createFractionalScaleManager instead.
+     * @see createFractionalScaleManager
+     **/
+    wp_fractional_scale_manager_v1 *bindFractionalScaleManager(uint32_t name, uint32_t version) const;
+    /**
+     * Binds the wp_single_pixel_buffer_manager_v1 with @p name and @p version.
+     * If the @p name does not exist or is not for the wp_single_pixel_buffer_manager_v1 interface,
+     * @c null will be returned.
+     *
+     * Prefer using createSinglePixelBufferManager instead.
+     * @see createSinglePixelBufferManager
+     **/
+    wp_single_pixel_buffer_manager_v1 *bindSinglePixelBufferManager(uint32_t name, uint32_t version) const;
+    /**
+     * Binds the wp_cursor_shape_manager_v1 with @p name and @p version.
+     * If the @p name does not exist or is not for the wp_cursor_shape_manager_v1 interface,
+     * @c null will be returned.
+     *
+     * Prefer using createCursorShapeManager instead.
+     * @see createCursorShapeManager
+     **/
+    wp_cursor_shape_manager_v1 *bindCursorShapeManager(uint32_t name, uint32_t version) const;
     ///@}
 
     /**
@@ -1504,6 +1587,70 @@ public:
      * @since 5.54
      **/
     ZWPXwaylandKeyboardGrabManagerV1 *createZWPXwaylandKeyboardGrabManagerV1(quint32 name, quint32 version, QObject *parent = nullptr);
+
+    /**
+     * Creates a PresentationTime and sets it up to manage the interface identified by
+     * @p name and @p version.
+     *
+     * Note: in case @p name is invalid or isn't for the wp_presentation interface,
+     * the returned PresentationTime will not be valid. Therefore it's recommended to call
+     * isValid on the created instance.
+     *
+     * @param name The name of the wp_presentation interface to bind
+     * @param version The version or the wp_presentation interface to use
+     * @param parent The parent for PresentationTime
+     *
+     * @returns The created PresentationTime.
+     **/
+    PresentationTime *createPresentationTime(quint32 name, quint32 version, QObject *parent = nullptr);
+
+    /**
+     * Creates a FractionalScaleManager and sets it up to manage the interface identified by
+     * @p name and @p version.
+     *
+     * Note: in case @p name is invalid or isn't for the wp_fractional_scale_manager_v1 interface,
+     * the returned FractionalScaleManager will not be valid. Therefore it's recommended to call
+     * isValid on the created instance.
+     *
+     * @param name The name of the wp_fractional_scale_manager_v1 interface to bind
+     * @param version The version or the wp_fractional_scale_manager_v1 interface to use
+     * @param parent The parent for FractionalScaleManager
+     *
+     * @returns The created FractionalScaleManager.
+     **/
+    FractionalScaleManager *createFractionalScaleManager(quint32 name, quint32 version, QObject *parent = nullptr);
+
+    /**
+     * Creates a SinglePixelBufferManager and sets it up to manage the interface identified by
+     * @p name and @p version.
+     *
+     * Note: in case @p name is invalid or isn't for the wp_single_pixel_buffer_manager_v1 interface,
+     * the returned SinglePixelBufferManager will not be valid. Therefore it's recommended to call
+     * isValid on the created instance.
+     *
+     * @param name The name of the wp_single_pixel_buffer_manager_v1 interface to bind
+     * @param version The version or the wp_single_pixel_buffer_manager_v1 interface to use
+     * @param parent The parent for SinglePixelBufferManager
+     *
+     * @returns The created SinglePixelBufferManager.
+     **/
+    SinglePixelBufferManager *createSinglePixelBufferManager(quint32 name, quint32 version, QObject *parent = nullptr);
+
+    /**
+     * Creates a CursorShapeManager and sets it up to manage the interface identified by
+     * @p name and @p version.
+     *
+     * Note: in case @p name is invalid or isn't for the wp_cursor_shape_manager_v1 interface,
+     * the returned CursorShapeManager will not be valid. Therefore it's recommended to call
+     * isValid on the created instance.
+     *
+     * @param name The name of the wp_cursor_shape_manager_v1 interface to bind
+     * @param version The version or the wp_cursor_shape_manager_v1 interface to use
+     * @param parent The parent for CursorShapeManager
+     *
+     * @returns The created CursorShapeManager.
+     **/
+    CursorShapeManager *createCursorShapeManager(quint32 name, quint32 version, QObject *parent = nullptr);
     ///@}
 
     /**
@@ -1617,6 +1764,12 @@ Q_SIGNALS:
      * @since 5.4
      **/
     void plasmaWindowManagementAnnounced(quint32 name, quint32 version);
+    /**
+     * Emitted whenever a dde_plasma_window_management interface gets announced.
+     * @param name The name for the announced interface
+     * @param version The maximum supported version of the announced interface
+     **/
+    void plasmaWindowManagementExtensionAnnounced(quint32 name, quint32 version);
     /**
      * Emitted whenever a org_kde_kwin_idle interface gets announced.
      * @param name The name for the announced interface
@@ -1858,6 +2011,34 @@ Q_SIGNALS:
      * @since 5.54
      **/
     void xwaylandKeyboardGrabV1Announced(quint32 name, quint32 version);
+
+    /**
+     * Emitted whenever a wp_presentation interface gets announced.
+     * @param name The name for the announced interface
+     * @param version The maximum supported version of the announced interface
+     **/
+    void presentationTimeAnnounced(quint32 name, quint32 version);
+
+    /**
+     * Emitted whenever a wp_fractional_scale_manager_v1 interface gets announced.
+     * @param name The name for the announced interface
+     * @param version The maximum supported version of the announced interface
+     **/
+    void fractionalScaleManagerAnnounced(quint32 name, quint32 version);
+
+    /**
+     * Emitted whenever a wp_single_pixel_buffer_manager_v1 interface gets announced.
+     * @param name The name for the announced interface
+     * @param version The maximum supported version of the announced interface
+     **/
+    void singlePixelBufferManagerAnnounced(quint32 name, quint32 version);
+
+    /**
+     * Emitted whenever a wp_cursor_shape_manager_v1 interface gets announced.
+     * @param name The name for the announced interface
+     * @param version The maximum supported version of the announced interface
+     **/
+    void cursorShapeManagerAnnounced(quint32 name, quint32 version);
     ///@}
 
     /**
@@ -1948,6 +2129,11 @@ Q_SIGNALS:
      * @since 5.4
      **/
     void plasmaWindowManagementRemoved(quint32 name);
+    /**
+     * Emitted whenever a dde_plasma_window_management interface gets removed.
+     * @param name The name for the removed interface
+     **/
+    void plasmaWindowManagementExtensionRemoved(quint32 name);
     /**
      * Emitted whenever a org_kde_kwin_idle interface gets removed.
      * @param name The name for the removed interface
@@ -2140,6 +2326,30 @@ Q_SIGNALS:
     void dataControlDeviceManagerRemoved(quint32 name);
 
     void xwaylandKeyboardGrabV1Removed(quint32 name);
+
+    /**
+     * Emitted whenever a wp_presentation interface gets removed.
+     * @param name The name of the removed interface
+     **/
+    void presentationTimeRemoved(quint32 name);
+
+    /**
+     * Emitted whenever a wp_fractional_scale_manager_v1 interface gets removed.
+     * @param name The name of the removed interface
+     **/
+    void fractionalScaleManagerRemoved(quint32 name);
+
+    /**
+     * Emitted whenever a wp_single_pixel_buffer_manager_v1 interface gets removed.
+     * @param name The name of the removed interface
+     **/
+    void singlePixelBufferManagerRemoved(quint32 name);
+
+    /**
+     * Emitted whenever a wp_cursor_shape_manager_v1 interface gets removed.
+     * @param name The name of the removed interface
+     **/
+    void cursorShapeManagerRemoved(quint32 name);
     ///@}
     /**
      * Generic announced signal which gets emitted whenever an interface gets
@@ -2172,6 +2382,12 @@ Q_SIGNALS:
      * This signal is emitted from the wl_display_sync callback.
      **/
     void interfacesAnnounced();
+    /**
+     * Emitted for every call to @link sync @endlink once the server processed all requests
+     * sent before it and the events sent in response have been dispatched.
+     * @see sync
+     **/
+    void synced();
 
 Q_SIGNALS:
     /*
@@ -11,6 +11,7 @@
 #include "wayland_pointer_p.h"
 // Qt
 #include <QGuiApplication>
+#include <QHash>
 #include <QVector>
 #include <qpa/qplatformnativeinterface.h>
 // Wayland
@@ -114,9 +115,11 @@ public:
     Private(ShellSurface *q);
     void setup(wl_shell_surface *surface);
 
+    void forgetNative();
+
     WaylandPointer<wl_shell_surface, wl_shell_surface_destroy> surface;
     QSize size;
-    static QVector<ShellSurface *> s_surfaces;
+    static QMultiHash<wl_shell_surface *, ShellSurface *> s_surfaces;
 
 private:
     void ping(uint32_t serial);
@@ -128,7 +131,7 @@ private:
     static const struct wl_shell_surface_listener s_listener;
 };
 
-QVector<ShellSurface *> ShellSurface::Private::s_surfaces = QVector<ShellSurface *>();
+QMultiHash<wl_shell_surface *, ShellSurface *> ShellSurface::Private::s_surfaces;
 
 ShellSurface::Private::Private(ShellSurface *q)
     : q(q)
@@ -140,9 +143,15 @@ void ShellSurface::Private::setup(wl_shell_surface *s)
     Q_ASSERT(s);
     Q_ASSERT(!surface);
     surface.setup(s);
+    s_surfaces.insert(s, q);
     wl_shell_surface_add_listener(surface, &s_listener, this);
 }
 
+void ShellSurface::Private::forgetNative()
+{
+    s_surfaces.remove(surface, q);
+}
+
 ShellSurface *ShellSurface::fromWindow(QWindow *window)
 {
     if (!window) {
@@ -162,6 +171,7 @@ ShellSurface *ShellSurface::fromWindow(QWindow *window)
     }
     ShellSurface *surface = new ShellSurface(window);
     surface->d->surface.setup(s, true);
+    Private::s_surfaces.insert(s, surface);
     return surface;
 }
 
@@ -184,35 +194,34 @@ ShellSurface *ShellSurface::fromQtWinId(WId wid)
 
 ShellSurface *ShellSurface::get(wl_shell_surface *native)
 {
-    auto it = std::find_if(Private::s_surfaces.constBegin(), Private::s_surfaces.constEnd(), [native](ShellSurface *s) {
-        return s->d->surface == native;
-    });
-    if (it != Private::s_surfaces.constEnd()) {
-        return *(it);
+    // A proxy can be wrapped more than once, the oldest wrapper is the last of the key.
+    ShellSurface *surface = nullptr;
+    for (auto it = Private::s_surfaces.constFind(native); it != Private::s_surfaces.constEnd() && it.key() == native; ++it) {
+        surface = it.value();
     }
-    return nullptr;
+    return surface;
 }
 
 ShellSurface::ShellSurface(QObject *parent)
     : QObject(parent)
     , d(new Private(this))
 {
-    Private::s_surfaces << this;
 }
 
 ShellSurface::~ShellSurface()
 {
-    Private::s_surfaces.removeOne(this);
     release();
 }
 
 void ShellSurface::release()
 {
+    d->forgetNative();
     d->surface.release();
 }
 
 void ShellSurface::destroy()
 {
+    d->forgetNative();
     d->surface.destroy();
 }
 
@@ -11,9 +11,15 @@
 // Qt
 #include <QDebug>
 #include <QImage>
+#include <QMap>
 #include <QTemporaryFile>
+// std
+#include <algorithm>
+#include <limits>
 // system
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 // wayland
 #include <wayland-client-protocol.h>
@@ -22,22 +28,52 @@ namespace KWayland
 {
 namespace Client
 {
+namespace
+{
+static const int32_t s_initialPoolSize = 1024;
+// keeps every Buffer cache line aligned
+static const int32_t s_bufferAlignment = 64;
+
+static int32_t alignedByteCount(const QSize &size, int32_t stride)
+{
+    return (size.height() * stride + s_bufferAlignment - 1) & ~(s_bufferAlignment - 1);
+}
+}
+
 class Q_DECL_HIDDEN ShmPool::Private
 {
 public:
     Private(ShmPool *q);
     bool createPool();
+    bool openPoolFile(bool hugePages);
+    bool mapPoolFile();
+    void closePoolFile();
     bool resizePool(int32_t newSize);
+    bool growPool(int32_t byteCount);
     QList<QSharedPointer<Buffer>>::iterator getBuffer(const QSize &size, int32_t stride, Buffer::Format format);
+    int32_t allocate(int32_t byteCount);
+    void deallocate(int32_t offset, int32_t byteCount);
+    void insertFreeBlock(int32_t offset, int32_t byteCount);
+    bool reclaimBuffers();
+    void resetAllocator();
     WaylandPointer<wl_shm, wl_shm_destroy> shm;
     WaylandPointer<wl_shm_pool, wl_shm_pool_destroy> pool;
     void *poolData = nullptr;
-    int32_t size = 1024;
+    int32_t size = s_initialPoolSize;
+    int fd = -1;
     QScopedPointer<QTemporaryFile> tmpFile;
+    bool hugePagesEnabled = false;
+    bool hugePagesInUse = false;
     bool valid = false;
-    int offset = 0;
     QList<QSharedPointer<Buffer>> buffers;
     EventQueue *queue = nullptr;
+    /**
+     * Free ranges of the pool, keyed by offset. Adjacent ranges are always coalesced,
+     * so the map never contains two blocks which touch each other.
+     **/
+    QMap<int32_t, int32_t> freeBlocks;
+    int32_t bytesInUse = 0;
+    int resizeCount = 0;
 
 private:
     ShmPool *q;
@@ -69,9 +105,9 @@ void ShmPool::release()
     }
     d->pool.release();
     d->shm.release();
-    d->tmpFile->close();
+    d->closePoolFile();
     d->valid = false;
-    d->offset = 0;
+    d->resetAllocator();
 }
 
 void ShmPool::destroy()
@@ -86,9 +122,9 @@ void ShmPool::destroy()
     }
     d->pool.destroy();
     d->shm.destroy();
-    d->tmpFile->close();
+    d->closePoolFile();
     d->valid = false;
-    d->offset = 0;
+    d->resetAllocator();
 }
 
 void ShmPool::setup(wl_shm *shm)
@@ -109,8 +145,51 @@ EventQueue *ShmPool::eventQueue()
     return d->queue;
 }
 
-bool ShmPool::Private::createPool()
+void ShmPool::setHugePagesEnabled(bool enabled)
+{
+    d->hugePagesEnabled = enabled;
+}
+
+bool ShmPool::hugePagesEnabled() const
+{
+    return d->hugePagesEnabled;
+}
+
+bool ShmPool::Private::openPoolFile(bool hugePages)
 {
+#ifdef MFD_CLOEXEC
+    // An anonymous memory file doesn't touch the file system. The pool only ever grows,
+    // so it gets sealed against shrinking, which allows the server to safely map it.
+    const unsigned int flags = MFD_CLOEXEC | MFD_ALLOW_SEALING;
+#ifdef MFD_HUGETLB
+    if (hugePages) {
+        fd = memfd_create("dwayland-shm-pool", flags | MFD_HUGETLB);
+        if (fd == -1) {
+            qCDebug(KWAYLAND_CLIENT) << "Huge pages are not available for Shm pool, falling back to regular pages";
+        } else {
+            hugePagesInUse = true;
+            // hugetlbfs reports the huge page size as block size, the file size must be a multiple of it
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_blksize > size) {
+                size = info.st_blksize;
+            }
+        }
+    }
+#endif
+    if (fd == -1) {
+        fd = memfd_create("dwayland-shm-pool", flags);
+    }
+    if (fd != -1) {
+#ifdef F_ADD_SEALS
+        if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) != 0) {
+            qCDebug(KWAYLAND_CLIENT) << "Could not seal Shm pool file";
+        }
+#endif
+        return true;
+    }
+    qCDebug(KWAYLAND_CLIENT) << "memfd_create failed for Shm pool, falling back to a temporary file";
+#endif
+
     if (!tmpFile->open()) {
         qCDebug(KWAYLAND_CLIENT) << "Could not open temporary file for Shm pool";
         return false;
@@ -118,38 +197,195 @@ bool ShmPool::Private::createPool()
     if (unlink(tmpFile->fileName().toUtf8().constData()) != 0) {
         qCDebug(KWAYLAND_CLIENT) << "Unlinking temporary file for Shm pool from file system failed";
     }
-    if (ftruncate(tmpFile->handle(), size) < 0) {
+    fd = tmpFile->handle();
+    return true;
+}
+
+void ShmPool::Private::closePoolFile()
+{
+    if (tmpFile->isOpen()) {
+        // the temporary file owns the descriptor
+        tmpFile->close();
+    } else if (fd != -1) {
+        close(fd);
+    }
+    fd = -1;
+    hugePagesInUse = false;
+}
+
+bool ShmPool::Private::mapPoolFile()
+{
+    if (ftruncate(fd, size) < 0) {
         qCDebug(KWAYLAND_CLIENT) << "Could not set size for Shm pool file";
         return false;
     }
-    poolData = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, tmpFile->handle(), 0);
-    pool.setup(wl_shm_create_pool(shm, tmpFile->handle(), size));
+    poolData = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (poolData == MAP_FAILED) {
+        poolData = nullptr;
+        qCDebug(KWAYLAND_CLIENT) << "Mapping Shm pool file failed";
+        return false;
+    }
+    return true;
+}
+
+bool ShmPool::Private::createPool()
+{
+    if (!openPoolFile(hugePagesEnabled)) {
+        return false;
+    }
+    if (!mapPoolFile()) {
+        if (!hugePagesInUse) {
+            return false;
+        }
+        // memfd_create(MFD_HUGETLB) succeeds even if no huge pages are reserved,
+        // only sizing or mapping the file fails then
+        qCDebug(KWAYLAND_CLIENT) << "Huge pages are not available for Shm pool, falling back to regular pages";
+        closePoolFile();
+        size = s_initialPoolSize;
+        if (!openPoolFile(false) || !mapPoolFile()) {
+            return false;
+        }
+    }
+    pool.setup(wl_shm_create_pool(shm, fd, size));
 
-    if (poolData == MAP_FAILED || !pool) {
+    if (!pool) {
         qCDebug(KWAYLAND_CLIENT) << "Creating Shm pool failed";
         return false;
     }
+    insertFreeBlock(0, size);
     return true;
 }
 
 bool ShmPool::Private::resizePool(int32_t newSize)
 {
-    if (ftruncate(tmpFile->handle(), newSize) < 0) {
+    if (ftruncate(fd, newSize) < 0) {
         qCDebug(KWAYLAND_CLIENT) << "Could not set new size for Shm pool file";
         return false;
     }
     wl_shm_pool_resize(pool, newSize);
     munmap(poolData, size);
-    poolData = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, tmpFile->handle(), 0);
+    poolData = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     size = newSize;
     if (poolData == MAP_FAILED) {
         qCDebug(KWAYLAND_CLIENT) << "Resizing Shm pool failed";
         return false;
     }
+    resizeCount++;
     Q_EMIT q->poolResized();
     return true;
 }
 
+bool ShmPool::Private::growPool(int32_t byteCount)
+{
+    // A free block at the end of the pool gets extended by the resize, so it only has to
+    // provide the remainder. The pool grows geometrically to keep the number of resizes
+    // (ftruncate, remap and wl_shm_pool.resize) logarithmic in the pool size.
+    int32_t tailFree = 0;
+    if (!freeBlocks.isEmpty()) {
+        auto last = std::prev(freeBlocks.end());
+        if (last.key() + last.value() == size) {
+            tailFree = last.value();
+        }
+    }
+    const qint64 requiredSize = qint64(size) + byteCount - tailFree;
+    qint64 newSize = qMax<qint64>(size, s_initialPoolSize);
+    while (newSize < requiredSize) {
+        newSize *= 2;
+    }
+    newSize = qMin<qint64>(newSize, std::numeric_limits<int32_t>::max() & ~(s_bufferAlignment - 1));
+    if (newSize < requiredSize) {
+        qCDebug(KWAYLAND_CLIENT) << "Shm pool cannot grow to" << requiredSize << "bytes";
+        return false;
+    }
+    const int32_t oldSize = size;
+    if (!resizePool(newSize)) {
+        return false;
+    }
+    insertFreeBlock(oldSize, size - oldSize);
+    return true;
+}
+
+int32_t ShmPool::Private::allocate(int32_t byteCount)
+{
+    // best fit, the number of free blocks is small as they are always coalesced
+    auto best = freeBlocks.end();
+    for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+        if (it.value() < byteCount) {
+            continue;
+        }
+        if (best == freeBlocks.end() || it.value() < best.value()) {
+            best = it;
+            if (best.value() == byteCount) {
+                break;
+            }
+        }
+    }
+    if (best == freeBlocks.end()) {
+        return -1;
+    }
+    const int32_t offset = best.key();
+    const int32_t remaining = best.value() - byteCount;
+    freeBlocks.erase(best);
+    if (remaining > 0) {
+        freeBlocks.insert(offset + byteCount, remaining);
+    }
+    bytesInUse += byteCount;
+    return offset;
+}
+
+void ShmPool::Private::deallocate(int32_t offset, int32_t byteCount)
+{
+    bytesInUse -= byteCount;
+    insertFreeBlock(offset, byteCount);
+}
+
+void ShmPool::Private::insertFreeBlock(int32_t offset, int32_t byteCount)
+{
+    if (byteCount <= 0) {
+        return;
+    }
+    auto next = freeBlocks.lowerBound(offset);
+    if (next != freeBlocks.end() && offset + byteCount == next.key()) {
+        byteCount += next.value();
+        next = freeBlocks.erase(next);
+    }
+    if (next != freeBlocks.begin()) {
+        auto previous = std::prev(next);
+        if (previous.key() + previous.value() == offset) {
+            previous.value() += byteCount;
+            return;
+        }
+    }
+    freeBlocks.insert(offset, byteCount);
+}
+
+bool ShmPool::Private::reclaimBuffers()
+{
+    // Buffers which are released by the server and not used by the client may be destroyed
+    // at any time, give their memory back to the pool.
+    bool reclaimed = false;
+    for (auto it = buffers.begin(); it != buffers.end();) {
+        const QSharedPointer<Buffer> &buffer = *it;
+        if (!buffer->isReleased() || buffer->isUsed()) {
+            ++it;
+            continue;
+        }
+        const int32_t offset = buffer->address() - reinterpret_cast<uchar *>(poolData);
+        deallocate(offset, alignedByteCount(buffer->size(), buffer->stride()));
+        it = buffers.erase(it);
+        reclaimed = true;
+    }
+    return reclaimed;
+}
+
+void ShmPool::Private::resetAllocator()
+{
+    freeBlocks.clear();
+    bytesInUse = 0;
+    resizeCount = 0;
+    size = s_initialPoolSize;
+}
+
 namespace
 {
 static Buffer::Format toBufferFormat(const QImage &image)
@@ -237,22 +473,28 @@ QList<QSharedPointer<Buffer>>::iterator ShmPool::Private::getBuffer(const QSize
         buffer->setReleased(false);
         return it;
     }
-    const int32_t byteCount = s.height() * stride;
-    if (offset + byteCount > size) {
-        if (!resizePool(size + byteCount)) {
+    const int32_t byteCount = alignedByteCount(s, stride);
+    int32_t offset = allocate(byteCount);
+    if (offset == -1 && reclaimBuffers()) {
+        offset = allocate(byteCount);
+    }
+    if (offset == -1) {
+        if (!growPool(byteCount)) {
             return buffers.end();
         }
+        offset = allocate(byteCount);
+        Q_ASSERT(offset != -1);
     }
     // we don't have a buffer which we could reuse - need to create a new one
     wl_buffer *native = wl_shm_pool_create_buffer(pool, offset, s.width(), s.height(), stride, toWaylandFormat(format));
     if (!native) {
+        deallocate(offset, byteCount);
         return buffers.end();
     }
     if (queue) {
         queue->addProxy(native);
     }
     Buffer *buffer = new Buffer(q, native, s, stride, offset, format);
-    offset += byteCount;
     auto it = buffers.insert(buffers.end(), QSharedPointer<Buffer>(buffer));
     return it;
 }
@@ -272,5 +514,34 @@ wl_shm *ShmPool::shm()
     return d->shm;
 }
 
+int32_t ShmPool::poolSize() const
+{
+    return d->valid ? d->size : 0;
+}
+
+int32_t ShmPool::bytesInUse() const
+{
+    return d->bytesInUse;
+}
+
+qreal ShmPool::fragmentation() const
+{
+    int32_t freeBytes = 0;
+    int32_t largestFreeBlock = 0;
+    for (auto it = d->freeBlocks.constBegin(); it != d->freeBlocks.constEnd(); ++it) {
+        freeBytes += it.value();
+        largestFreeBlock = std::max(largestFreeBlock, it.value());
+    }
+    if (freeBytes == 0) {
+        return 0;
+    }
+    return 1.0 - qreal(largestFreeBlock) / freeBytes;
+}
+
+int ShmPool::resizeCount() const
+{
+    return d->resizeCount;
+}
+
 }
 }
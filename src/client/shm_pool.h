@@ -40,7 +40,8 @@ class EventQueue;
  * s->setup(registry->bindShm(name, version));
  * @endcode
  *
- * The ShmPool holds a memory-mapped file from which it provides Buffers.
+ * The ShmPool holds a memory-mapped file from which it provides Buffers. Where available the
+ * file is an anonymous, shrink-sealed memfd, otherwise an unlinked temporary file.
  * All Buffers are held by the ShmPool and can be reused. Whenever a Buffer
  * is requested the ShmPool tries to reuse an existing Buffer. A Buffer can
  * be reused if the following conditions hold
@@ -106,9 +107,13 @@ class EventQueue;
  * @endcode
  *
  * This is also important for the case that the shared memory pool needs to be resized.
- * The ShmPool will automatically resize if it cannot provide a new Buffer. During the resize
- * all existing Buffers are unmapped and any shared objects must be recreated. The ShmPool emits
- * the signal poolResized() after the pool got resized.
+ * Buffers are sub-allocated from the pool with a best-fit allocator. If no free range is large
+ * enough for a new Buffer, the ShmPool first destroys all Buffers which are released and not
+ * used and gives their memory back to the pool. Only if that doesn't free enough memory the pool
+ * grows, doubling its size. During the resize all existing Buffers are unmapped and any shared
+ * objects must be recreated. The ShmPool emits the signal poolResized() after the pool got resized.
+ *
+ * The allocator can be inspected with poolSize(), bytesInUse(), fragmentation() and resizeCount().
  *
  * @see Buffer
  **/
@@ -165,6 +170,23 @@ public:
      **/
     EventQueue *eventQueue();
 
+    /**
+     * Sets whether the shared memory pool should be backed by huge pages. This reduces
+     * the TLB pressure for pools holding large Buffers, at the cost of rounding the pool
+     * size up to the huge page size (usually 2 MiB). If the system doesn't provide huge
+     * pages, the pool silently falls back to regular pages.
+     *
+     * Must be called before setup() to have an effect. Default is @c false.
+     * @since 5.24
+     **/
+    void setHugePagesEnabled(bool enabled);
+    /**
+     * @returns Whether huge pages were requested for the shared memory pool.
+     * @see setHugePagesEnabled
+     * @since 5.24
+     **/
+    bool hugePagesEnabled() const;
+
     /**
      * Provides a Buffer with:
      * @li same size as @p image
@@ -211,6 +233,30 @@ public:
      **/
     Buffer::Ptr getBuffer(const QSize &size, int32_t stride, Buffer::Format format = Buffer::Format::ARGB32);
     wl_shm *shm();
+
+    /**
+     * @returns The size of the shared memory pool in bytes, @c 0 if the ShmPool is not valid.
+     * @since 5.24
+     **/
+    int32_t poolSize() const;
+    /**
+     * @returns The number of bytes of the pool currently held by Buffers.
+     * @since 5.24
+     **/
+    int32_t bytesInUse() const;
+    /**
+     * The external fragmentation of the free memory in the pool, ranging from @c 0
+     * (all free memory is one contiguous range) to close to @c 1 (free memory is scattered
+     * in many small ranges).
+     * @since 5.24
+     **/
+    qreal fragmentation() const;
+    /**
+     * @returns How often the pool had to be resized since it got set up.
+     * @see poolResized
+     * @since 5.24
+     **/
+    int resizeCount() const;
 Q_SIGNALS:
     /**
      * This signal is emitted whenever the shared memory pool gets resized.
@@ -0,0 +1,105 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#include "singlepixelbuffer.h"
+#include "event_queue.h"
+#include "wayland_pointer_p.h"
+
+#include <QColor>
+
+#include <wayland-single-pixel-buffer-v1-client-protocol.h>
+
+namespace KWayland
+{
+namespace Client
+{
+class Q_DECL_HIDDEN SinglePixelBufferManager::Private
+{
+public:
+    Private() = default;
+
+    void setup(wp_single_pixel_buffer_manager_v1 *arg);
+
+    WaylandPointer<wp_single_pixel_buffer_manager_v1, wp_single_pixel_buffer_manager_v1_destroy> manager;
+    EventQueue *queue = nullptr;
+};
+
+SinglePixelBufferManager::SinglePixelBufferManager(QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+}
+
+void SinglePixelBufferManager::Private::setup(wp_single_pixel_buffer_manager_v1 *arg)
+{
+    Q_ASSERT(arg);
+    Q_ASSERT(!manager);
+    manager.setup(arg);
+}
+
+SinglePixelBufferManager::~SinglePixelBufferManager()
+{
+    release();
+}
+
+void SinglePixelBufferManager::setup(wp_single_pixel_buffer_manager_v1 *manager)
+{
+    d->setup(manager);
+}
+
+void SinglePixelBufferManager::release()
+{
+    d->manager.release();
+}
+
+void SinglePixelBufferManager::destroy()
+{
+    d->manager.destroy();
+}
+
+SinglePixelBufferManager::operator wp_single_pixel_buffer_manager_v1 *()
+{
+    return d->manager;
+}
+
+SinglePixelBufferManager::operator wp_single_pixel_buffer_manager_v1 *() const
+{
+    return d->manager;
+}
+
+bool SinglePixelBufferManager::isValid() const
+{
+    return d->manager.isValid();
+}
+
+void SinglePixelBufferManager::setEventQueue(EventQueue *queue)
+{
+    d->queue = queue;
+}
+
+EventQueue *SinglePixelBufferManager::eventQueue()
+{
+    return d->queue;
+}
+
+wl_buffer *SinglePixelBufferManager::createBuffer(const QColor &color)
+{
+    // widen the 16 bit channels to the full 32 bit range, 0xffff becomes 0xffffffff
+    const QRgba64 rgba = color.rgba64().premultiplied();
+    return createBuffer(rgba.red() * 0x10001u, rgba.green() * 0x10001u, rgba.blue() * 0x10001u, rgba.alpha() * 0x10001u);
+}
+
+wl_buffer *SinglePixelBufferManager::createBuffer(quint32 red, quint32 green, quint32 blue, quint32 alpha)
+{
+    Q_ASSERT(isValid());
+    auto buffer = wp_single_pixel_buffer_manager_v1_create_u32_rgba_buffer(d->manager, red, green, blue, alpha);
+    if (d->queue) {
+        d->queue->addProxy(buffer);
+    }
+    return buffer;
+}
+
+}
+}
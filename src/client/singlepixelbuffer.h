@@ -0,0 +1,145 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#ifndef KWAYLAND_CLIENT_SINGLEPIXELBUFFER_H
+#define KWAYLAND_CLIENT_SINGLEPIXELBUFFER_H
+
+#include <QObject>
+
+#include <DWayland/Client/kwaylandclient_export.h>
+
+struct wl_buffer;
+struct wp_single_pixel_buffer_manager_v1;
+
+class QColor;
+
+namespace KWayland
+{
+namespace Client
+{
+class EventQueue;
+
+/**
+ * @short Wrapper for the wp_single_pixel_buffer_manager_v1 interface.
+ *
+ * This class provides a convenient wrapper for the wp_single_pixel_buffer_manager_v1 interface.
+ * It creates buffers of a single pixel with a solid color. Such buffers do not need any
+ * memory, scaled with a wp_viewport they are the cheapest way to show a solid color surface.
+ *
+ * To use this class one needs to interact with the Registry. There are two
+ * possible ways to create the SinglePixelBufferManager interface:
+ * @code
+ * SinglePixelBufferManager *c = registry->createSinglePixelBufferManager(name, version);
+ * @endcode
+ *
+ * This creates the SinglePixelBufferManager and sets it up directly. As an alternative this
+ * can also be done in a more low level way:
+ * @code
+ * SinglePixelBufferManager *c = new SinglePixelBufferManager;
+ * c->setup(registry->bindSinglePixelBufferManager(name, version));
+ * @endcode
+ *
+ * The SinglePixelBufferManager can be used as a drop-in replacement for any wp_single_pixel_buffer_manager_v1
+ * pointer as it provides matching cast operators.
+ *
+ * @see Registry
+ **/
+class KWAYLANDCLIENT_EXPORT SinglePixelBufferManager : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Creates a new SinglePixelBufferManager.
+     * Note: after constructing the SinglePixelBufferManager it is not yet valid and one needs
+     * to call setup. In order to get a ready to use SinglePixelBufferManager prefer using
+     * Registry::createSinglePixelBufferManager.
+     **/
+    explicit SinglePixelBufferManager(QObject *parent = nullptr);
+    ~SinglePixelBufferManager() override;
+
+    /**
+     * Setup this SinglePixelBufferManager to manage the @p manager.
+     * When using Registry::createSinglePixelBufferManager there is no need to call this
+     * method.
+     **/
+    void setup(wp_single_pixel_buffer_manager_v1 *manager);
+    /**
+     * @returns @c true if managing a wp_single_pixel_buffer_manager_v1.
+     **/
+    bool isValid() const;
+    /**
+     * Releases the wp_single_pixel_buffer_manager_v1 interface.
+     * After the interface has been released the SinglePixelBufferManager instance is no
+     * longer valid and can be setup with another wp_single_pixel_buffer_manager_v1 interface.
+     **/
+    void release();
+    /**
+     * Destroys the data held by this SinglePixelBufferManager.
+     * This method is supposed to be used when the connection to the Wayland
+     * server goes away. If the connection is not valid anymore, it's not
+     * possible to call release anymore as that calls into the Wayland
+     * connection and the call would fail. This method cleans up the data, so
+     * that the instance can be deleted or set up to a new wp_single_pixel_buffer_manager_v1 interface
+     * once there is a new connection available.
+     *
+     * It is suggested to connect this method to ConnectionThread::connectionDied:
+     * @code
+     * connect(connection, &ConnectionThread::connectionDied, manager, &SinglePixelBufferManager::destroy);
+     * @endcode
+     *
+     * @see release
+     **/
+    void destroy();
+
+    /**
+     * Sets the @p queue to use for creating objects with this SinglePixelBufferManager.
+     **/
+    void setEventQueue(EventQueue *queue);
+    /**
+     * @returns The event queue to use for creating objects with this SinglePixelBufferManager.
+     **/
+    EventQueue *eventQueue();
+
+    /**
+     * Creates a 1x1 buffer filled with @p color. The buffer can be attached to any Surface,
+     * use a wp_viewport to scale it to the size of the Surface.
+     *
+     * The caller takes ownership of the returned wl_buffer and has to destroy it with
+     * @c wl_buffer_destroy once it is no longer needed.
+     * @param color The color of the buffer, it gets premultiplied by its alpha
+     * @returns The created wl_buffer
+     **/
+    wl_buffer *createBuffer(const QColor &color);
+    /**
+     * Creates a 1x1 buffer from the 32 bit @p red, @p green, @p blue and @p alpha values.
+     * The color channels have to be premultiplied by @p alpha.
+     *
+     * The caller takes ownership of the returned wl_buffer and has to destroy it with
+     * @c wl_buffer_destroy once it is no longer needed.
+     * @returns The created wl_buffer
+     **/
+    wl_buffer *createBuffer(quint32 red, quint32 green, quint32 blue, quint32 alpha);
+
+    operator wp_single_pixel_buffer_manager_v1 *();
+    operator wp_single_pixel_buffer_manager_v1 *() const;
+
+Q_SIGNALS:
+    /**
+     * The corresponding global for this interface on the Registry got removed.
+     *
+     * This signal gets only emitted if the SinglePixelBufferManager got created by
+     * Registry::createSinglePixelBufferManager
+     **/
+    void removed();
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+}
+
+#endif
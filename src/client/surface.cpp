@@ -9,6 +9,7 @@
 #include "wayland_pointer_p.h"
 
 #include <QGuiApplication>
+#include <QHash>
 #include <QRegion>
 #include <QVector>
 #include <qpa/qplatformnativeinterface.h>
@@ -33,8 +34,11 @@ public:
     QVector<Output *> outputs;
 
     void setup(wl_surface *s);
+    void forgetNative();
 
     static QList<Surface *> s_surfaces;
+    // looked up for every enter/leave/focus event, so avoid scanning s_surfaces
+    static QMultiHash<wl_surface *, Surface *> s_nativeSurfaces;
 
 private:
     void handleFrameCallback();
@@ -49,6 +53,7 @@ private:
 };
 
 QList<Surface *> Surface::Private::s_surfaces = QList<Surface *>();
+QMultiHash<wl_surface *, Surface *> Surface::Private::s_nativeSurfaces;
 
 Surface::Private::Private(Surface *q)
     : q(q)
@@ -87,6 +92,7 @@ Surface *Surface::fromWindow(QWindow *window)
     }
     Surface *surface = new Surface(window);
     surface->d->surface.setup(s, true);
+    Private::s_nativeSurfaces.insert(s, surface);
     return surface;
 }
 
@@ -109,11 +115,13 @@ Surface *Surface::fromQtWinId(WId wid)
 
 void Surface::release()
 {
+    d->forgetNative();
     d->surface.release();
 }
 
 void Surface::destroy()
 {
+    d->forgetNative();
     d->surface.destroy();
 }
 
@@ -127,9 +135,15 @@ void Surface::Private::setup(wl_surface *s)
     Q_ASSERT(s);
     Q_ASSERT(!surface);
     surface.setup(s);
+    s_nativeSurfaces.insert(s, q);
     wl_surface_add_listener(s, &s_surfaceListener, this);
 }
 
+void Surface::Private::forgetNative()
+{
+    s_nativeSurfaces.remove(surface, q);
+}
+
 void Surface::Private::frameCallback(void *data, wl_callback *callback, uint32_t time)
 {
     Q_UNUSED(time)
@@ -277,13 +291,12 @@ void Surface::setSize(const QSize &size)
 
 Surface *Surface::get(wl_surface *native)
 {
-    auto it = std::find_if(Private::s_surfaces.constBegin(), Private::s_surfaces.constEnd(), [native](Surface *s) {
-        return s->d->surface == native;
-    });
-    if (it != Private::s_surfaces.constEnd()) {
-        return *(it);
+    // A proxy can be wrapped more than once, the oldest wrapper is the last of the key.
+    Surface *surface = nullptr;
+    for (auto it = Private::s_nativeSurfaces.constFind(native); it != Private::s_nativeSurfaces.constEnd() && it.key() == native; ++it) {
+        surface = it.value();
     }
-    return nullptr;
+    return surface;
 }
 
 const QList<Surface *> &Surface::all()
@@ -5,10 +5,188 @@
 */
 
 #include "abstract_data_source.h"
+#include "logging.h"
+
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
 
 using namespace KWaylandServer;
 
+// A receiver which doesn't read anything for that long is given up on.
+static const int s_stallTimeout = 10000;
+static const size_t s_chunkSize = 1024 * 1024;
+
+// Transfers block their thread while waiting for the receiver, so they don't take threads
+// away from the global pool.
+Q_GLOBAL_STATIC(QThreadPool, s_transferPool)
+
+namespace
+{
+/**
+ * Keeps SIGPIPE from killing the compositor if the receiver goes away, writes fail with
+ * EPIPE instead. The signal can't be ignored process wide from a library.
+ */
+class SigPipeBlocker
+{
+public:
+    SigPipeBlocker()
+    {
+        sigset_t sigPipe;
+        sigemptyset(&sigPipe);
+        sigaddset(&sigPipe, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &sigPipe, &m_previousMask);
+    }
+    ~SigPipeBlocker()
+    {
+        // Drop a SIGPIPE raised by our writes before it can be delivered.
+        sigset_t sigPipe;
+        sigemptyset(&sigPipe);
+        sigaddset(&sigPipe, SIGPIPE);
+        const timespec noWait = {0, 0};
+        while (sigtimedwait(&sigPipe, nullptr, &noWait) == SIGPIPE) { }
+        pthread_sigmask(SIG_SETMASK, &m_previousMask, nullptr);
+    }
+
+private:
+    sigset_t m_previousMask;
+};
+}
+
+static bool waitWritable(int fd)
+{
+    pollfd pfd = {fd, POLLOUT, 0};
+    while (true) {
+        const int ret = poll(&pfd, 1, s_stallTimeout);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret == 0) {
+            qCWarning(KWAYLAND_SERVER) << "Giving up data transfer, the receiver stopped reading";
+        }
+        return ret > 0 && (pfd.revents & POLLOUT);
+    }
+}
+
+static bool writeAll(int fd, const char *data, size_t size)
+{
+    size_t written = 0;
+    while (written < size) {
+        const ssize_t ret = write(fd, data + written, std::min(size - written, s_chunkSize));
+        if (ret >= 0) {
+            written += ret;
+        } else if (errno == EAGAIN) {
+            if (!waitWritable(fd)) {
+                return false;
+            }
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool copyFile(int fd, int memfd, off_t offset, off_t size)
+{
+    QByteArray buffer(std::min<off_t>(size - offset, s_chunkSize), Qt::Uninitialized);
+    while (offset < size) {
+        const ssize_t ret = pread(memfd, buffer.data(), std::min<off_t>(size - offset, buffer.size()), offset);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        if (!writeAll(fd, buffer.constData(), ret)) {
+            return false;
+        }
+        offset += ret;
+    }
+    return true;
+}
+
+static bool spliceFile(int fd, int memfd)
+{
+    struct stat info;
+    if (fstat(memfd, &info) != 0) {
+        return false;
+    }
+    const off_t size = info.st_size;
+    loff_t offset = 0;
+
+    // Spliced pages are only referenced by the pipe, they must not change until read.
+#ifdef F_GET_SEALS
+    const int seals = fcntl(memfd, F_GET_SEALS);
+    if (seals == -1 || !(seals & F_SEAL_WRITE)) {
+        return copyFile(fd, memfd, offset, size);
+    }
+#else
+    return copyFile(fd, memfd, offset, size);
+#endif
+    while (offset < size) {
+        const ssize_t ret = splice(memfd, &offset, fd, nullptr, size - offset, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (ret > 0) {
+            continue;
+        }
+        if (ret == 0) {
+            return false;
+        }
+        if (errno == EAGAIN) {
+            if (!waitWritable(fd)) {
+                return false;
+            }
+        } else if (errno == EINVAL) {
+            // fd is not a pipe
+            return copyFile(fd, memfd, offset, size);
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
 AbstractDataSource::AbstractDataSource(QObject *parent)
     : QObject(parent)
 {
 }
+
+QFuture<bool> AbstractDataSource::writeData(const QByteArray &data, qint32 fd)
+{
+    return QtConcurrent::run(s_transferPool(), [data, fd]() {
+        SigPipeBlocker sigPipeBlocker;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        const bool ok = writeAll(fd, data.constData(), data.size());
+        close(fd);
+        return ok;
+    });
+}
+
+QFuture<bool> AbstractDataSource::writeFile(int memfd, qint32 fd)
+{
+    const int dupedFd = fcntl(memfd, F_DUPFD_CLOEXEC, 0);
+    if (dupedFd == -1) {
+        qCWarning(KWAYLAND_SERVER) << "Failed to duplicate file descriptor:" << strerror(errno);
+        close(fd);
+        QFutureInterface<bool> failed(QFutureInterfaceBase::Started);
+        failed.reportResult(false);
+        failed.reportFinished();
+        return failed.future();
+    }
+    return QtConcurrent::run(s_transferPool(), [dupedFd, fd]() {
+        SigPipeBlocker sigPipeBlocker;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        const bool ok = spliceFile(fd, dupedFd);
+        close(dupedFd);
+        close(fd);
+        return ok;
+    });
+}
@@ -11,6 +11,8 @@
 
 #include <DWayland/Server/kwaylandserver_export.h>
 
+#include <QFuture>
+
 struct wl_client;
 
 namespace KWaylandServer
@@ -87,6 +89,27 @@ Q_SIGNALS:
 
 protected:
     explicit AbstractDataSource(QObject *parent = nullptr);
+
+    /**
+     * Writes @p data to @p fd on a worker thread and closes @p fd afterwards. Meant for
+     * sources owned by the compositor to implement requestData, however large @p data is
+     * and however slowly the receiver reads, the event loop is not blocked.
+     *
+     * The transfer is given up if the receiver does not read anything for ten seconds or
+     * closes its end. Takes ownership of @p fd.
+     *
+     * @returns a future which reports whether all of @p data was written
+     */
+    static QFuture<bool> writeData(const QByteArray &data, qint32 fd);
+
+    /**
+     * Like writeData, but serves the content of the memory file @p memfd. If @p memfd is
+     * sealed against writing and @p fd is a pipe, the pages of @p memfd are spliced into the
+     * pipe instead of being copied.
+     *
+     * @p memfd is duplicated, the caller keeps ownership of it. Takes ownership of @p fd.
+     */
+    static QFuture<bool> writeFile(int memfd, qint32 fd);
 };
 
 }
@@ -4,45 +4,29 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 #include "clientconnection.h"
+#include "clientconnection_p.h"
 #include "display.h"
 #include "utils/executable_path.h"
 // Qt
+#include <QDebug>
 #include <QFileInfo>
-#include <QVector>
 // Wayland
 #include <wayland-server.h>
+// system
+#include <sys/ioctl.h>
+#if defined(Q_OS_LINUX)
+#include <linux/sockios.h>
+#endif
 
 namespace KWaylandServer
 {
-class ClientConnectionPrivate
-{
-public:
-    ClientConnectionPrivate(wl_client *c, Display *display, ClientConnection *q);
-    ~ClientConnectionPrivate();
-
-    wl_client *client;
-    Display *display;
-    pid_t pid = 0;
-    uid_t user = 0;
-    gid_t group = 0;
-    QString executablePath;
-
-private:
-    static void destroyListenerCallback(wl_listener *listener, void *data);
-    ClientConnection *q;
-    wl_listener listener;
-    static QVector<ClientConnectionPrivate *> s_allClients;
-};
-
-QVector<ClientConnectionPrivate *> ClientConnectionPrivate::s_allClients;
-
 ClientConnectionPrivate::ClientConnectionPrivate(wl_client *c, Display *display, ClientConnection *q)
     : client(c)
     , display(display)
     , q(q)
 {
-    s_allClients << this;
     listener.notify = destroyListenerCallback;
+    listener.connection = this;
     wl_client_add_destroy_listener(c, &listener);
     wl_client_get_credentials(client, &pid, &user, &group);
     executablePath = executablePathFromPid(pid);
@@ -53,18 +37,57 @@ ClientConnectionPrivate::~ClientConnectionPrivate()
     if (client) {
         wl_list_remove(&listener.link);
     }
-    s_allClients.removeAt(s_allClients.indexOf(this));
+}
+
+ClientConnectionPrivate *ClientConnectionPrivate::get(wl_client *client)
+{
+    wl_listener *listener = wl_client_get_destroy_listener(client, destroyListenerCallback);
+    if (!listener) {
+        return nullptr;
+    }
+    return static_cast<ClientConnectionDestroyListener *>(listener)->connection;
+}
+
+ClientConnectionPrivate *ClientConnectionPrivate::get(ClientConnection *connection)
+{
+    return connection->d.data();
+}
+
+void ClientConnectionPrivate::countRequest(const char *interface, quint32 size)
+{
+    ++interfaceStatistics[interface].requests;
+    ++statistics.requests;
+    statistics.requestBytes += size;
+}
+
+void ClientConnectionPrivate::countEvent(const char *interface, quint32 size)
+{
+    ++interfaceStatistics[interface].events;
+    ++statistics.events;
+    statistics.eventBytes += size;
+}
+
+void ClientConnectionPrivate::countHandlerTime(const char *interface, qint64 nsecs)
+{
+    interfaceStatistics[interface].handlerTime += nsecs;
+    statistics.handlerTime += nsecs;
+}
+
+void ClientConnectionPrivate::countFlush()
+{
+#if defined(SIOCOUTQ)
+    // What is still queued on the socket has not been read by the client yet.
+    int unread = 0;
+    if (client && ioctl(wl_client_get_fd(client), SIOCOUTQ, &unread) == 0 && unread > 0) {
+        ++statistics.backloggedFlushes;
+    }
+#endif
 }
 
 void ClientConnectionPrivate::destroyListenerCallback(wl_listener *listener, void *data)
 {
-    Q_UNUSED(listener)
-    wl_client *client = reinterpret_cast<wl_client *>(data);
-    auto it = std::find_if(s_allClients.constBegin(), s_allClients.constEnd(), [client](ClientConnectionPrivate *c) {
-        return c->client == client;
-    });
-    Q_ASSERT(it != s_allClients.constEnd());
-    auto p = (*it);
+    Q_UNUSED(data)
+    auto p = static_cast<ClientConnectionDestroyListener *>(listener)->connection;
     auto q = p->q;
     Q_EMIT q->aboutToBeDestroyed();
     p->client = nullptr;
@@ -81,6 +104,14 @@ ClientConnection::ClientConnection(wl_client *c, Display *parent)
 
 ClientConnection::~ClientConnection() = default;
 
+ClientConnection *ClientConnection::get(wl_client *native)
+{
+    if (auto connectionPrivate = ClientConnectionPrivate::get(native)) {
+        return connectionPrivate->q;
+    }
+    return nullptr;
+}
+
 void ClientConnection::flush()
 {
     if (!d->client) {
@@ -145,4 +176,39 @@ QString ClientConnection::executablePath() const
     return d->executablePath;
 }
 
+ClientConnectionStatistics ClientConnection::statistics() const
+{
+    ClientConnectionStatistics statistics = d->statistics;
+    statistics.interfaces.reserve(d->interfaceStatistics.size());
+    for (auto it = d->interfaceStatistics.constBegin(); it != d->interfaceStatistics.constEnd(); ++it) {
+        statistics.interfaces.insert(QByteArray(it.key()), it.value());
+    }
+#if defined(SIOCOUTQ)
+    int unread = 0;
+    if (d->client && ioctl(wl_client_get_fd(d->client), SIOCOUTQ, &unread) == 0) {
+        statistics.unreadBytes = unread;
+    }
+#endif
+    return statistics;
+}
+
+void ClientConnection::resetStatistics()
+{
+    d->interfaceStatistics.clear();
+    d->statistics = ClientConnectionStatistics();
+}
+
+QDebug operator<<(QDebug debug, const ClientConnectionStatistics &statistics)
+{
+    QDebugStateSaver saver(debug);
+    debug.nospace() << "ClientConnectionStatistics(requests: " << statistics.requests << " (" << statistics.requestBytes << " bytes"
+                    << ", " << statistics.handlerTime / 1000 << " us), events: " << statistics.events << " (" << statistics.eventBytes
+                    << " bytes), backlogged flushes: " << statistics.backloggedFlushes << ", unread: " << statistics.unreadBytes << " bytes";
+    for (auto it = statistics.interfaces.constBegin(); it != statistics.interfaces.constEnd(); ++it) {
+        debug << ", " << it.key().constData() << ": " << it->requests << " requests (" << it->handlerTime / 1000 << " us), " << it->events << " events";
+    }
+    debug << ')';
+    return debug;
+}
+
 }
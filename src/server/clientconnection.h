@@ -7,10 +7,13 @@
 
 #include <sys/types.h>
 
+#include <QByteArray>
+#include <QHash>
 #include <QObject>
 
 #include <DWayland/Server/kwaylandserver_export.h>
 
+class QDebug;
 struct wl_client;
 struct wl_resource;
 
@@ -19,6 +22,48 @@ namespace KWaylandServer
 class ClientConnectionPrivate;
 class Display;
 
+/**
+ * A snapshot of the protocol traffic of a ClientConnection.
+ *
+ * The numbers are only collected while Display::setClientStatisticsEnabled is on.
+ *
+ * @see ClientConnection::statistics
+ */
+struct ClientConnectionStatistics {
+    struct Interface {
+        quint64 requests = 0;
+        quint64 events = 0;
+        /**
+         * Nanoseconds spent in the request handlers, including the demarshalling of the requests.
+         */
+        qint64 handlerTime = 0;
+    };
+    /**
+     * The traffic per interface, by interface name, e.g. "wl_surface".
+     */
+    QHash<QByteArray, Interface> interfaces;
+
+    quint64 requests = 0;
+    quint64 requestBytes = 0;
+    quint64 events = 0;
+    /**
+     * The size of all events sent to the client, file descriptors not included.
+     */
+    quint64 eventBytes = 0;
+    qint64 handlerTime = 0;
+    /**
+     * The number of times the client had not read everything sent so far when the Display
+     * flushed. A client which doesn't keep up with its events ends up here.
+     */
+    quint64 backloggedFlushes = 0;
+    /**
+     * The number of bytes sent but not read by the client when the snapshot was taken.
+     */
+    quint32 unreadBytes = 0;
+};
+
+KWAYLANDSERVER_EXPORT QDebug operator<<(QDebug debug, const ClientConnectionStatistics &statistics);
+
 /**
  * @brief Convenient Class which represents a wl_client.
  *
@@ -92,6 +137,16 @@ public:
      */
     QString executablePath() const;
 
+    /**
+     * @returns a snapshot of the requests, events and bytes exchanged with the client so far
+     * @see Display::setClientStatisticsEnabled
+     */
+    ClientConnectionStatistics statistics() const;
+    /**
+     * Starts collecting the statistics from zero.
+     */
+    void resetStatistics();
+
     /**
      * Cast operator the native wl_client this ClientConnection represents.
      */
@@ -121,7 +176,12 @@ Q_SIGNALS:
 
 private:
     friend class Display;
+    friend class ClientConnectionPrivate;
     explicit ClientConnection(wl_client *c, Display *parent);
+    /**
+     * @returns The ClientConnection for @p native, @c null if there is none yet.
+     */
+    static ClientConnection *get(wl_client *native);
     QScopedPointer<ClientConnectionPrivate> d;
 };
 
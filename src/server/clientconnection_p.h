@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2014 Martin Gräßlin <mgraesslin@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include "clientconnection.h"
+
+#include <QHash>
+
+#include <wayland-server-core.h>
+
+namespace KWaylandServer
+{
+class ClientConnectionPrivate;
+
+/**
+ * The destroy listener doubles as the link from the wl_client to its ClientConnection,
+ * it can be found with wl_client_get_destroy_listener() without searching all connections.
+ */
+struct ClientConnectionDestroyListener : wl_listener {
+    ClientConnectionPrivate *connection;
+};
+
+class ClientConnectionPrivate
+{
+public:
+    ClientConnectionPrivate(wl_client *c, Display *display, ClientConnection *q);
+    ~ClientConnectionPrivate();
+
+    static ClientConnectionPrivate *get(wl_client *client);
+    static ClientConnectionPrivate *get(ClientConnection *connection);
+
+    void countRequest(const char *interface, quint32 size);
+    void countEvent(const char *interface, quint32 size);
+    void countHandlerTime(const char *interface, qint64 nsecs);
+    void countFlush();
+
+    wl_client *client;
+    Display *display;
+    pid_t pid = 0;
+    uid_t user = 0;
+    gid_t group = 0;
+    QString executablePath;
+    ClientConnection *q;
+
+    // Keyed by the name of the wl_interface, compared by address, so counting doesn't
+    // need to hash strings.
+    QHash<const char *, ClientConnectionStatistics::Interface> interfaceStatistics;
+    ClientConnectionStatistics statistics;
+
+private:
+    static void destroyListenerCallback(wl_listener *listener, void *data);
+    ClientConnectionDestroyListener listener;
+};
+
+} // namespace KWaylandServer
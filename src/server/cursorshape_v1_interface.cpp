@@ -0,0 +1,112 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "cursorshape_v1_interface.h"
+#include "display.h"
+#include "pointer_interface.h"
+#include "pointer_interface_p.h"
+
+#include <QPointer>
+
+#include "qwayland-server-cursor-shape-v1.h"
+
+static const int s_version = 1;
+
+namespace KWaylandServer
+{
+class CursorShapeManagerV1InterfacePrivate : public QtWaylandServer::wp_cursor_shape_manager_v1
+{
+protected:
+    void wp_cursor_shape_manager_v1_destroy(Resource *resource) override;
+    void wp_cursor_shape_manager_v1_get_pointer(Resource *resource, uint32_t cursor_shape_device, struct ::wl_resource *pointer) override;
+    void wp_cursor_shape_manager_v1_get_tablet_tool_v2(Resource *resource, uint32_t cursor_shape_device, struct ::wl_resource *tablet_tool) override;
+};
+
+class CursorShapeDeviceV1Interface : public QtWaylandServer::wp_cursor_shape_device_v1
+{
+public:
+    CursorShapeDeviceV1Interface(PointerInterface *pointer, wl_resource *resource);
+
+    QPointer<PointerInterface> pointer;
+
+protected:
+    void wp_cursor_shape_device_v1_destroy_resource(Resource *resource) override;
+    void wp_cursor_shape_device_v1_destroy(Resource *resource) override;
+    void wp_cursor_shape_device_v1_set_shape(Resource *resource, uint32_t serial, uint32_t shape) override;
+};
+
+void CursorShapeManagerV1InterfacePrivate::wp_cursor_shape_manager_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void CursorShapeManagerV1InterfacePrivate::wp_cursor_shape_manager_v1_get_pointer(Resource *resource,
+                                                                                  uint32_t cursor_shape_device,
+                                                                                  struct ::wl_resource *pointer)
+{
+    wl_resource *deviceResource = wl_resource_create(resource->client(), &wp_cursor_shape_device_v1_interface, resource->version(), cursor_shape_device);
+    if (!deviceResource) {
+        wl_client_post_no_memory(resource->client());
+        return;
+    }
+    new CursorShapeDeviceV1Interface(PointerInterface::get(pointer), deviceResource);
+}
+
+void CursorShapeManagerV1InterfacePrivate::wp_cursor_shape_manager_v1_get_tablet_tool_v2(Resource *resource,
+                                                                                         uint32_t cursor_shape_device,
+                                                                                         struct ::wl_resource *tablet_tool)
+{
+    Q_UNUSED(tablet_tool)
+    // Tablet tools only have surface cursors so far, the device is created but inert.
+    wl_resource *deviceResource = wl_resource_create(resource->client(), &wp_cursor_shape_device_v1_interface, resource->version(), cursor_shape_device);
+    if (!deviceResource) {
+        wl_client_post_no_memory(resource->client());
+        return;
+    }
+    new CursorShapeDeviceV1Interface(nullptr, deviceResource);
+}
+
+CursorShapeDeviceV1Interface::CursorShapeDeviceV1Interface(PointerInterface *pointer, wl_resource *resource)
+    : QtWaylandServer::wp_cursor_shape_device_v1(resource)
+    , pointer(pointer)
+{
+}
+
+void CursorShapeDeviceV1Interface::wp_cursor_shape_device_v1_destroy_resource(Resource *resource)
+{
+    Q_UNUSED(resource)
+    delete this;
+}
+
+void CursorShapeDeviceV1Interface::wp_cursor_shape_device_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void CursorShapeDeviceV1Interface::wp_cursor_shape_device_v1_set_shape(Resource *resource, uint32_t serial, uint32_t shape)
+{
+    if (shape < shape_default || shape > shape_zoom_out) {
+        wl_resource_post_error(resource->handle, error_invalid_shape, "unknown cursor shape %u", shape);
+        return;
+    }
+    if (!pointer) {
+        return;
+    }
+    PointerInterfacePrivate::get(pointer)->setCursorShape(resource->client(), serial, Cursor::Shape(shape));
+}
+
+CursorShapeManagerV1Interface::CursorShapeManagerV1Interface(Display *display, QObject *parent)
+    : QObject(parent)
+    , d(new CursorShapeManagerV1InterfacePrivate)
+{
+    d->init(*display, s_version);
+}
+
+CursorShapeManagerV1Interface::~CursorShapeManagerV1Interface()
+{
+}
+
+} // namespace KWaylandServer
@@ -0,0 +1,43 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <DWayland/Server/kwaylandserver_export.h>
+
+#include <QObject>
+
+namespace KWaylandServer
+{
+class Display;
+class CursorShapeManagerV1InterfacePrivate;
+
+/**
+ * The CursorShapeManagerV1Interface lets clients pick one of the predefined cursor shapes
+ * instead of providing the cursor image with a surface, so they don't need to load cursor
+ * themes and allocate cursor buffers.
+ *
+ * A requested shape is reported through the Cursor of the PointerInterface the client
+ * created the shape device for, see Cursor::shape() and PointerInterface::cursorChanged().
+ * The compositor renders the shape from its own cursor theme.
+ *
+ * Shape devices for tablet tools are accepted but inert, the shapes they request are ignored.
+ *
+ * CursorShapeManagerV1Interface corresponds to the Wayland interface @c wp_cursor_shape_manager_v1.
+ */
+class KWAYLANDSERVER_EXPORT CursorShapeManagerV1Interface : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CursorShapeManagerV1Interface(Display *display, QObject *parent = nullptr);
+    ~CursorShapeManagerV1Interface() override;
+
+private:
+    QScopedPointer<CursorShapeManagerV1InterfacePrivate> d;
+};
+
+} // namespace KWaylandServer
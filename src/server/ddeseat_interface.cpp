@@ -24,6 +24,10 @@ License along with this library.  If not, see <http://www.gnu.org/licenses/>.
 #include "utils.h"
 
 #include <QPointF>
+#include <QScopedPointer>
+#include <QTemporaryFile>
+
+#include <unistd.h>
 
 #include "ddeseat_interface_p.h"
 #include "ddekeyboard_interface_p.h"
@@ -192,6 +196,44 @@ void DDESeatInterface::setKeymap(int fd, quint32 size)
     d->ddekeyboard->setKeymap(fd, size);
 }
 
+void DDESeatInterface::setKeymap(const QByteArray &content)
+{
+    if (content.isNull()) {
+        return;
+    }
+    if (d->keys.keymapContent != content) {
+        d->keys.keymapContent = content;
+        // include the terminating null byte, clients are allowed to parse the keymap as a string
+        if (!d->keys.keymapFile.create("dwayland-dde-keymap", content.constData(), content.size() + 1)) {
+            qCDebug(KWAYLAND_SERVER) << "Sealed keymap file is not available, using an unsealed file";
+        }
+    }
+    if (d->keys.keymapFile.isValid()) {
+        setKeymap(d->keys.keymapFile.fd(), d->keys.keymapFile.size());
+        return;
+    }
+
+    // The file is closed again once the keymap is sent, there is no fd to keep.
+    d->keys.keymap.fd = -1;
+    d->keys.keymap.size = 0;
+    if (!d->ddekeyboard) {
+        return;
+    }
+    QScopedPointer<QTemporaryFile> tmp(new QTemporaryFile());
+    if (!tmp->open()) {
+        qCWarning(KWAYLAND_SERVER) << "Failed to create keymap file:" << tmp->errorString();
+        return;
+    }
+    unlink(tmp->fileName().toUtf8().constData());
+    const qint64 size = content.size() + 1;
+    if (tmp->write(content.constData(), size) != size || !tmp->flush()) {
+        qCWarning(KWAYLAND_SERVER) << "Failed to write keymap file:" << tmp->errorString();
+        return;
+    }
+    d->keys.keymap.xkbcommonCompatible = true;
+    d->ddekeyboard->setKeymap(tmp->handle(), size);
+}
+
 void DDESeatInterface::keyPressed(quint32 key)
 {
     if (!d->ddekeyboard) {
@@ -66,6 +66,16 @@ public:
     quint32 touchtimestamp() const;
 
     void setKeymap(int fd, quint32 size);
+    /**
+     * Sets the keymap from its textual @p content. The keymap is written once into a sealed,
+     * read-only file which is shared with the dde_keyboard; the file is only regenerated if
+     * @p content differs from the previous keymap.
+     *
+     * If the system doesn't support sealed files nothing is sent and the compositor has to
+     * use setKeymap(int, quint32) instead.
+     * @since 5.24
+     */
+    void setKeymap(const QByteArray &content);
     void keyPressed(quint32 key);
     void keyReleased(quint32 key);
     void updateKeyboardModifiers(quint32 depressed, quint32 latched, quint32 locked, quint32 group);
@@ -8,6 +8,7 @@
 
 // KWayland
 #include "ddeseat_interface.h"
+#include "utils/sealed_file.h"
 // Qt
 #include <QHash>
 #include <QMap>
@@ -49,6 +50,8 @@ public:
             bool xkbcommonCompatible = false;
         };
         Keymap keymap;
+        QByteArray keymapContent;
+        SealedFile keymapFile;
         struct Modifiers {
             quint32 depressed = 0;
             quint32 latched = 0;
@@ -6,6 +6,7 @@
 */
 #include "display.h"
 #include "clientbufferintegration.h"
+#include "clientconnection_p.h"
 #include "display_p.h"
 #include "drmclientbuffer.h"
 #include "logging.h"
@@ -17,6 +18,8 @@
 #include <QDebug>
 #include <QRect>
 
+#include <cstring>
+
 namespace KWaylandServer
 {
 DisplayPrivate *DisplayPrivate::get(Display *display)
@@ -29,6 +32,65 @@ DisplayPrivate::DisplayPrivate(Display *q)
 {
 }
 
+// The size of the message on the wire, see wl_closure_marshal.
+static quint32 messageSize(const wl_protocol_logger_message *message)
+{
+    quint32 size = 8;
+    int argument = 0;
+    for (const char *signature = message->message->signature; *signature && argument < message->arguments_count; ++signature) {
+        const wl_argument &value = message->arguments[argument];
+        switch (*signature) {
+        case 'i':
+        case 'u':
+        case 'f':
+        case 'o':
+        case 'n':
+            size += 4;
+            break;
+        case 's':
+            size += 4 + (value.s ? (std::strlen(value.s) + 1 + 3) & ~3u : 0);
+            break;
+        case 'a':
+            size += 4 + (value.a ? (value.a->size + 3) & ~3u : 0);
+            break;
+        case 'h':
+            break;
+        default:
+            // version numbers and nullability markers
+            continue;
+        }
+        ++argument;
+    }
+    return size;
+}
+
+void DisplayPrivate::logProtocol(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message)
+{
+    auto d = static_cast<DisplayPrivate *>(userData);
+    wl_client *client = wl_resource_get_client(message->resource);
+    const char *interface = wl_resource_get_class(message->resource);
+    if (type == WL_PROTOCOL_LOGGER_REQUEST) {
+        d->finishRequest();
+        ClientConnection *connection = d->q->getConnection(client);
+        ClientConnectionPrivate::get(connection)->countRequest(interface, messageSize(message));
+        d->requestConnection = connection;
+        d->requestInterface = interface;
+        d->requestStart = d->statisticsClock.nsecsElapsed();
+    } else if (ClientConnectionPrivate *connection = ClientConnectionPrivate::get(client)) {
+        // The client might be going away, so no ClientConnection is created for events.
+        connection->countEvent(interface, messageSize(message));
+    }
+}
+
+void DisplayPrivate::finishRequest()
+{
+    if (requestConnection) {
+        ClientConnectionPrivate::get(requestConnection)->countHandlerTime(requestInterface, statisticsClock.nsecsElapsed() - requestStart);
+    }
+    requestConnection.clear();
+    requestInterface = nullptr;
+}
+
 void DisplayPrivate::registerSocketName(const QString &socketName)
 {
     socketNames.append(socketName);
@@ -45,6 +107,7 @@ Display::Display(QObject *parent)
 
 Display::~Display()
 {
+    setClientStatisticsEnabled(false);
     wl_display_destroy_clients(d->display);
     wl_display_destroy(d->display);
 }
@@ -114,11 +177,39 @@ void Display::dispatchEvents()
     if (wl_event_loop_dispatch(d->loop, 0) != 0) {
         qCWarning(KWAYLAND_SERVER) << "Error on dispatching Wayland event loop";
     }
+    if (d->protocolLogger) {
+        d->finishRequest();
+    }
 }
 
 void Display::flush()
 {
     wl_display_flush_clients(d->display);
+    if (d->protocolLogger) {
+        for (ClientConnection *connection : qAsConst(d->clients)) {
+            ClientConnectionPrivate::get(connection)->countFlush();
+        }
+    }
+}
+
+void Display::setClientStatisticsEnabled(bool enabled)
+{
+    if (isClientStatisticsEnabled() == enabled) {
+        return;
+    }
+    if (enabled) {
+        d->statisticsClock.start();
+        d->protocolLogger = wl_display_add_protocol_logger(d->display, DisplayPrivate::logProtocol, d.data());
+    } else {
+        wl_protocol_logger_destroy(d->protocolLogger);
+        d->protocolLogger = nullptr;
+        d->finishRequest();
+    }
+}
+
+bool Display::isClientStatisticsEnabled() const
+{
+    return d->protocolLogger;
 }
 
 void Display::createShm()
@@ -182,11 +273,8 @@ QVector<SeatInterface *> Display::seats() const
 ClientConnection *Display::getConnection(wl_client *client)
 {
     Q_ASSERT(client);
-    auto it = std::find_if(d->clients.constBegin(), d->clients.constEnd(), [client](ClientConnection *c) {
-        return c->client() == client;
-    });
-    if (it != d->clients.constEnd()) {
-        return *it;
+    if (ClientConnection *c = ClientConnection::get(client)) {
+        return c;
     }
     // no ConnectionData yet, create it
     auto c = new ClientConnection(client, this);
@@ -125,6 +125,16 @@ public:
     ClientConnection *getConnection(wl_client *client);
     QVector<ClientConnection *> connections() const;
 
+    /**
+     * Enables collecting the requests, events and bytes exchanged with every client, so that
+     * a client flooding the compositor can be found. It is off by default, it costs a little
+     * for every message.
+     *
+     * @see ClientConnection::statistics
+     */
+    void setClientStatisticsEnabled(bool enabled);
+    bool isClientStatisticsEnabled() const;
+
     /**
      * Set the EGL @p display for this Wayland display.
      * The EGLDisplay can only be set once and must be alive as long as the Wayland display
@@ -9,8 +9,10 @@
 
 #include <wayland-server-core.h>
 
+#include <QElapsedTimer>
 #include <QHash>
 #include <QList>
+#include <QPointer>
 #include <QSocketNotifier>
 #include <QString>
 #include <QVector>
@@ -25,6 +27,7 @@ class ClientBufferIntegration;
 class ClientBuffer;
 class ClientConnection;
 class Display;
+class IdleScheduler;
 class OutputInterface;
 class OutputDeviceV2Interface;
 class SeatInterface;
@@ -41,6 +44,9 @@ public:
     void registerClientBuffer(ClientBuffer *clientBuffer);
     void unregisterClientBuffer(ClientBuffer *clientBuffer);
 
+    static void logProtocol(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message);
+    void finishRequest();
+
     Display *q;
     QSocketNotifier *socketNotifier = nullptr;
     wl_display *display = nullptr;
@@ -55,6 +61,14 @@ public:
     QHash<::wl_resource *, ClientBuffer *> resourceToBuffer;
     QHash<ClientBuffer *, ClientBufferDestroyListener *> bufferToListener;
     QList<ClientBufferIntegration *> bufferIntegrations;
+    IdleScheduler *idleScheduler = nullptr;
+
+    wl_protocol_logger *protocolLogger = nullptr;
+    QElapsedTimer statisticsClock;
+    // The request being dispatched, its handler time is known once the next message comes in.
+    QPointer<ClientConnection> requestConnection;
+    const char *requestInterface = nullptr;
+    qint64 requestStart = 0;
 };
 
 } // namespace KWaylandServer
@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <DWayland/Server/kwaylandserver_export.h>
+
+#include <QObject>
+
+namespace KWaylandServer
+{
+class Display;
+class FractionalScaleManagerV1InterfacePrivate;
+
+/**
+ * The FractionalScaleManagerV1Interface tells clients the exact scale their surfaces are shown at,
+ * so that they can render buffers which match the physical pixels of fractionally scaled outputs.
+ *
+ * The preferred scale of a surface is the highest OutputInterface::fractionalScale() of the
+ * outputs the surface is on, see SurfaceInterface::preferredScale(). Clients make use of it by
+ * attaching buffers of the scaled size with a buffer scale of 1 and setting the surface size
+ * with the destination of a viewport, see ViewporterInterface.
+ *
+ * FractionalScaleManagerV1Interface corresponds to the Wayland interface @c wp_fractional_scale_manager_v1.
+ */
+class KWAYLANDSERVER_EXPORT FractionalScaleManagerV1Interface : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FractionalScaleManagerV1Interface(Display *display, QObject *parent = nullptr);
+    ~FractionalScaleManagerV1Interface() override;
+
+private:
+    QScopedPointer<FractionalScaleManagerV1InterfacePrivate> d;
+};
+
+} // namespace KWaylandServer
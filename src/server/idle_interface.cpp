@@ -13,6 +13,7 @@ static const quint32 s_version = 1;
 
 IdleInterfacePrivate::IdleInterfacePrivate(IdleInterface *_q, Display *display)
     : QtWaylandServer::org_kde_kwin_idle(*display, s_version)
+    , scheduler(IdleScheduler::get(display))
     , q(_q)
 {
 }
@@ -28,74 +29,60 @@ void IdleInterfacePrivate::org_kde_kwin_idle_get_idle_timeout(Resource *resource
         return;
     }
 
-    IdleTimeoutInterface *idleTimeout = new IdleTimeoutInterface(s, q, idleTimoutResource);
-    idleTimeouts << idleTimeout;
-
-    QObject::connect(idleTimeout, &IdleTimeoutInterface::destroyed, q, [this, idleTimeout]() {
-        idleTimeouts.removeOne(idleTimeout);
-    });
-    idleTimeout->setup(timeout);
+    new IdleTimeoutInterface(s, qMax(timeout, IdleScheduler::MinimumTimeout), scheduler, idleTimoutResource);
 }
 
 IdleInterface::IdleInterface(Display *display, QObject *parent)
     : QObject(parent)
     , d(new IdleInterfacePrivate(this, display))
 {
+    connect(d->scheduler, &IdleScheduler::inhibitedChanged, this, &IdleInterface::inhibitedChanged);
 }
 
 IdleInterface::~IdleInterface() = default;
 
 void IdleInterface::inhibit()
 {
-    d->inhibitCount++;
-    if (d->inhibitCount == 1) {
-        Q_EMIT inhibitedChanged();
-    }
+    d->scheduler->inhibit();
 }
 
 void IdleInterface::uninhibit()
 {
-    d->inhibitCount--;
-    if (d->inhibitCount == 0) {
-        Q_EMIT inhibitedChanged();
-    }
+    d->scheduler->uninhibit();
 }
 
 bool IdleInterface::isInhibited() const
 {
-    return d->inhibitCount > 0;
+    return d->scheduler->isInhibited();
 }
 
 void IdleInterface::simulateUserActivity()
 {
-    for (auto i : qAsConst(d->idleTimeouts)) {
-        i->simulateUserActivity();
-    }
+    d->scheduler->notifyActivity();
+}
+
+void IdleInterface::simulateUserActivity(SeatInterface *seat)
+{
+    d->scheduler->notifyActivity(seat);
 }
 
-IdleTimeoutInterface::IdleTimeoutInterface(SeatInterface *seat, IdleInterface *manager, wl_resource *resource)
-    : QObject()
+IdleTimeoutInterface::IdleTimeoutInterface(SeatInterface *seat, quint32 timeout, IdleScheduler *scheduler, wl_resource *resource)
+    : IdleWatcher(seat, timeout)
     , QtWaylandServer::org_kde_kwin_idle_timeout(resource)
-    , seat(seat)
-    , manager(manager)
+    , scheduler(scheduler)
+{
+    scheduler->addWatcher(this);
+}
+
+void IdleTimeoutInterface::idle()
 {
-    connect(manager, &IdleInterface::inhibitedChanged, this, [this, manager] {
-        if (!timer) {
-            // not yet configured
-            return;
-        }
-        if (manager->isInhibited()) {
-            if (!timer->isActive()) {
-                send_resumed();
-            }
-            timer->stop();
-        } else {
-            timer->start();
-        }
-    });
+    send_idle();
 }
 
-IdleTimeoutInterface::~IdleTimeoutInterface() = default;
+void IdleTimeoutInterface::resumed()
+{
+    send_resumed();
+}
 
 void IdleTimeoutInterface::org_kde_kwin_idle_timeout_release(Resource *resource)
 {
@@ -111,40 +98,10 @@ void IdleTimeoutInterface::org_kde_kwin_idle_timeout_destroy_resource(Resource *
 void IdleTimeoutInterface::org_kde_kwin_idle_timeout_simulate_user_activity(Resource *resource)
 {
     Q_UNUSED(resource)
-    simulateUserActivity();
-}
-void IdleTimeoutInterface::simulateUserActivity()
-{
-    if (!timer) {
-        // not yet configured
-        return;
-    }
-    if (manager->isInhibited()) {
+    if (scheduler->isInhibited()) {
         // ignored while inhibited
         return;
     }
-    if (!timer->isActive()) {
-        send_resumed();
-    }
-    timer->start();
-}
-
-void IdleTimeoutInterface::setup(quint32 timeout)
-{
-    if (timer) {
-        return;
-    }
-    timer = new QTimer(this);
-    timer->setSingleShot(true);
-    // less than 500 msec is not idle by definition
-    timer->setInterval(qMax(timeout, 500u));
-    QObject::connect(timer, &QTimer::timeout, this, [this] {
-        send_idle();
-    });
-    if (manager->isInhibited()) {
-        // don't start if inhibited
-        return;
-    }
-    timer->start();
+    scheduler->notifyActivity(this);
 }
 }
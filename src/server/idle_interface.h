@@ -15,6 +15,7 @@ namespace KWaylandServer
 {
 class Display;
 class IdleInterfacePrivate;
+class SeatInterface;
 
 /**
  * @brief Global representing the org_kde_kwin_idle interface.
@@ -51,6 +52,8 @@ public:
      *
      * To resume idle timeouts invoke @link{uninhibit}. It is possible to invoke inhibit several
      * times, in that case uninhibit needs to called the same amount as inhibit has been called.
+     *
+     * The inhibition is shared with the IdleNotifyV1Interface of the same Display.
      * @see uninhibit
      * @see isInhibited
      * @see inhibitedChanged
@@ -80,8 +83,16 @@ public:
      * This means the same action is performed as if the user interacted with
      * an input device on the SeatInterface.
      * Idle timeouts are resumed and the idle time gets restarted.
+     *
+     * This is cheap enough to be called for every input event, it only records the time
+     * unless some idle timeout is idle.
      */
     void simulateUserActivity();
+    /**
+     * Simulates user activity on @p seat only, idle timeouts of other seats are not affected.
+     * @see simulateUserActivity
+     */
+    void simulateUserActivity(SeatInterface *seat);
 
 Q_SIGNALS:
     /**
@@ -0,0 +1,127 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "idlenotify_v1_interface.h"
+#include "display.h"
+#include "idlescheduler_p.h"
+#include "seat_interface.h"
+
+#include "qwayland-server-ext-idle-notify-v1.h"
+
+static const int s_version = 1;
+
+namespace KWaylandServer
+{
+class IdleNotifyV1InterfacePrivate : public QtWaylandServer::ext_idle_notifier_v1
+{
+public:
+    IdleNotifyV1InterfacePrivate(Display *display);
+
+    IdleScheduler *scheduler;
+
+protected:
+    void ext_idle_notifier_v1_destroy(Resource *resource) override;
+    void ext_idle_notifier_v1_get_idle_notification(Resource *resource, uint32_t id, uint32_t timeout, struct ::wl_resource *seat) override;
+};
+
+class IdleNotificationV1Interface : public IdleWatcher, public QtWaylandServer::ext_idle_notification_v1
+{
+public:
+    IdleNotificationV1Interface(SeatInterface *seat, quint32 timeout, IdleScheduler *scheduler, wl_resource *resource);
+
+protected:
+    void idle() override;
+    void resumed() override;
+
+    void ext_idle_notification_v1_destroy_resource(Resource *resource) override;
+    void ext_idle_notification_v1_destroy(Resource *resource) override;
+};
+
+IdleNotifyV1InterfacePrivate::IdleNotifyV1InterfacePrivate(Display *display)
+    : QtWaylandServer::ext_idle_notifier_v1(*display, s_version)
+    , scheduler(IdleScheduler::get(display))
+{
+}
+
+void IdleNotifyV1InterfacePrivate::ext_idle_notifier_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void IdleNotifyV1InterfacePrivate::ext_idle_notifier_v1_get_idle_notification(Resource *resource,
+                                                                               uint32_t id,
+                                                                               uint32_t timeout,
+                                                                               struct ::wl_resource *seat)
+{
+    wl_resource *notificationResource = wl_resource_create(resource->client(), &ext_idle_notification_v1_interface, resource->version(), id);
+    if (!notificationResource) {
+        wl_client_post_no_memory(resource->client());
+        return;
+    }
+    // like org_kde_kwin_idle, a zero timeout would keep the shared timer busy
+    new IdleNotificationV1Interface(SeatInterface::get(seat), qMax(timeout, IdleScheduler::MinimumTimeout), scheduler, notificationResource);
+}
+
+IdleNotificationV1Interface::IdleNotificationV1Interface(SeatInterface *seat, quint32 timeout, IdleScheduler *scheduler, wl_resource *resource)
+    : IdleWatcher(seat, timeout)
+    , QtWaylandServer::ext_idle_notification_v1(resource)
+{
+    scheduler->addWatcher(this);
+}
+
+void IdleNotificationV1Interface::idle()
+{
+    send_idled();
+}
+
+void IdleNotificationV1Interface::resumed()
+{
+    send_resumed();
+}
+
+void IdleNotificationV1Interface::ext_idle_notification_v1_destroy_resource(Resource *resource)
+{
+    Q_UNUSED(resource)
+    delete this;
+}
+
+void IdleNotificationV1Interface::ext_idle_notification_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+IdleNotifyV1Interface::IdleNotifyV1Interface(Display *display, QObject *parent)
+    : QObject(parent)
+    , d(new IdleNotifyV1InterfacePrivate(display))
+{
+    connect(d->scheduler, &IdleScheduler::inhibitedChanged, this, &IdleNotifyV1Interface::inhibitedChanged);
+}
+
+IdleNotifyV1Interface::~IdleNotifyV1Interface()
+{
+}
+
+void IdleNotifyV1Interface::inhibit()
+{
+    d->scheduler->inhibit();
+}
+
+void IdleNotifyV1Interface::uninhibit()
+{
+    d->scheduler->uninhibit();
+}
+
+bool IdleNotifyV1Interface::isInhibited() const
+{
+    return d->scheduler->isInhibited();
+}
+
+void IdleNotifyV1Interface::simulateUserActivity(SeatInterface *seat)
+{
+    d->scheduler->notifyActivity(seat);
+}
+
+} // namespace KWaylandServer
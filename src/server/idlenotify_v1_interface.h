@@ -0,0 +1,71 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <DWayland/Server/kwaylandserver_export.h>
+
+#include <QObject>
+
+namespace KWaylandServer
+{
+class Display;
+class IdleNotifyV1InterfacePrivate;
+class SeatInterface;
+
+/**
+ * The IdleNotifyV1Interface lets clients get notified when there was no user activity on
+ * a seat for a given amount of time, e.g. to lock the screen or to mark the user as away.
+ *
+ * The compositor reports user activity with simulateUserActivity(), which is cheap enough
+ * to be called for every input event. Idle notifications are not sent while inhibited,
+ * the inhibition is shared with the IdleInterface of the same Display.
+ *
+ * IdleNotifyV1Interface corresponds to the Wayland interface @c ext_idle_notifier_v1.
+ */
+class KWAYLANDSERVER_EXPORT IdleNotifyV1Interface : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IdleNotifyV1Interface(Display *display, QObject *parent = nullptr);
+    ~IdleNotifyV1Interface() override;
+
+    /**
+     * Inhibits idle notifications, notifications that are idle get resumed. Needs to be
+     * balanced with uninhibit.
+     * @see uninhibit
+     * @see isInhibited
+     */
+    void inhibit();
+    /**
+     * Ends the inhibition once uninhibit has been called as often as inhibit, all idle
+     * timeouts start over then.
+     * @see inhibit
+     */
+    void uninhibit();
+    /**
+     * @returns Whether idle notifications are currently inhibited
+     */
+    bool isInhibited() const;
+
+    /**
+     * Records user activity on @p seat, or on all seats if @p seat is @c nullptr.
+     * Idle notifications are resumed and the idle time gets restarted.
+     */
+    void simulateUserActivity(SeatInterface *seat = nullptr);
+
+Q_SIGNALS:
+    /**
+     * Emitted when idle notifications get inhibited or uninhibited.
+     */
+    void inhibitedChanged();
+
+private:
+    QScopedPointer<IdleNotifyV1InterfacePrivate> d;
+};
+
+} // namespace KWaylandServer
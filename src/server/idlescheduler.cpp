@@ -0,0 +1,256 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#include "idlescheduler_p.h"
+#include "display.h"
+#include "display_p.h"
+#include "seat_interface.h"
+
+#include <limits>
+#include <utility>
+
+namespace KWaylandServer
+{
+IdleWatcher::IdleWatcher(SeatInterface *seat, quint32 timeout)
+    : m_seat(seat)
+    , m_timeout(timeout)
+{
+}
+
+IdleWatcher::~IdleWatcher()
+{
+    if (m_scheduler) {
+        m_scheduler->removeWatcher(this);
+    }
+}
+
+IdleScheduler::IdleScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &IdleScheduler::handleTimeout);
+}
+
+IdleScheduler *IdleScheduler::get(Display *display)
+{
+    DisplayPrivate *displayPrivate = DisplayPrivate::get(display);
+    if (!displayPrivate->idleScheduler) {
+        displayPrivate->idleScheduler = new IdleScheduler(display);
+    }
+    return displayPrivate->idleScheduler;
+}
+
+void IdleScheduler::addWatcher(IdleWatcher *watcher)
+{
+    Q_ASSERT(!watcher->m_scheduler);
+    const qint64 now = m_clock.elapsed();
+    watcher->m_scheduler = this;
+    watcher->m_lastActivity = now;
+    watcher->m_deadline = now + watcher->m_timeout;
+    push(watcher);
+    schedule();
+}
+
+void IdleScheduler::removeWatcher(IdleWatcher *watcher)
+{
+    Q_ASSERT(watcher->m_scheduler == this);
+    if (watcher->m_idle) {
+        m_idleWatchers.removeOne(watcher);
+    } else {
+        removeAt(watcher->m_heapIndex);
+    }
+    watcher->m_scheduler = nullptr;
+    // if it was the nearest deadline the timer fires early, that is harmless
+}
+
+void IdleScheduler::notifyActivity(SeatInterface *seat)
+{
+    const qint64 now = m_clock.elapsed();
+    if (seat) {
+        auto it = m_seatActivity.find(seat);
+        if (it == m_seatActivity.end()) {
+            it = m_seatActivity.insert(seat, now);
+            connect(seat, &QObject::destroyed, this, [this, seat] {
+                m_seatActivity.remove(seat);
+            });
+        }
+        *it = now;
+    } else {
+        m_lastActivity = now;
+    }
+
+    // The deadlines in the heap are moved lazily, only idle watchers need to be woken up.
+    if (m_idleWatchers.isEmpty()) {
+        return;
+    }
+    for (int i = 0; i < m_idleWatchers.count();) {
+        IdleWatcher *watcher = m_idleWatchers.at(i);
+        if (seat && watcher->m_seat != seat) {
+            ++i;
+            continue;
+        }
+        m_idleWatchers.remove(i);
+        resume(watcher, now);
+    }
+    schedule();
+}
+
+void IdleScheduler::notifyActivity(IdleWatcher *watcher)
+{
+    const qint64 now = m_clock.elapsed();
+    watcher->m_lastActivity = now;
+    if (watcher->m_idle) {
+        m_idleWatchers.removeOne(watcher);
+        resume(watcher, now);
+        schedule();
+    }
+}
+
+void IdleScheduler::inhibit()
+{
+    m_inhibitCount++;
+    if (m_inhibitCount != 1) {
+        return;
+    }
+    const qint64 now = m_clock.elapsed();
+    const QVector<IdleWatcher *> idleWatchers = std::exchange(m_idleWatchers, {});
+    for (IdleWatcher *watcher : idleWatchers) {
+        resume(watcher, now);
+    }
+    m_timer.stop();
+    Q_EMIT inhibitedChanged();
+}
+
+void IdleScheduler::uninhibit()
+{
+    m_inhibitCount--;
+    if (m_inhibitCount != 0) {
+        return;
+    }
+    // all idle timeouts start over
+    m_lastActivity = m_clock.elapsed();
+    schedule();
+    Q_EMIT inhibitedChanged();
+}
+
+bool IdleScheduler::isInhibited() const
+{
+    return m_inhibitCount > 0;
+}
+
+qint64 IdleScheduler::lastActivity(const IdleWatcher *watcher) const
+{
+    return qMax(qMax(m_lastActivity, m_seatActivity.value(watcher->m_seat)), watcher->m_lastActivity);
+}
+
+void IdleScheduler::resume(IdleWatcher *watcher, qint64 now)
+{
+    watcher->m_idle = false;
+    watcher->m_deadline = now + watcher->m_timeout;
+    push(watcher);
+    watcher->resumed();
+}
+
+void IdleScheduler::schedule()
+{
+    if (m_inhibitCount > 0 || m_heap.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+    const qint64 deadline = m_heap.first()->m_deadline;
+    if (m_timer.isActive() && m_armedDeadline <= deadline) {
+        return;
+    }
+    m_armedDeadline = deadline;
+    const qint64 interval = qBound<qint64>(0, deadline - m_clock.elapsed(), std::numeric_limits<int>::max());
+    m_timer.start(int(interval));
+}
+
+void IdleScheduler::handleTimeout()
+{
+    const qint64 now = m_clock.elapsed();
+    while (!m_heap.isEmpty()) {
+        IdleWatcher *watcher = m_heap.first();
+        const qint64 deadline = lastActivity(watcher) + watcher->m_timeout;
+        if (deadline > now) {
+            if (deadline == watcher->m_deadline) {
+                break;
+            }
+            // there was activity since the watcher got sorted in
+            watcher->m_deadline = deadline;
+            siftDown(0);
+            continue;
+        }
+        removeAt(0);
+        watcher->m_idle = true;
+        m_idleWatchers.append(watcher);
+        watcher->idle();
+    }
+    schedule();
+}
+
+void IdleScheduler::push(IdleWatcher *watcher)
+{
+    watcher->m_heapIndex = m_heap.count();
+    m_heap.append(watcher);
+    siftUp(watcher->m_heapIndex);
+}
+
+void IdleScheduler::removeAt(int index)
+{
+    IdleWatcher *watcher = m_heap.at(index);
+    IdleWatcher *last = m_heap.takeLast();
+    watcher->m_heapIndex = -1;
+    if (last != watcher) {
+        m_heap[index] = last;
+        last->m_heapIndex = index;
+        siftDown(index);
+        siftUp(last->m_heapIndex);
+    }
+}
+
+void IdleScheduler::siftUp(int index)
+{
+    IdleWatcher *watcher = m_heap.at(index);
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        IdleWatcher *parentWatcher = m_heap.at(parent);
+        if (parentWatcher->m_deadline <= watcher->m_deadline) {
+            break;
+        }
+        m_heap[index] = parentWatcher;
+        parentWatcher->m_heapIndex = index;
+        index = parent;
+    }
+    m_heap[index] = watcher;
+    watcher->m_heapIndex = index;
+}
+
+void IdleScheduler::siftDown(int index)
+{
+    IdleWatcher *watcher = m_heap.at(index);
+    const int count = m_heap.count();
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && m_heap.at(child + 1)->m_deadline < m_heap.at(child)->m_deadline) {
+            ++child;
+        }
+        IdleWatcher *childWatcher = m_heap.at(child);
+        if (watcher->m_deadline <= childWatcher->m_deadline) {
+            break;
+        }
+        m_heap[index] = childWatcher;
+        childWatcher->m_heapIndex = index;
+        index = child;
+    }
+    m_heap[index] = watcher;
+    watcher->m_heapIndex = index;
+}
+
+}
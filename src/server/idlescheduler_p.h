@@ -0,0 +1,130 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+namespace KWaylandServer
+{
+class Display;
+class IdleScheduler;
+class SeatInterface;
+
+/**
+ * An idle timeout registered with the IdleScheduler.
+ *
+ * The watcher becomes idle once there was no activity on its seat for timeout() msec,
+ * the scheduler invokes idle() then and resumed() on the next activity.
+ */
+class IdleWatcher
+{
+public:
+    IdleWatcher(SeatInterface *seat, quint32 timeout);
+    virtual ~IdleWatcher();
+
+    SeatInterface *seat() const
+    {
+        return m_seat;
+    }
+    quint32 timeout() const
+    {
+        return m_timeout;
+    }
+    bool isIdle() const
+    {
+        return m_idle;
+    }
+
+protected:
+    virtual void idle() = 0;
+    virtual void resumed() = 0;
+
+private:
+    friend class IdleScheduler;
+    IdleScheduler *m_scheduler = nullptr;
+    SeatInterface *m_seat;
+    quint32 m_timeout;
+    // activity reported for this watcher only, e.g. org_kde_kwin_idle_timeout.simulate_user_activity
+    qint64 m_lastActivity = 0;
+    // the deadline the watcher is sorted by, it lags behind activity and is corrected when due
+    qint64 m_deadline = 0;
+    int m_heapIndex = -1;
+    bool m_idle = false;
+
+    Q_DISABLE_COPY(IdleWatcher)
+};
+
+/**
+ * Drives all idle timeouts of a Display with one timer.
+ *
+ * Activity only stores a monotonic timestamp per seat, so an input event doesn't touch
+ * the watchers unless some of them are idle. The watchers that are not idle are kept in
+ * a binary heap ordered by deadline, and the timer is armed for the nearest one. When it
+ * fires, watchers that had activity in the meantime are moved to their new deadline.
+ *
+ * The scheduler is shared by the org_kde_kwin_idle and ext_idle_notifier_v1 globals, so
+ * inhibition applies to both of them.
+ */
+class IdleScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Timeouts shorter than this are raised to it, less than 500 msec is not idle by definition.
+     */
+    static constexpr quint32 MinimumTimeout = 500;
+
+    static IdleScheduler *get(Display *display);
+
+    void addWatcher(IdleWatcher *watcher);
+    void removeWatcher(IdleWatcher *watcher);
+
+    /**
+     * Records user activity on @p seat, or on all seats if @p seat is @c nullptr.
+     */
+    void notifyActivity(SeatInterface *seat = nullptr);
+    /**
+     * Records activity for @p watcher only.
+     */
+    void notifyActivity(IdleWatcher *watcher);
+
+    void inhibit();
+    void uninhibit();
+    bool isInhibited() const;
+
+Q_SIGNALS:
+    void inhibitedChanged();
+
+private:
+    explicit IdleScheduler(QObject *parent);
+
+    qint64 lastActivity(const IdleWatcher *watcher) const;
+    void resume(IdleWatcher *watcher, qint64 now);
+    void schedule();
+    void handleTimeout();
+
+    void push(IdleWatcher *watcher);
+    void removeAt(int index);
+    void siftUp(int index);
+    void siftDown(int index);
+
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    qint64 m_armedDeadline = 0;
+    // activity on all seats, the seats that have reported activity of their own are tracked separately
+    qint64 m_lastActivity = 0;
+    QHash<SeatInterface *, qint64> m_seatActivity;
+    QVector<IdleWatcher *> m_heap;
+    QVector<IdleWatcher *> m_idleWatchers;
+    int m_inhibitCount = 0;
+};
+
+}
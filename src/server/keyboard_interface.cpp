@@ -48,14 +48,14 @@ void KeyboardInterfacePrivate::keyboard_bind_resource(Resource *resource)
     }
 }
 
-QList<KeyboardInterfacePrivate::Resource *> KeyboardInterfacePrivate::keyboardsForClient(ClientConnection *client) const
+const QVector<KeyboardInterfacePrivate::Resource *> &KeyboardInterfacePrivate::keyboardsForClient(ClientConnection *client) const
 {
-    return resourceMap().values(client->client());
+    return resourcesForClient(client->client());
 }
 
 void KeyboardInterfacePrivate::sendLeave(SurfaceInterface *surface, quint32 serial)
 {
-    const QList<Resource *> keyboards = keyboardsForClient(surface->client());
+    const QVector<Resource *> &keyboards = keyboardsForClient(surface->client());
     for (Resource *keyboardResource : keyboards) {
         send_leave(keyboardResource->handle, serial, surface->resource());
     }
@@ -66,7 +66,7 @@ void KeyboardInterfacePrivate::sendEnter(SurfaceInterface *surface, quint32 seri
     const auto states = pressedKeys();
     QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(states.constData()), sizeof(quint32) * states.size());
 
-    const QList<Resource *> keyboards = keyboardsForClient(surface->client());
+    const QVector<Resource *> &keyboards = keyboardsForClient(surface->client());
     for (Resource *keyboardResource : keyboards) {
         send_enter(keyboardResource->handle, serial, surface->resource(), data);
     }
@@ -74,6 +74,12 @@ void KeyboardInterfacePrivate::sendEnter(SurfaceInterface *surface, quint32 seri
 
 void KeyboardInterfacePrivate::sendKeymap(Resource *resource)
 {
+    if (keymapFile.isValid()) {
+        send_keymap(resource->handle, keymap_format::keymap_format_xkb_v1, keymapFile.fd(), keymapFile.size());
+        return;
+    }
+
+    // fallback without sealed files: every client gets a private copy it may scribble on
     QScopedPointer<QTemporaryFile> tmp(new QTemporaryFile());
     if (!tmp->open()) {
         qCWarning(KWAYLAND_SERVER) << "Failed to create keymap file:" << tmp->errorString();
@@ -81,21 +87,23 @@ void KeyboardInterfacePrivate::sendKeymap(Resource *resource)
     }
 
     unlink(tmp->fileName().toUtf8().constData());
-    if (!tmp->resize(keymap.size())) {
+    // include the terminating null byte, like the sealed file
+    const qint64 size = keymap.size() + 1;
+    if (!tmp->resize(size)) {
         qCWarning(KWAYLAND_SERVER) << "Failed to resize keymap file:" << tmp->errorString();
         return;
     }
 
-    uchar *address = tmp->map(0, keymap.size());
+    uchar *address = tmp->map(0, size);
     if (!address) {
         qCWarning(KWAYLAND_SERVER) << "Failed to map keymap file:" << tmp->errorString();
         return;
     }
 
-    qstrncpy(reinterpret_cast<char *>(address), keymap.constData(), keymap.size() + 1);
+    qstrncpy(reinterpret_cast<char *>(address), keymap.constData(), size);
     tmp->unmap(address);
 
-    send_keymap(resource->handle, keymap_format::keymap_format_xkb_v1, tmp->handle(), tmp->size());
+    send_keymap(resource->handle, keymap_format::keymap_format_xkb_v1, tmp->handle(), size);
 }
 
 void KeyboardInterface::setKeymap(const QByteArray &content)
@@ -104,9 +112,15 @@ void KeyboardInterface::setKeymap(const QByteArray &content)
         return;
     }
 
-    d->keymap = content;
+    if (d->keymap != content) {
+        d->keymap = content;
+        // include the terminating null byte, clients are allowed to parse the keymap as a string
+        if (!d->keymapFile.create("dwayland-keymap", d->keymap.constData(), d->keymap.size() + 1)) {
+            qCDebug(KWAYLAND_SERVER) << "Sealed keymap file is not available, using a file per client";
+        }
+    }
 
-    const auto keyboardResources = d->resourceMap();
+    const auto &keyboardResources = d->resourceMap();
     for (KeyboardInterfacePrivate::Resource *resource : keyboardResources) {
         d->sendKeymap(resource);
     }
@@ -114,7 +128,7 @@ void KeyboardInterface::setKeymap(const QByteArray &content)
 
 void KeyboardInterfacePrivate::sendModifiers(quint32 depressed, quint32 latched, quint32 locked, quint32 group, quint32 serial)
 {
-    const QList<Resource *> keyboards = keyboardsForClient(focusedSurface->client());
+    const QVector<Resource *> &keyboards = keyboardsForClient(focusedSurface->client());
     for (Resource *keyboardResource : keyboards) {
         send_modifiers(keyboardResource->handle, serial, depressed, latched, locked, group);
     }
@@ -191,7 +205,7 @@ void KeyboardInterface::sendKey(quint32 key, KeyboardKeyState state)
         return;
     }
 
-    const QList<KeyboardInterfacePrivate::Resource *> keyboards = d->keyboardsForClient(d->focusedSurface->client());
+    const QVector<KeyboardInterfacePrivate::Resource *> &keyboards = d->keyboardsForClient(d->focusedSurface->client());
     const quint32 serial = d->seat->display()->nextSerial();
     for (KeyboardInterfacePrivate::Resource *keyboardResource : keyboards) {
         d->send_key(keyboardResource->handle, serial, d->seat->timestamp(), key, quint32(state));
@@ -226,7 +240,7 @@ void KeyboardInterface::setRepeatInfo(qint32 charactersPerSecond, qint32 delay)
 {
     d->keyRepeat.charactersPerSecond = qMax(charactersPerSecond, 0);
     d->keyRepeat.delay = qMax(delay, 0);
-    const QList<KeyboardInterfacePrivate::Resource *> keyboards = d->resourceMap().values();
+    const auto &keyboards = d->resourceMap();
     for (KeyboardInterfacePrivate::Resource *keyboardResource : keyboards) {
         if (keyboardResource->version() >= WL_KEYBOARD_REPEAT_INFO_SINCE_VERSION) {
             d->send_repeat_info(keyboardResource->handle, d->keyRepeat.charactersPerSecond, d->keyRepeat.delay);
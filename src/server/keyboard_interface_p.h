@@ -6,6 +6,7 @@
 #pragma once
 
 #include "keyboard_interface.h"
+#include "utils/sealed_file.h"
 
 #include <qwayland-server-wayland.h>
 
@@ -25,7 +26,7 @@ public:
     void sendModifiers();
     void sendModifiers(quint32 depressed, quint32 latched, quint32 locked, quint32 group, quint32 serial);
 
-    QList<Resource *> keyboardsForClient(ClientConnection *client) const;
+    const QVector<Resource *> &keyboardsForClient(ClientConnection *client) const;
     void sendLeave(SurfaceInterface *surface, quint32 serial);
     void sendEnter(SurfaceInterface *surface, quint32 serial);
 
@@ -38,6 +39,8 @@ public:
     SurfaceInterface *focusedSurface = nullptr;
     QMetaObject::Connection destroyConnection;
     QByteArray keymap;
+    // shared by all wl_keyboard resources, invalid if sealed files are not supported
+    SealedFile keymapFile;
 
     struct {
         qint32 charactersPerSecond = 0;
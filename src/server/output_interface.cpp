@@ -14,6 +14,8 @@
 #include <QPointer>
 #include <QVector>
 
+#include <cmath>
+
 namespace KWaylandServer
 {
 static const int s_version = 3;
@@ -37,6 +39,7 @@ public:
     QString manufacturer = QStringLiteral("org.kde.kwin");
     QString model = QStringLiteral("none");
     int scale = 1;
+    qreal fractionalScale = 1;
     OutputInterface::SubPixel subPixel = OutputInterface::SubPixel::Unknown;
     OutputInterface::Transform transform = OutputInterface::Transform::Normal;
     OutputInterface::Mode mode;
@@ -298,17 +301,34 @@ int OutputInterface::scale() const
 
 void OutputInterface::setScale(int scale)
 {
-    if (d->scale == scale) {
+    setFractionalScale(scale);
+}
+
+qreal OutputInterface::fractionalScale() const
+{
+    return d->fractionalScale;
+}
+
+void OutputInterface::setFractionalScale(qreal scale)
+{
+    if (qFuzzyCompare(d->fractionalScale, scale)) {
         return;
     }
-    d->scale = scale;
+    d->fractionalScale = scale;
 
-    const auto outputResources = d->resourceMap();
-    for (OutputInterfacePrivate::Resource *resource : outputResources) {
-        d->sendScale(resource);
+    const int integerScale = std::ceil(scale);
+    if (d->scale != integerScale) {
+        d->scale = integerScale;
+
+        const auto &outputResources = d->resourceMap();
+        for (OutputInterfacePrivate::Resource *resource : outputResources) {
+            d->sendScale(resource);
+        }
+
+        Q_EMIT scaleChanged(d->scale);
     }
 
-    Q_EMIT scaleChanged(d->scale);
+    Q_EMIT fractionalScaleChanged(d->fractionalScale);
 }
 
 OutputInterface::SubPixel OutputInterface::subPixel() const
@@ -77,6 +77,11 @@ public:
     QSize pixelSize() const;
     int refreshRate() const;
     int scale() const;
+    /**
+     * The exact scale of the output, which may be fractional. scale() is this scale rounded up.
+     * @see setFractionalScale
+     */
+    qreal fractionalScale() const;
     SubPixel subPixel() const;
     Transform transform() const;
     Mode mode() const;
@@ -87,7 +92,17 @@ public:
     void setGlobalPosition(const QPoint &pos);
     void setManufacturer(const QString &manufacturer);
     void setModel(const QString &model);
+    /**
+     * Sets the integer scale announced through wl_output. This also sets the fractional scale.
+     */
     void setScale(int scale);
+    /**
+     * Sets the exact @p scale of the output. The wl_output scale becomes @p scale rounded up,
+     * clients that support fractional scaling get the exact scale for their surfaces.
+     * Default is @c 1.
+     * @see FractionalScaleManagerV1Interface
+     */
+    void setFractionalScale(qreal scale);
     void setSubPixel(SubPixel subPixel);
     void setTransform(Transform transform);
     void setMode(const Mode &mode);
@@ -134,6 +149,7 @@ Q_SIGNALS:
     void pixelSizeChanged(const QSize &);
     void refreshRateChanged(int);
     void scaleChanged(int);
+    void fractionalScaleChanged(qreal);
     void subPixelChanged(SubPixel);
     void transformChanged(Transform);
     void modeChanged();
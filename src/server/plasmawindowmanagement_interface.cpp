@@ -9,21 +9,113 @@
 #include "plasmavirtualdesktop_interface.h"
 #include "surface_interface.h"
 
+#include <QCryptographicHash>
 #include <QFile>
 #include <QHash>
 #include <QIcon>
+#include <QImage>
 #include <QList>
+#include <QMutex>
+#include <QPixmap>
 #include <QRect>
+#include <QSharedPointer>
 #include <QUuid>
 #include <QVector>
 #include <QtConcurrentRun>
 
+#include <qwayland-server-dde-plasma-window-management.h>
 #include <qwayland-server-plasma-window-management.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace KWaylandServer
 {
 static const quint32 s_version = 14;
 static const quint32 s_activationVersion = 1;
+static const quint32 s_extensionVersion = 3;
+
+struct StackingOrderChange {
+    enum class Type {
+        Insert,
+        Move,
+        Remove,
+    };
+    Type type;
+    QString uuid;
+    QString sibling;
+};
+
+/**
+ * A window icon and the hash of its content. All windows showing the same icon share one
+ * instance, which serializes the icon at most once, on the first get_icon request.
+ */
+class PlasmaWindowIconData
+{
+public:
+    /**
+     * @returns the shared data for @p icon, @c null for a null icon.
+     */
+    static QSharedPointer<PlasmaWindowIconData> get(const QIcon &icon);
+
+    /**
+     * The icon as written into the get_icon pipe. Thread safe.
+     */
+    QByteArray serialized();
+
+    const QIcon icon;
+    const QByteArray hash;
+
+private:
+    PlasmaWindowIconData(const QIcon &icon, const QByteArray &hash);
+
+    QMutex mutex;
+    QByteArray data;
+    bool isSerialized = false;
+
+    static QHash<QByteArray, QWeakPointer<PlasmaWindowIconData>> s_icons;
+    static int s_pruneThreshold;
+};
+
+class PlasmaWindowManagementExtension : public QtWaylandServer::dde_plasma_window_management
+{
+public:
+    PlasmaWindowManagementExtension(PlasmaWindowManagementInterfacePrivate *wm, Display *display);
+
+    PlasmaWindowManagementInterfacePrivate *wm;
+
+protected:
+    void dde_plasma_window_management_destroy(Resource *resource) override;
+    void dde_plasma_window_management_get_stacking_order(Resource *resource, uint32_t id, wl_resource *management) override;
+    void dde_plasma_window_management_get_window(Resource *resource, uint32_t id, wl_resource *window) override;
+};
+
+class PlasmaWindowExtension : public QtWaylandServer::dde_plasma_window
+{
+public:
+    explicit PlasmaWindowExtension(PlasmaWindowInterfacePrivate *window);
+
+    PlasmaWindowInterfacePrivate *window;
+
+protected:
+    void dde_plasma_window_destroy(Resource *resource) override;
+    void dde_plasma_window_destroy_resource(Resource *resource) override;
+};
+
+class PlasmaStackingOrderDeltas : public QtWaylandServer::dde_plasma_stacking_order
+{
+public:
+    explicit PlasmaStackingOrderDeltas(PlasmaWindowManagementInterfacePrivate *wm);
+
+    void sendReset(wl_resource *resource, const QVector<QString> &uuids);
+    void sendChanges(wl_resource *resource, const QVector<StackingOrderChange> &changes);
+
+    PlasmaWindowManagementInterfacePrivate *wm;
+
+protected:
+    void dde_plasma_stacking_order_destroy(Resource *resource) override;
+    void dde_plasma_stacking_order_destroy_resource(Resource *resource) override;
+};
 
 class PlasmaWindowManagementInterfacePrivate : public QtWaylandServer::org_kde_plasma_window_management
 {
@@ -33,8 +125,9 @@ public:
     void sendShowingDesktopState(wl_resource *resource);
     void sendStackingOrderChanged();
     void sendStackingOrderChanged(wl_resource *resource);
-    void sendStackingOrderUuidsChanged();
+    void sendStackingOrderUuidsChanged(const QVector<QString> &previousUuids);
     void sendStackingOrderUuidsChanged(wl_resource *resource);
+    QString joinedStackingOrderUuids() const;
 
     PlasmaWindowManagementInterface::ShowingDesktopState state = PlasmaWindowManagementInterface::ShowingDesktopState::Disabled;
     QList<PlasmaWindowInterface *> windows;
@@ -44,8 +137,14 @@ public:
     QVector<QString> stackingOrderUuids;
     PlasmaWindowManagementInterface *q;
 
+    PlasmaWindowManagementExtension extension;
+    PlasmaStackingOrderDeltas stackingOrderDeltas;
+    // org_kde_plasma_window_management resource -> dde_plasma_stacking_order resource
+    QHash<wl_resource *, wl_resource *> stackingOrderDeltaResources;
+
 protected:
     void org_kde_plasma_window_management_bind_resource(Resource *resource) override;
+    void org_kde_plasma_window_management_destroy_resource(Resource *resource) override;
     void org_kde_plasma_window_management_show_desktop(Resource *resource, uint32_t state) override;
     void org_kde_plasma_window_management_get_window(Resource *resource, uint32_t id, uint32_t internal_window_id) override;
     void org_kde_plasma_window_management_get_window_by_uuid(Resource *resource, uint32_t id, const QString &internal_window_uuid) override;
@@ -68,8 +167,23 @@ public:
     void setGeometry(const QRect &geometry);
     void setApplicationMenuPaths(const QString &service, const QString &object);
     void setWindowId(quint32 winid);
+    void beginUpdate();
+    void commitUpdate();
+    void addExtension(wl_client *client, uint32_t id, int version, wl_resource *window);
     wl_resource *resourceForParent(PlasmaWindowInterface *parent, Resource *child) const;
 
+private:
+    void sendTitle();
+    void sendAppId();
+    void sendPid();
+    void sendState();
+    void sendGeometry();
+    void sendApplicationMenu();
+    void sendThemedIconName();
+    void sendIcon();
+    void sendDone();
+
+public:
     quint32 windowId = 0;
     QHash<SurfaceInterface *, QRect> minimizedGeometries;
     PlasmaWindowManagementInterface *wm;
@@ -88,11 +202,31 @@ public:
     QString m_appServiceName;
     QString m_appObjectPath;
     QIcon m_icon;
+    QSharedPointer<PlasmaWindowIconData> iconData;
     quint32 m_state = 0;
     QString uuid;
 
+    PlasmaWindowExtension extension;
+    // org_kde_plasma_window resource -> dde_plasma_window resource
+    QHash<wl_resource *, wl_resource *> extensionResources;
+
+    // The properties as the clients know them while an update is in progress.
+    struct {
+        QString title;
+        QString appId;
+        quint32 pid = 0;
+        quint32 state = 0;
+        QRect geometry;
+        QString appServiceName;
+        QString appObjectPath;
+        QString themedIconName;
+        QSharedPointer<PlasmaWindowIconData> iconData;
+    } committed;
+    int updateDepth = 0;
+
 protected:
     void org_kde_plasma_window_bind_resource(Resource *resource) override;
+    void org_kde_plasma_window_destroy_resource(Resource *resource) override;
     void org_kde_plasma_window_set_state(Resource *resource, uint32_t flags, uint32_t state) override;
     void org_kde_plasma_window_set_virtual_desktop(Resource *resource, uint32_t number) override;
     void org_kde_plasma_window_set_minimized_geometry(Resource *resource, wl_resource *panel, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
@@ -110,9 +244,238 @@ protected:
     void org_kde_plasma_window_send_to_output(Resource *resource, struct wl_resource *output) override;
 };
 
+/**
+ * Computes the changes that turn @p from into @p to. The windows on a longest run which already
+ * is in the right relative order keep their place, all other windows are moved or inserted
+ * directly above their new lower neighbour, so raising a single window results in one change.
+ *
+ * Returns @c false if sending @p to as a whole is at least as cheap.
+ */
+static bool diffStackingOrder(const QVector<QString> &from, const QVector<QString> &to, QVector<StackingOrderChange> *changes)
+{
+    QHash<QString, int> toIndex;
+    toIndex.reserve(to.size());
+    for (int i = 0; i < to.size(); ++i) {
+        toIndex.insert(to[i], i);
+    }
+    if (toIndex.size() != to.size()) {
+        return false;
+    }
+
+    // The new positions of the windows which stay, in their current order.
+    QVector<int> positions;
+    positions.reserve(from.size());
+    QVector<bool> present(to.size(), false);
+    for (const QString &uuid : from) {
+        const auto it = toIndex.constFind(uuid);
+        if (it == toIndex.constEnd()) {
+            changes->append({StackingOrderChange::Type::Remove, uuid, QString()});
+            continue;
+        }
+        if (present[*it]) {
+            return false;
+        }
+        present[*it] = true;
+        positions.append(*it);
+    }
+
+    // Longest increasing subsequence of positions, O(n log n).
+    QVector<int> tails;
+    QVector<int> predecessors(positions.size(), -1);
+    for (int i = 0; i < positions.size(); ++i) {
+        auto it = std::lower_bound(tails.begin(), tails.end(), positions[i], [&positions](int index, int position) {
+            return positions[index] < position;
+        });
+        if (it != tails.begin()) {
+            predecessors[i] = *(it - 1);
+        }
+        if (it == tails.end()) {
+            tails.append(i);
+        } else {
+            *it = i;
+        }
+    }
+    QVector<bool> stable(to.size(), false);
+    for (int i = tails.isEmpty() ? -1 : tails.last(); i != -1; i = predecessors[i]) {
+        stable[positions[i]] = true;
+    }
+
+    for (int i = 0; i < to.size(); ++i) {
+        if (stable[i]) {
+            continue;
+        }
+        changes->append({present[i] ? StackingOrderChange::Type::Move : StackingOrderChange::Type::Insert, to[i], i > 0 ? to[i - 1] : QString()});
+    }
+    return changes->size() < to.size();
+}
+
+QHash<QByteArray, QWeakPointer<PlasmaWindowIconData>> PlasmaWindowIconData::s_icons;
+int PlasmaWindowIconData::s_pruneThreshold = 64;
+
+PlasmaWindowIconData::PlasmaWindowIconData(const QIcon &icon, const QByteArray &hash)
+    : icon(icon)
+    , hash(hash)
+{
+}
+
+QSharedPointer<PlasmaWindowIconData> PlasmaWindowIconData::get(const QIcon &icon)
+{
+    if (icon.isNull()) {
+        return QSharedPointer<PlasmaWindowIconData>();
+    }
+
+    // Hashing the pixels is a lot cheaper than serializing, which encodes them as PNG.
+    QCryptographicHash contentHash(QCryptographicHash::Sha256);
+    contentHash.addData(icon.name().toUtf8());
+    const auto sizes = icon.availableSizes();
+    for (const QSize &size : sizes) {
+        const QImage image = icon.pixmap(size).toImage();
+        contentHash.addData(QByteArray::number(image.width()) + 'x' + QByteArray::number(image.height()) + '@' + QByteArray::number(image.format()));
+        contentHash.addData(reinterpret_cast<const char *>(image.constBits()), image.sizeInBytes());
+    }
+    const QByteArray hash = contentHash.result().toHex();
+
+    QSharedPointer<PlasmaWindowIconData> data = s_icons.value(hash).toStrongRef();
+    if (data) {
+        return data;
+    }
+    data.reset(new PlasmaWindowIconData(icon, hash));
+    s_icons.insert(hash, data);
+
+    if (s_icons.size() >= s_pruneThreshold) {
+        for (auto it = s_icons.begin(); it != s_icons.end();) {
+            if (it.value().isNull()) {
+                it = s_icons.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        s_pruneThreshold = qMax(64, s_icons.size() * 2);
+    }
+    return data;
+}
+
+QByteArray PlasmaWindowIconData::serialized()
+{
+    QMutexLocker locker(&mutex);
+    if (!isSerialized) {
+        QDataStream ds(&data, QIODevice::WriteOnly);
+        ds << icon;
+        isSerialized = true;
+    }
+    return data;
+}
+
+PlasmaWindowManagementExtension::PlasmaWindowManagementExtension(PlasmaWindowManagementInterfacePrivate *wm, Display *display)
+    : QtWaylandServer::dde_plasma_window_management(*display, s_extensionVersion)
+    , wm(wm)
+{
+}
+
+void PlasmaWindowManagementExtension::dde_plasma_window_management_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void PlasmaWindowManagementExtension::dde_plasma_window_management_get_stacking_order(Resource *resource, uint32_t id, wl_resource *management)
+{
+    Resource *deltas = wm->stackingOrderDeltas.add(resource->client(), id, resource->version());
+    auto managementResource = PlasmaWindowManagementInterfacePrivate::Resource::fromResource(management);
+    if (!managementResource || managementResource->object() != wm) {
+        // Belongs to another window management global, leave the object inert.
+        return;
+    }
+    wm->stackingOrderDeltaResources.insert(management, deltas->handle);
+    wm->stackingOrderDeltas.sendReset(deltas->handle, wm->stackingOrderUuids);
+}
+
+void PlasmaWindowManagementExtension::dde_plasma_window_management_get_window(Resource *resource, uint32_t id, wl_resource *window)
+{
+    auto windowResource = PlasmaWindowInterfacePrivate::Resource::fromResource(window);
+    auto windowPrivate = windowResource ? static_cast<PlasmaWindowInterfacePrivate *>(windowResource->object()) : nullptr;
+    if (!windowPrivate) {
+        // The window is gone already, hand out an inert object.
+        PlasmaWindowExtension extension(nullptr);
+        extension.add(resource->client(), id, resource->version());
+        return;
+    }
+    windowPrivate->addExtension(resource->client(), id, resource->version(), window);
+}
+
+PlasmaWindowExtension::PlasmaWindowExtension(PlasmaWindowInterfacePrivate *window)
+    : QtWaylandServer::dde_plasma_window()
+    , window(window)
+{
+}
+
+void PlasmaWindowExtension::dde_plasma_window_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void PlasmaWindowExtension::dde_plasma_window_destroy_resource(Resource *resource)
+{
+    for (auto it = window->extensionResources.begin(); it != window->extensionResources.end(); ++it) {
+        if (it.value() == resource->handle) {
+            window->extensionResources.erase(it);
+            return;
+        }
+    }
+}
+
+PlasmaStackingOrderDeltas::PlasmaStackingOrderDeltas(PlasmaWindowManagementInterfacePrivate *wm)
+    : QtWaylandServer::dde_plasma_stacking_order()
+    , wm(wm)
+{
+}
+
+void PlasmaStackingOrderDeltas::sendReset(wl_resource *resource, const QVector<QString> &uuids)
+{
+    send_reset(resource);
+    for (int i = 0; i < uuids.size(); ++i) {
+        send_insert(resource, uuids[i], i > 0 ? uuids[i - 1] : QString());
+    }
+    send_done(resource);
+}
+
+void PlasmaStackingOrderDeltas::sendChanges(wl_resource *resource, const QVector<StackingOrderChange> &changes)
+{
+    for (const StackingOrderChange &change : changes) {
+        switch (change.type) {
+        case StackingOrderChange::Type::Insert:
+            send_insert(resource, change.uuid, change.sibling);
+            break;
+        case StackingOrderChange::Type::Move:
+            send_move(resource, change.uuid, change.sibling);
+            break;
+        case StackingOrderChange::Type::Remove:
+            send_remove(resource, change.uuid);
+            break;
+        }
+    }
+    send_done(resource);
+}
+
+void PlasmaStackingOrderDeltas::dde_plasma_stacking_order_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void PlasmaStackingOrderDeltas::dde_plasma_stacking_order_destroy_resource(Resource *resource)
+{
+    for (auto it = wm->stackingOrderDeltaResources.begin(); it != wm->stackingOrderDeltaResources.end(); ++it) {
+        if (it.value() == resource->handle) {
+            wm->stackingOrderDeltaResources.erase(it);
+            return;
+        }
+    }
+}
+
 PlasmaWindowManagementInterfacePrivate::PlasmaWindowManagementInterfacePrivate(PlasmaWindowManagementInterface *_q, Display *display)
     : QtWaylandServer::org_kde_plasma_window_management(*display, s_version)
     , q(_q)
+    , extension(this, display)
+    , stackingOrderDeltas(this)
 {
 }
 
@@ -158,11 +521,38 @@ void PlasmaWindowManagementInterfacePrivate::sendStackingOrderChanged(wl_resourc
     send_stacking_order_changed(r, QByteArray::fromRawData(reinterpret_cast<const char *>(stackingOrder.constData()), sizeof(uint32_t) * stackingOrder.size()));
 }
 
-void PlasmaWindowManagementInterfacePrivate::sendStackingOrderUuidsChanged()
+void PlasmaWindowManagementInterfacePrivate::sendStackingOrderUuidsChanged(const QVector<QString> &previousUuids)
 {
+    // Both the joined list and the diff are only computed once and only if someone needs them.
+    QString joinedUuids;
+    bool joined = false;
+    QVector<StackingOrderChange> changes;
+    bool diffed = false;
+    bool reset = false;
+
     const auto clientResources = resourceMap();
     for (auto resource : clientResources) {
-        sendStackingOrderUuidsChanged(resource->handle);
+        wl_resource *deltas = stackingOrderDeltaResources.value(resource->handle);
+        if (deltas) {
+            if (!diffed) {
+                reset = !diffStackingOrder(previousUuids, stackingOrderUuids, &changes);
+                diffed = true;
+            }
+            if (reset) {
+                stackingOrderDeltas.sendReset(deltas, stackingOrderUuids);
+            } else {
+                stackingOrderDeltas.sendChanges(deltas, changes);
+            }
+            continue;
+        }
+        if (resource->version() < ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STACKING_ORDER_UUID_CHANGED_SINCE_VERSION) {
+            continue;
+        }
+        if (!joined) {
+            joinedUuids = joinedStackingOrderUuids();
+            joined = true;
+        }
+        send_stacking_order_uuid_changed(resource->handle, joinedUuids);
     }
 }
 
@@ -171,7 +561,11 @@ void PlasmaWindowManagementInterfacePrivate::sendStackingOrderUuidsChanged(wl_re
     if (wl_resource_get_version(r) < ORG_KDE_PLASMA_WINDOW_MANAGEMENT_STACKING_ORDER_UUID_CHANGED_SINCE_VERSION) {
         return;
     }
+    send_stacking_order_uuid_changed(r, joinedStackingOrderUuids());
+}
 
+QString PlasmaWindowManagementInterfacePrivate::joinedStackingOrderUuids() const
+{
     QString uuids;
     for (const auto &uuid : qAsConst(stackingOrderUuids)) {
         uuids += uuid;
@@ -179,9 +573,9 @@ void PlasmaWindowManagementInterfacePrivate::sendStackingOrderUuidsChanged(wl_re
     }
     // Remove the trailing ';', on the receiving side this is interpreted as an empty uuid.
     if (stackingOrderUuids.size() > 0) {
-        uuids.remove(uuids.length() - 1, 1);
+        uuids.chop(1);
     }
-    send_stacking_order_uuid_changed(r, uuids);
+    return uuids;
 }
 
 void PlasmaWindowManagementInterfacePrivate::org_kde_plasma_window_management_bind_resource(Resource *resource)
@@ -197,6 +591,11 @@ void PlasmaWindowManagementInterfacePrivate::org_kde_plasma_window_management_bi
     sendStackingOrderUuidsChanged(resource->handle);
 }
 
+void PlasmaWindowManagementInterfacePrivate::org_kde_plasma_window_management_destroy_resource(Resource *resource)
+{
+    stackingOrderDeltaResources.remove(resource->handle);
+}
+
 void PlasmaWindowManagementInterfacePrivate::org_kde_plasma_window_management_show_desktop(Resource *resource, uint32_t state)
 {
     Q_UNUSED(resource)
@@ -301,8 +700,9 @@ void PlasmaWindowManagementInterface::setStackingOrderUuids(const QVector<QStrin
     if (d->stackingOrderUuids == stackingOrderUuids) {
         return;
     }
+    const QVector<QString> previousUuids = d->stackingOrderUuids;
     d->stackingOrderUuids = stackingOrderUuids;
-    d->sendStackingOrderUuidsChanged();
+    d->sendStackingOrderUuidsChanged(previousUuids);
 }
 
 void PlasmaWindowManagementInterface::setPlasmaVirtualDesktopManagementInterface(PlasmaVirtualDesktopManagementInterface *manager)
@@ -323,6 +723,7 @@ PlasmaWindowInterfacePrivate::PlasmaWindowInterfacePrivate(PlasmaWindowManagemen
     : QtWaylandServer::org_kde_plasma_window()
     , wm(wm)
     , q(q)
+    , extension(this)
 {
 }
 
@@ -336,6 +737,24 @@ void PlasmaWindowInterfacePrivate::org_kde_plasma_window_destroy(Resource *resou
     wl_resource_destroy(resource->handle);
 }
 
+void PlasmaWindowInterfacePrivate::org_kde_plasma_window_destroy_resource(Resource *resource)
+{
+    extensionResources.remove(resource->handle);
+}
+
+void PlasmaWindowInterfacePrivate::addExtension(wl_client *client, uint32_t id, int version, wl_resource *window)
+{
+    auto resource = extension.add(client, id, version);
+    extensionResources.insert(window, resource->handle);
+    // Stands in for the icon_changed sent when the window got bound.
+    if (m_themedIconName.isEmpty() && iconData) {
+        extension.send_icon(resource->handle, QString::fromLatin1(iconData->hash));
+        if (resource->version() >= DDE_PLASMA_WINDOW_DONE_SINCE_VERSION) {
+            extension.send_done(resource->handle);
+        }
+    }
+}
+
 void PlasmaWindowInterfacePrivate::org_kde_plasma_window_bind_resource(Resource *resource)
 {
     for (const auto &desk : plasmaVirtualDesktops) {
@@ -378,13 +797,95 @@ void PlasmaWindowInterfacePrivate::org_kde_plasma_window_bind_resource(Resource
     }
 }
 
+void PlasmaWindowInterfacePrivate::beginUpdate()
+{
+    if (updateDepth++ > 0) {
+        return;
+    }
+    committed.title = m_title;
+    committed.appId = m_appId;
+    committed.pid = m_pid;
+    committed.state = m_state;
+    committed.geometry = geometry;
+    committed.appServiceName = m_appServiceName;
+    committed.appObjectPath = m_appObjectPath;
+    committed.themedIconName = m_themedIconName;
+    committed.iconData = iconData;
+}
+
+void PlasmaWindowInterfacePrivate::commitUpdate()
+{
+    Q_ASSERT(updateDepth > 0);
+    if (--updateDepth > 0) {
+        return;
+    }
+    const QSharedPointer<PlasmaWindowIconData> committedIconData = std::exchange(committed.iconData, {});
+    if (unmapped) {
+        return;
+    }
+
+    // Only what differs from before the update, a property set back and forth is not sent at all.
+    bool changed = false;
+    if (m_title != committed.title) {
+        sendTitle();
+        changed = true;
+    }
+    if (m_appId != committed.appId) {
+        sendAppId();
+        changed = true;
+    }
+    if (m_pid != committed.pid) {
+        sendPid();
+        changed = true;
+    }
+    if (m_state != committed.state) {
+        sendState();
+        changed = true;
+    }
+    if (geometry != committed.geometry && geometry.isValid()) {
+        sendGeometry();
+        changed = true;
+    }
+    if (m_appServiceName != committed.appServiceName || m_appObjectPath != committed.appObjectPath) {
+        sendApplicationMenu();
+        changed = true;
+    }
+    if (m_themedIconName != committed.themedIconName) {
+        sendThemedIconName();
+        changed = true;
+    }
+    if (iconData != committedIconData) {
+        sendIcon();
+        changed = true;
+    }
+    if (changed) {
+        sendDone();
+    }
+}
+
+void PlasmaWindowInterfacePrivate::sendDone()
+{
+    for (wl_resource *resource : qAsConst(extensionResources)) {
+        if (wl_resource_get_version(resource) >= DDE_PLASMA_WINDOW_DONE_SINCE_VERSION) {
+            extension.send_done(resource);
+        }
+    }
+}
+
 void PlasmaWindowInterfacePrivate::setAppId(const QString &appId)
 {
     if (m_appId == appId) {
         return;
     }
-
     m_appId = appId;
+    if (updateDepth == 0) {
+        sendAppId();
+        sendDone();
+    }
+}
+
+void PlasmaWindowInterfacePrivate::sendAppId()
+{
     const auto clientResources = resourceMap();
 
     for (auto resource : clientResources) {
@@ -398,10 +899,18 @@ void PlasmaWindowInterfacePrivate::setPid(quint32 pid)
         return;
     }
     m_pid = pid;
+    if (updateDepth == 0) {
+        sendPid();
+        sendDone();
+    }
+}
+
+void PlasmaWindowInterfacePrivate::sendPid()
+{
     const auto clientResources = resourceMap();
 
     for (auto resource : clientResources) {
-        send_pid_changed(resource->handle, pid);
+        send_pid_changed(resource->handle, m_pid);
     }
 }
 
@@ -420,6 +929,14 @@ void PlasmaWindowInterfacePrivate::setThemedIconName(const QString &iconName)
         return;
     }
     m_themedIconName = iconName;
+    if (updateDepth == 0) {
+        sendThemedIconName();
+        sendDone();
+    }
+}
+
+void PlasmaWindowInterfacePrivate::sendThemedIconName()
+{
     const auto clientResources = resourceMap();
 
     for (auto resource : clientResources) {
@@ -429,12 +946,25 @@ void PlasmaWindowInterfacePrivate::setThemedIconName(const QString &iconName)
 
 void PlasmaWindowInterfacePrivate::setIcon(const QIcon &icon)
 {
+    if (iconData && icon.cacheKey() == m_icon.cacheKey()) {
+        return;
+    }
+    // The themed icon name and the icon go out together, an icon with the same content
+    // as before is not announced at all.
+    beginUpdate();
     m_icon = icon;
+    iconData = PlasmaWindowIconData::get(icon);
     setThemedIconName(m_icon.name());
+    commitUpdate();
+}
 
+void PlasmaWindowInterfacePrivate::sendIcon()
+{
     const auto clientResources = resourceMap();
     for (auto resource : clientResources) {
-        if (resource->version() >= ORG_KDE_PLASMA_WINDOW_ICON_CHANGED_SINCE_VERSION) {
+        if (wl_resource *extensionResource = extensionResources.value(resource->handle)) {
+            extension.send_icon(extensionResource, iconData ? QString::fromLatin1(iconData->hash) : QString());
+        } else if (resource->version() >= ORG_KDE_PLASMA_WINDOW_ICON_CHANGED_SINCE_VERSION) {
             send_icon_changed(resource->handle);
         }
     }
@@ -444,14 +974,18 @@ void PlasmaWindowInterfacePrivate::org_kde_plasma_window_get_icon(Resource *reso
 {
     Q_UNUSED(resource)
     QtConcurrent::run(
-        [fd](const QIcon &icon) {
+        [fd](const QSharedPointer<PlasmaWindowIconData> &data) {
             QFile file;
             file.open(fd, QIODevice::WriteOnly, QFileDevice::AutoCloseHandle);
-            QDataStream ds(&file);
-            ds << icon;
+            if (data) {
+                file.write(data->serialized());
+            } else {
+                QDataStream ds(&file);
+                ds << QIcon();
+            }
             file.close();
         },
-        m_icon);
+        iconData);
 }
 
 void PlasmaWindowInterfacePrivate::org_kde_plasma_window_request_enter_virtual_desktop(Resource *resource, const QString &id)
@@ -496,6 +1030,14 @@ void PlasmaWindowInterfacePrivate::setTitle(const QString &title)
         return;
     }
     m_title = title;
+    if (updateDepth == 0) {
+        sendTitle();
+        sendDone();
+    }
+}
+
+void PlasmaWindowInterfacePrivate::sendTitle()
+{
     const auto clientResources = resourceMap();
 
     for (auto resource : clientResources) {
@@ -528,6 +1070,14 @@ void PlasmaWindowInterfacePrivate::setState(org_kde_plasma_window_management_sta
         return;
     }
     m_state = newState;
+    if (updateDepth == 0) {
+        sendState();
+        sendDone();
+    }
+}
+
+void PlasmaWindowInterfacePrivate::sendState()
+{
     const auto clientResources = resourceMap();
 
     for (auto resource : clientResources) {
@@ -581,10 +1131,15 @@ void PlasmaWindowInterfacePrivate::setGeometry(const QRect &geo)
         return;
     }
     geometry = geo;
-    if (!geometry.isValid()) {
+    if (!geometry.isValid() || updateDepth > 0) {
         return;
     }
+    sendGeometry();
+    sendDone();
+}
 
+void PlasmaWindowInterfacePrivate::sendGeometry()
+{
     const auto clientResources = resourceMap();
     for (auto resource : clientResources) {
         if (resource->version() < ORG_KDE_PLASMA_WINDOW_GEOMETRY_SINCE_VERSION) {
@@ -601,12 +1156,20 @@ void PlasmaWindowInterfacePrivate::setApplicationMenuPaths(const QString &servic
     }
     m_appServiceName = service;
     m_appObjectPath = object;
+    if (updateDepth == 0) {
+        sendApplicationMenu();
+        sendDone();
+    }
+}
+
+void PlasmaWindowInterfacePrivate::sendApplicationMenu()
+{
     const auto clientResources = resourceMap();
     for (auto resource : clientResources) {
         if (resource->version() < ORG_KDE_PLASMA_WINDOW_APPLICATION_MENU_SINCE_VERSION) {
             continue;
         }
-        send_application_menu(resource->handle, service, object);
+        send_application_menu(resource->handle, m_appServiceName, m_appObjectPath);
     }
 }
 
@@ -1001,6 +1564,16 @@ void PlasmaWindowInterface::setApplicationMenuPaths(const QString &serviceName,
     d->setApplicationMenuPaths(serviceName, objectPath);
 }
 
+void PlasmaWindowInterface::beginUpdate()
+{
+    d->beginUpdate();
+}
+
+void PlasmaWindowInterface::commitUpdate()
+{
+    d->commitUpdate();
+}
+
 quint32 PlasmaWindowInterface::internalId() const
 {
     return d->windowId;
@@ -90,6 +90,12 @@ public:
      */
     void setStackingOrder(const QVector<quint32> &stackingOrder);
 
+    /**
+     * Sets the stacking order, from bottom to top, as window uuids.
+     *
+     * Clients which use the dde_plasma_window_management extension only receive what changed
+     * compared to the previous stacking order, all other clients receive the complete list.
+     */
     void setStackingOrderUuids(const QVector<QString> &stackingOrderUuids);
 
 Q_SIGNALS:
@@ -216,6 +222,28 @@ public:
      */
     void setApplicationMenuPaths(const QString &serviceName, const QString &objectPath);
 
+    /**
+     * Starts a group of property changes. Until the matching commitUpdate, changes of the
+     * title, app id, pid, states, geometry, application menu and icon are only recorded
+     * instead of being sent right away. Calls can be nested, only the outermost commitUpdate
+     * sends.
+     *
+     * Use it when several properties change at once, so that clients can apply them
+     * together instead of updating once per property.
+     *
+     * @see commitUpdate
+     */
+    void beginUpdate();
+
+    /**
+     * Sends the properties which differ from what they were before beginUpdate, a property
+     * which was changed and set back is not sent at all. Clients using the
+     * dde_plasma_window_management extension get a done event afterwards.
+     *
+     * @see beginUpdate
+     */
+    void commitUpdate();
+
     /**
      * Return the window internal id
      */
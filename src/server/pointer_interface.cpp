@@ -30,8 +30,9 @@ public:
     quint32 enteredSerial = 0;
     QPoint hotspot;
     QPointer<SurfaceInterface> surface;
+    Cursor::Shape shape = Cursor::Shape::None;
 
-    void update(SurfaceInterface *surface, quint32 serial, const QPoint &hotspot);
+    void update(SurfaceInterface *surface, quint32 serial, const QPoint &hotspot, Cursor::Shape shape);
 };
 
 PointerInterfacePrivate *PointerInterfacePrivate::get(PointerInterface *pointer)
@@ -47,15 +48,19 @@ PointerInterfacePrivate::PointerInterfacePrivate(PointerInterface *q, SeatInterf
     , pinchGesturesV1(new PointerPinchGestureV1Interface(q))
     , holdGesturesV1(new PointerHoldGestureV1Interface(q))
 {
+    coalescing.timer.setSingleShot(true);
+    QObject::connect(&coalescing.timer, &QTimer::timeout, q, [this]() {
+        flushPendingEvents();
+    });
 }
 
 PointerInterfacePrivate::~PointerInterfacePrivate()
 {
 }
 
-QList<PointerInterfacePrivate::Resource *> PointerInterfacePrivate::pointersForClient(ClientConnection *client) const
+const QVector<PointerInterfacePrivate::Resource *> &PointerInterfacePrivate::pointersForClient(ClientConnection *client) const
 {
-    return resourceMap().values(client->client());
+    return resourcesForClient(client->client());
 }
 
 void PointerInterfacePrivate::pointer_set_cursor(Resource *resource, uint32_t serial, ::wl_resource *surface_resource, int32_t hotspot_x, int32_t hotspot_y)
@@ -84,13 +89,32 @@ void PointerInterfacePrivate::pointer_set_cursor(Resource *resource, uint32_t se
         }
     }
 
-    if (!cursor) { // TODO: Assign the cursor surface role.
+    // TODO: Assign the cursor surface role.
+    updateCursor(surface, serial, QPoint(hotspot_x, hotspot_y), Cursor::Shape::None);
+}
+
+void PointerInterfacePrivate::setCursorShape(wl_client *client, quint32 serial, Cursor::Shape shape)
+{
+    if (!focusedSurface) {
+        return;
+    }
+    if (focusedSurface->client()->client() != client) {
+        qCDebug(KWAYLAND_SERVER, "Denied set_shape request from unfocused client");
+        return;
+    }
+
+    updateCursor(nullptr, serial, QPoint(), shape);
+}
+
+void PointerInterfacePrivate::updateCursor(SurfaceInterface *surface, quint32 serial, const QPoint &hotspot, Cursor::Shape shape)
+{
+    if (!cursor) {
         cursor = new Cursor(q);
-        cursor->d->update(surface, serial, QPoint(hotspot_x, hotspot_y));
+        cursor->d->update(surface, serial, hotspot, shape);
         QObject::connect(cursor, &Cursor::changed, q, &PointerInterface::cursorChanged);
         Q_EMIT q->cursorChanged();
     } else {
-        cursor->d->update(surface, serial, QPoint(hotspot_x, hotspot_y));
+        cursor->d->update(surface, serial, hotspot, shape);
     }
 }
 
@@ -114,7 +138,7 @@ void PointerInterfacePrivate::pointer_bind_resource(Resource *resource)
 
 void PointerInterfacePrivate::sendLeave(quint32 serial)
 {
-    const QList<Resource *> pointerResources = pointersForClient(focusedSurface->client());
+    const QVector<Resource *> &pointerResources = pointersForClient(focusedSurface->client());
     for (Resource *resource : pointerResources) {
         send_leave(resource->handle, serial, focusedSurface->resource());
     }
@@ -122,7 +146,7 @@ void PointerInterfacePrivate::sendLeave(quint32 serial)
 
 void PointerInterfacePrivate::sendEnter(const QPointF &position, quint32 serial)
 {
-    const QList<Resource *> pointerResources = pointersForClient(focusedSurface->client());
+    const QVector<Resource *> &pointerResources = pointersForClient(focusedSurface->client());
     for (Resource *resource : pointerResources) {
         send_enter(resource->handle, serial, focusedSurface->resource(), wl_fixed_from_double(position.x()), wl_fixed_from_double(position.y()));
     }
@@ -130,7 +154,7 @@ void PointerInterfacePrivate::sendEnter(const QPointF &position, quint32 serial)
 
 void PointerInterfacePrivate::sendFrame()
 {
-    const QList<Resource *> pointerResources = pointersForClient(focusedSurface->client());
+    const QVector<Resource *> &pointerResources = pointersForClient(focusedSurface->client());
     for (Resource *resource : pointerResources) {
         if (resource->version() >= WL_POINTER_FRAME_SINCE_VERSION) {
             send_frame(resource->handle);
@@ -138,6 +162,129 @@ void PointerInterfacePrivate::sendFrame()
     }
 }
 
+void PointerInterfacePrivate::sendMotion(const QPointF &position, quint32 time)
+{
+    const QVector<Resource *> &pointerResources = pointersForClient(focusedSurface->client());
+    for (Resource *resource : pointerResources) {
+        send_motion(resource->handle, time, wl_fixed_from_double(position.x()), wl_fixed_from_double(position.y()));
+    }
+}
+
+void PointerInterfacePrivate::sendAxis(Qt::Orientation orientation, qreal delta, qint32 discreteDelta, PointerAxisSource source, quint32 time)
+{
+    const QVector<Resource *> &pointerResources = pointersForClient(focusedSurface->client());
+    for (Resource *resource : pointerResources) {
+        const quint32 version = resource->version();
+
+        const auto wlOrientation = (orientation == Qt::Vertical) ? axis_vertical_scroll : axis_horizontal_scroll;
+
+        if (source != PointerAxisSource::Unknown && version >= WL_POINTER_AXIS_SOURCE_SINCE_VERSION) {
+            axis_source wlSource;
+            switch (source) {
+            case PointerAxisSource::Wheel:
+                wlSource = axis_source_wheel;
+                break;
+            case PointerAxisSource::Finger:
+                wlSource = axis_source_finger;
+                break;
+            case PointerAxisSource::Continuous:
+                wlSource = axis_source_continuous;
+                break;
+            case PointerAxisSource::WheelTilt:
+                wlSource = axis_source_wheel_tilt;
+                break;
+            default:
+                Q_UNREACHABLE();
+                break;
+            }
+            send_axis_source(resource->handle, wlSource);
+        }
+
+        if (delta != 0.0) {
+            if (discreteDelta && version >= WL_POINTER_AXIS_DISCRETE_SINCE_VERSION) {
+                send_axis_discrete(resource->handle, wlOrientation, discreteDelta);
+            }
+            send_axis(resource->handle, time, wlOrientation, wl_fixed_from_double(delta));
+        } else if (version >= WL_POINTER_AXIS_STOP_SINCE_VERSION) {
+            send_axis_stop(resource->handle, time, wlOrientation);
+        }
+    }
+}
+
+void PointerInterfacePrivate::setCoalescing(bool enabled, int rate)
+{
+    coalescing.rate = qMax(rate, 0);
+    if (coalescing.enabled == enabled) {
+        return;
+    }
+    coalescing.enabled = enabled;
+    if (!enabled) {
+        flushPendingEvents();
+    }
+}
+
+bool PointerInterfacePrivate::hasPendingEvents() const
+{
+    return coalescing.motionPending || coalescing.relativeMotionPending || coalescing.verticalAxis.pending || coalescing.horizontalAxis.pending;
+}
+
+void PointerInterfacePrivate::scheduleFlush()
+{
+    if (coalescing.rate == 0) {
+        // The compositor flushes the pending events itself, e.g. on the next output frame.
+        return;
+    }
+    const qint64 interval = 1000 / coalescing.rate;
+    if (!coalescing.lastFlush.isValid() || coalescing.lastFlush.elapsed() >= interval) {
+        flushPendingEvents();
+    } else if (!coalescing.timer.isActive()) {
+        coalescing.timer.start(interval - coalescing.lastFlush.elapsed());
+    }
+}
+
+void PointerInterfacePrivate::flushPendingEvents()
+{
+    if (!hasPendingEvents()) {
+        return;
+    }
+    coalescing.timer.stop();
+
+    if (focusedSurface) {
+        if (coalescing.motionPending) {
+            sendMotion(coalescing.motionPosition, coalescing.motionTime);
+        }
+        if (coalescing.relativeMotionPending) {
+            relativePointersV1->sendMotion(coalescing.relativeDelta, coalescing.relativeDeltaNonAccelerated, coalescing.relativeTime);
+        }
+        // The accumulated deltas can cancel each other out, a zero delta would be an axis_stop.
+        const PendingAxis &vertical = coalescing.verticalAxis;
+        if (vertical.pending && vertical.delta != 0.0) {
+            sendAxis(Qt::Vertical, vertical.delta, vertical.discreteDelta, vertical.source, vertical.time);
+        }
+        const PendingAxis &horizontal = coalescing.horizontalAxis;
+        if (horizontal.pending && horizontal.delta != 0.0) {
+            sendAxis(Qt::Horizontal, horizontal.delta, horizontal.discreteDelta, horizontal.source, horizontal.time);
+        }
+        if (coalescing.framePending) {
+            sendFrame();
+        }
+    }
+
+    discardPendingEvents();
+    coalescing.lastFlush.start();
+    ++coalescing.statistics.flushes;
+}
+
+void PointerInterfacePrivate::discardPendingEvents()
+{
+    coalescing.timer.stop();
+    coalescing.motionPending = false;
+    coalescing.relativeMotionPending = false;
+    coalescing.verticalAxis = PendingAxis{};
+    coalescing.horizontalAxis = PendingAxis{};
+    coalescing.framePending = false;
+}
+
 PointerInterface::PointerInterface(SeatInterface *seat)
     : d(new PointerInterfacePrivate(this, seat))
 {
@@ -158,6 +305,9 @@ void PointerInterface::setFocusedSurface(SurfaceInterface *surface, const QPoint
         return;
     }
 
+    // Events which are still pending belong to the surface that is about to lose the focus.
+    d->flushPendingEvents();
+
     if (d->focusedSurface) {
         d->sendLeave(serial);
         if (!surface || d->focusedSurface->client() != surface->client()) {
@@ -170,6 +320,7 @@ void PointerInterface::setFocusedSurface(SurfaceInterface *surface, const QPoint
 
     if (d->focusedSurface) {
         d->destroyConnection = connect(d->focusedSurface, &SurfaceInterface::aboutToBeDestroyed, this, [this]() {
+            d->discardPendingEvents();
             d->sendLeave(d->seat->display()->nextSerial());
             d->sendFrame();
             d->focusedSurface = nullptr;
@@ -189,7 +340,10 @@ void PointerInterface::sendButton(quint32 button, PointerButtonState state, quin
         return;
     }
 
-    const auto pointerResources = d->pointersForClient(d->focusedSurface->client());
+    // Buttons are never coalesced, the client has to see them at the position they were pressed at.
+    d->flushPendingEvents();
+
+    const auto &pointerResources = d->pointersForClient(d->focusedSurface->client());
     for (PointerInterfacePrivate::Resource *resource : pointerResources) {
         d->send_button(resource->handle, serial, d->seat->timestamp(), button, quint32(state));
     }
@@ -201,44 +355,28 @@ void PointerInterface::sendAxis(Qt::Orientation orientation, qreal delta, qint32
         return;
     }
 
-    const auto pointerResources = d->pointersForClient(d->focusedSurface->client());
-    for (PointerInterfacePrivate::Resource *resource : pointerResources) {
-        const quint32 version = resource->version();
-
-        const auto wlOrientation =
-            (orientation == Qt::Vertical) ? PointerInterfacePrivate::axis_vertical_scroll : PointerInterfacePrivate::axis_horizontal_scroll;
-
-        if (source != PointerAxisSource::Unknown && version >= WL_POINTER_AXIS_SOURCE_SINCE_VERSION) {
-            PointerInterfacePrivate::axis_source wlSource;
-            switch (source) {
-            case PointerAxisSource::Wheel:
-                wlSource = PointerInterfacePrivate::axis_source_wheel;
-                break;
-            case PointerAxisSource::Finger:
-                wlSource = PointerInterfacePrivate::axis_source_finger;
-                break;
-            case PointerAxisSource::Continuous:
-                wlSource = PointerInterfacePrivate::axis_source_continuous;
-                break;
-            case PointerAxisSource::WheelTilt:
-                wlSource = PointerInterfacePrivate::axis_source_wheel_tilt;
-                break;
-            default:
-                Q_UNREACHABLE();
-                break;
-            }
-            d->send_axis_source(resource->handle, wlSource);
+    if (d->coalescing.enabled && delta != 0.0) {
+        PointerInterfacePrivate::PendingAxis &axis = orientation == Qt::Vertical ? d->coalescing.verticalAxis : d->coalescing.horizontalAxis;
+        if (axis.pending && axis.source != source) {
+            d->flushPendingEvents();
         }
-
-        if (delta != 0.0) {
-            if (discreteDelta && version >= WL_POINTER_AXIS_DISCRETE_SINCE_VERSION) {
-                d->send_axis_discrete(resource->handle, wlOrientation, discreteDelta);
-            }
-            d->send_axis(resource->handle, d->seat->timestamp(), wlOrientation, wl_fixed_from_double(delta));
-        } else if (version >= WL_POINTER_AXIS_STOP_SINCE_VERSION) {
-            d->send_axis_stop(resource->handle, d->seat->timestamp(), wlOrientation);
+        if (axis.pending) {
+            axis.delta += delta;
+            axis.discreteDelta += discreteDelta;
+            ++d->coalescing.statistics.coalescedAxisEvents;
+        } else {
+            axis.pending = true;
+            axis.delta = delta;
+            axis.discreteDelta = discreteDelta;
+            axis.source = source;
         }
+        axis.time = d->seat->timestamp();
+        return;
     }
+
+    // axis_stop terminates the scroll sequence, so everything before it has to go out first.
+    d->flushPendingEvents();
+    d->sendAxis(orientation, delta, discreteDelta, source, d->seat->timestamp());
 }
 
 void PointerInterface::sendMotion(const QPointF &position)
@@ -249,17 +387,35 @@ void PointerInterface::sendMotion(const QPointF &position)
         return;
     }
 
-    const auto pointerResources = d->pointersForClient(d->focusedSurface->client());
-    for (PointerInterfacePrivate::Resource *resource : pointerResources) {
-        d->send_motion(resource->handle, d->seat->timestamp(), wl_fixed_from_double(position.x()), wl_fixed_from_double(position.y()));
+    if (d->coalescing.enabled) {
+        if (d->coalescing.motionPending) {
+            ++d->coalescing.statistics.coalescedMotionEvents;
+        }
+        d->coalescing.motionPending = true;
+        d->coalescing.motionPosition = position;
+        d->coalescing.motionTime = d->seat->timestamp();
+        return;
     }
+
+    d->sendMotion(position, d->seat->timestamp());
 }
 
 void PointerInterface::sendFrame()
 {
-    if (d->focusedSurface) {
-        d->sendFrame();
+    if (!d->focusedSurface) {
+        return;
+    }
+
+    if (d->hasPendingEvents()) {
+        if (d->coalescing.framePending) {
+            ++d->coalescing.statistics.coalescedFrames;
+        }
+        d->coalescing.framePending = true;
+        d->scheduleFlush();
+        return;
     }
+
+    d->sendFrame();
 }
 
 Cursor *PointerInterface::cursor() const
@@ -286,7 +442,7 @@ CursorPrivate::CursorPrivate(Cursor *q, PointerInterface *pointer)
 {
 }
 
-void CursorPrivate::update(SurfaceInterface *s, quint32 serial, const QPoint &p)
+void CursorPrivate::update(SurfaceInterface *s, quint32 serial, const QPoint &p, Cursor::Shape sh)
 {
     bool emitChanged = false;
     if (enteredSerial != serial) {
@@ -310,6 +466,11 @@ void CursorPrivate::update(SurfaceInterface *s, quint32 serial, const QPoint &p)
         emitChanged = true;
         Q_EMIT q->surfaceChanged();
     }
+    if (shape != sh) {
+        shape = sh;
+        emitChanged = true;
+        Q_EMIT q->shapeChanged();
+    }
     if (emitChanged) {
         Q_EMIT q->changed();
     }
@@ -345,4 +506,86 @@ SurfaceInterface *Cursor::surface() const
     return d->surface;
 }
 
+Cursor::Shape Cursor::shape() const
+{
+    return d->shape;
+}
+
+QByteArray Cursor::shapeName(Shape shape)
+{
+    switch (shape) {
+    case Shape::None:
+        return QByteArray();
+    case Shape::Default:
+        return QByteArrayLiteral("default");
+    case Shape::ContextMenu:
+        return QByteArrayLiteral("context-menu");
+    case Shape::Help:
+        return QByteArrayLiteral("help");
+    case Shape::Pointer:
+        return QByteArrayLiteral("pointer");
+    case Shape::Progress:
+        return QByteArrayLiteral("progress");
+    case Shape::Wait:
+        return QByteArrayLiteral("wait");
+    case Shape::Cell:
+        return QByteArrayLiteral("cell");
+    case Shape::Crosshair:
+        return QByteArrayLiteral("crosshair");
+    case Shape::Text:
+        return QByteArrayLiteral("text");
+    case Shape::VerticalText:
+        return QByteArrayLiteral("vertical-text");
+    case Shape::Alias:
+        return QByteArrayLiteral("alias");
+    case Shape::Copy:
+        return QByteArrayLiteral("copy");
+    case Shape::Move:
+        return QByteArrayLiteral("move");
+    case Shape::NoDrop:
+        return QByteArrayLiteral("no-drop");
+    case Shape::NotAllowed:
+        return QByteArrayLiteral("not-allowed");
+    case Shape::Grab:
+        return QByteArrayLiteral("grab");
+    case Shape::Grabbing:
+        return QByteArrayLiteral("grabbing");
+    case Shape::EResize:
+        return QByteArrayLiteral("e-resize");
+    case Shape::NResize:
+        return QByteArrayLiteral("n-resize");
+    case Shape::NeResize:
+        return QByteArrayLiteral("ne-resize");
+    case Shape::NwResize:
+        return QByteArrayLiteral("nw-resize");
+    case Shape::SResize:
+        return QByteArrayLiteral("s-resize");
+    case Shape::SeResize:
+        return QByteArrayLiteral("se-resize");
+    case Shape::SwResize:
+        return QByteArrayLiteral("sw-resize");
+    case Shape::WResize:
+        return QByteArrayLiteral("w-resize");
+    case Shape::EwResize:
+        return QByteArrayLiteral("ew-resize");
+    case Shape::NsResize:
+        return QByteArrayLiteral("ns-resize");
+    case Shape::NeswResize:
+        return QByteArrayLiteral("nesw-resize");
+    case Shape::NwseResize:
+        return QByteArrayLiteral("nwse-resize");
+    case Shape::ColResize:
+        return QByteArrayLiteral("col-resize");
+    case Shape::RowResize:
+        return QByteArrayLiteral("row-resize");
+    case Shape::AllScroll:
+        return QByteArrayLiteral("all-scroll");
+    case Shape::ZoomIn:
+        return QByteArrayLiteral("zoom-in");
+    case Shape::ZoomOut:
+        return QByteArrayLiteral("zoom-out");
+    }
+    return QByteArray();
+}
+
 } // namespace KWaylandServer
@@ -66,8 +66,8 @@ public:
 
 Q_SIGNALS:
     /**
-     * This signal is emitted whenever the cursor surface changes. As long as there is no
-     * any focused surface, the cursor cannot be changed.
+     * This signal is emitted whenever the cursor surface or the cursor shape changes. As long
+     * as there is no any focused surface, the cursor cannot be changed.
      */
     void cursorChanged();
     /**
@@ -85,12 +85,59 @@ private:
 
 /**
  * @brief Class encapsulating a Cursor image.
+ *
+ * The client either provides the image content with a surface, or it asks for one of the
+ * predefined shapes, see CursorShapeManagerV1Interface. In the latter case surface() is
+ * @c null and the compositor renders the shape from its own cursor theme.
  */
 class KWAYLANDSERVER_EXPORT Cursor : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * The predefined cursor shapes, they match the @c wp_cursor_shape_device_v1.shape enum.
+     * The names are the ones of the CSS cursor property, see shapeName().
+     */
+    enum class Shape {
+        None = 0, ///< the cursor image is provided by surface()
+        Default,
+        ContextMenu,
+        Help,
+        Pointer,
+        Progress,
+        Wait,
+        Cell,
+        Crosshair,
+        Text,
+        VerticalText,
+        Alias,
+        Copy,
+        Move,
+        NoDrop,
+        NotAllowed,
+        Grab,
+        Grabbing,
+        EResize,
+        NResize,
+        NeResize,
+        NwResize,
+        SResize,
+        SeResize,
+        SwResize,
+        WResize,
+        EwResize,
+        NsResize,
+        NeswResize,
+        NwseResize,
+        ColResize,
+        RowResize,
+        AllScroll,
+        ZoomIn,
+        ZoomOut,
+    };
+    Q_ENUM(Shape)
+
     virtual ~Cursor();
     /**
      * The hotspot of the cursor image in surface-relative coordinates.
@@ -108,11 +155,22 @@ public:
      * The SurfaceInterface for the image content of the Cursor.
      */
     SurfaceInterface *surface() const;
+    /**
+     * The predefined shape of the Cursor, Shape::None if the image is provided by surface().
+     */
+    Shape shape() const;
+
+    /**
+     * Returns the CSS name of @p shape, e.g. @c "nwse-resize", which is also the name of the
+     * cursor in cursor themes. An empty name is returned for Shape::None.
+     */
+    static QByteArray shapeName(Shape shape);
 
 Q_SIGNALS:
     void hotspotChanged();
     void enteredSerialChanged();
     void surfaceChanged();
+    void shapeChanged();
     void changed();
 
 private:
@@ -8,9 +8,13 @@
 #pragma once
 
 #include "pointer_interface.h"
+#include "seat_interface.h"
 
+#include <QElapsedTimer>
 #include <QPointF>
 #include <QPointer>
+#include <QSizeF>
+#include <QTimer>
 #include <QVector>
 
 #include "qwayland-server-wayland.h"
@@ -31,7 +35,7 @@ public:
     PointerInterfacePrivate(PointerInterface *q, SeatInterface *seat);
     ~PointerInterfacePrivate() override;
 
-    QList<Resource *> pointersForClient(ClientConnection *client) const;
+    const QVector<Resource *> &pointersForClient(ClientConnection *client) const;
 
     PointerInterface *q;
     SeatInterface *seat;
@@ -44,9 +48,47 @@ public:
     QScopedPointer<PointerHoldGestureV1Interface> holdGesturesV1;
     QPointF lastPosition;
 
+    struct PendingAxis {
+        bool pending = false;
+        qreal delta = 0;
+        qint32 discreteDelta = 0;
+        PointerAxisSource source = PointerAxisSource::Unknown;
+        quint32 time = 0;
+    };
+    struct Coalescing {
+        bool enabled = false;
+        int rate = 0;
+        QTimer timer;
+        QElapsedTimer lastFlush;
+        bool motionPending = false;
+        QPointF motionPosition;
+        quint32 motionTime = 0;
+        // relative motion adds up, it is sent right after the motion of the same frame
+        bool relativeMotionPending = false;
+        QSizeF relativeDelta;
+        QSizeF relativeDeltaNonAccelerated;
+        quint64 relativeTime = 0;
+        PendingAxis verticalAxis;
+        PendingAxis horizontalAxis;
+        bool framePending = false;
+        SeatInterface::PointerCoalescingStatistics statistics;
+    };
+    Coalescing coalescing;
+
+    void updateCursor(SurfaceInterface *surface, quint32 serial, const QPoint &hotspot, Cursor::Shape shape);
+    void setCursorShape(wl_client *client, quint32 serial, Cursor::Shape shape);
+
     void sendLeave(quint32 serial);
     void sendEnter(const QPointF &parentSurfacePosition, quint32 serial);
     void sendFrame();
+    void sendMotion(const QPointF &position, quint32 time);
+    void sendAxis(Qt::Orientation orientation, qreal delta, qint32 discreteDelta, PointerAxisSource source, quint32 time);
+
+    void setCoalescing(bool enabled, int rate);
+    bool hasPendingEvents() const;
+    void scheduleFlush();
+    void flushPendingEvents();
+    void discardPendingEvents();
 
 protected:
     void pointer_set_cursor(Resource *resource, uint32_t serial, ::wl_resource *surface_resource, int32_t hotspot_x, int32_t hotspot_y) override;
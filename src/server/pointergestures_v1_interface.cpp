@@ -105,8 +105,9 @@ void PointerSwipeGestureV1Interface::sendBegin(quint32 serial, quint32 fingerCou
     const SurfaceInterface *focusedSurface = pointer->focusedSurface();
     focusedClient = focusedSurface->client();
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> swipeResources = resourceMap().values(focusedClient->client());
+    const QVector<Resource *> &swipeResources = resourcesForClient(focusedClient->client());
     for (Resource *swipeResource : swipeResources) {
         send_begin(swipeResource->handle, serial, seat->timestamp(), focusedSurface->resource(), fingerCount);
     }
@@ -119,8 +120,9 @@ void PointerSwipeGestureV1Interface::sendUpdate(const QSizeF &delta)
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> swipeResources = resourceMap().values(focusedClient->client());
+    const QVector<Resource *> &swipeResources = resourcesForClient(focusedClient->client());
     for (Resource *swipeResource : swipeResources) {
         send_update(swipeResource->handle, seat->timestamp(), wl_fixed_from_double(delta.width()), wl_fixed_from_double(delta.height()));
     }
@@ -133,8 +135,9 @@ void PointerSwipeGestureV1Interface::sendEnd(quint32 serial)
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> swipeResources = resourceMap().values(focusedClient->client());
+    const QVector<Resource *> &swipeResources = resourcesForClient(focusedClient->client());
     for (Resource *swipeResource : swipeResources) {
         send_end(swipeResource->handle, serial, seat->timestamp(), false);
     }
@@ -150,8 +153,9 @@ void PointerSwipeGestureV1Interface::sendCancel(quint32 serial)
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> swipeResources = resourceMap().values(focusedClient->client());
+    const QVector<Resource *> &swipeResources = resourcesForClient(focusedClient->client());
     for (Resource *swipeResource : swipeResources) {
         send_end(swipeResource->handle, serial, seat->timestamp(), true);
     }
@@ -191,8 +195,9 @@ void PointerPinchGestureV1Interface::sendBegin(quint32 serial, quint32 fingerCou
     const SurfaceInterface *focusedSurface = pointer->focusedSurface();
     focusedClient = focusedSurface->client();
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> pinchResources = resourceMap().values(*focusedClient);
+    const QVector<Resource *> &pinchResources = resourcesForClient(*focusedClient);
     for (Resource *pinchResource : pinchResources) {
         send_begin(pinchResource->handle, serial, seat->timestamp(), focusedSurface->resource(), fingerCount);
     }
@@ -205,8 +210,9 @@ void PointerPinchGestureV1Interface::sendUpdate(const QSizeF &delta, qreal scale
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> pinchResources = resourceMap().values(*focusedClient);
+    const QVector<Resource *> &pinchResources = resourcesForClient(*focusedClient);
     for (Resource *pinchResource : pinchResources) {
         send_update(pinchResource->handle,
                     seat->timestamp(),
@@ -224,8 +230,9 @@ void PointerPinchGestureV1Interface::sendEnd(quint32 serial)
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> pinchResources = resourceMap().values(*focusedClient);
+    const QVector<Resource *> &pinchResources = resourcesForClient(*focusedClient);
     for (Resource *pinchResource : pinchResources) {
         send_end(pinchResource->handle, serial, seat->timestamp(), false);
     }
@@ -241,8 +248,9 @@ void PointerPinchGestureV1Interface::sendCancel(quint32 serial)
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> pinchResources = resourceMap().values(*focusedClient);
+    const QVector<Resource *> &pinchResources = resourcesForClient(*focusedClient);
     for (Resource *pinchResource : pinchResources) {
         send_end(pinchResource->handle, serial, seat->timestamp(), true);
     }
@@ -282,8 +290,9 @@ void PointerHoldGestureV1Interface::sendBegin(quint32 serial, quint32 fingerCoun
     const SurfaceInterface *focusedSurface = pointer->focusedSurface();
     focusedClient = focusedSurface->client();
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> holdResources = resourceMap().values(*focusedClient);
+    const QVector<Resource *> &holdResources = resourcesForClient(*focusedClient);
     for (Resource *holdResource : holdResources) {
         send_begin(holdResource->handle, serial, seat->timestamp(), focusedSurface->resource(), fingerCount);
     }
@@ -296,8 +305,9 @@ void PointerHoldGestureV1Interface::sendEnd(quint32 serial)
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> holdResources = resourceMap().values(*focusedClient);
+    const QVector<Resource *> &holdResources = resourcesForClient(*focusedClient);
     for (Resource *holdResource : holdResources) {
         send_end(holdResource->handle, serial, seat->timestamp(), false);
     }
@@ -313,8 +323,9 @@ void PointerHoldGestureV1Interface::sendCancel(quint32 serial)
     }
 
     SeatInterface *seat = pointer->seat();
+    PointerInterfacePrivate::get(pointer)->flushPendingEvents();
 
-    const QList<Resource *> holdResources = resourceMap().values(*focusedClient);
+    const QVector<Resource *> &holdResources = resourcesForClient(*focusedClient);
     for (Resource *holdResource : holdResources) {
         send_end(holdResource->handle, serial, seat->timestamp(), true);
     }
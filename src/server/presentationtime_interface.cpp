@@ -0,0 +1,141 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "presentationtime_interface.h"
+#include "clientconnection_p.h"
+#include "display.h"
+#include "output_interface.h"
+#include "presentationtime_interface_p.h"
+#include "surface_interface_p.h"
+
+#include "qwayland-server-presentation-time.h"
+
+static const int s_version = 1;
+
+namespace KWaylandServer
+{
+class PresentationTimeInterfacePrivate : public QtWaylandServer::wp_presentation
+{
+public:
+    clockid_t clockId = CLOCK_MONOTONIC;
+
+protected:
+    void wp_presentation_bind_resource(Resource *resource) override;
+    void wp_presentation_destroy(Resource *resource) override;
+    void wp_presentation_feedback(Resource *resource, struct ::wl_resource *surface, uint32_t callback) override;
+};
+
+void PresentationTimeInterfacePrivate::wp_presentation_bind_resource(Resource *resource)
+{
+    send_clock_id(resource->handle, clockId);
+}
+
+void PresentationTimeInterfacePrivate::wp_presentation_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void PresentationTimeInterfacePrivate::wp_presentation_feedback(Resource *resource, struct ::wl_resource *surface_resource, uint32_t callback)
+{
+    SurfaceInterface *surface = SurfaceInterface::get(surface_resource);
+    wl_resource *feedbackResource = wl_resource_create(resource->client(), &wp_presentation_feedback_interface, resource->version(), callback);
+    if (!feedbackResource) {
+        wl_client_post_no_memory(resource->client());
+        return;
+    }
+
+    wl_resource_set_implementation(feedbackResource, nullptr, nullptr, [](wl_resource *resource) {
+        wl_list_remove(wl_resource_get_link(resource));
+    });
+
+    // The feedback belongs to the next content update, like a frame callback.
+    SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(surface);
+    wl_list_insert(surfacePrivate->pending.presentationFeedbacks.prev, wl_resource_get_link(feedbackResource));
+}
+
+PresentationTimeInterface::PresentationTimeInterface(Display *display, QObject *parent)
+    : QObject(parent)
+    , d(new PresentationTimeInterfacePrivate)
+{
+    d->init(*display, s_version);
+}
+
+PresentationTimeInterface::~PresentationTimeInterface()
+{
+}
+
+void PresentationTimeInterface::setClockId(clockid_t clockId)
+{
+    d->clockId = clockId;
+}
+
+clockid_t PresentationTimeInterface::clockId() const
+{
+    return d->clockId;
+}
+
+PresentationFeedbackPrivate::PresentationFeedbackPrivate()
+{
+    wl_list_init(&resources);
+}
+
+void PresentationFeedbackPrivate::discard(wl_list *feedbacks)
+{
+    wl_resource *resource;
+    wl_resource *tmp;
+    wl_resource_for_each_safe(resource, tmp, feedbacks)
+    {
+        wp_presentation_feedback_send_discarded(resource);
+        wl_resource_destroy(resource);
+    }
+}
+
+PresentationFeedback::PresentationFeedback()
+    : d(new PresentationFeedbackPrivate)
+{
+}
+
+PresentationFeedback::~PresentationFeedback()
+{
+    discarded();
+}
+
+void PresentationFeedback::presented(OutputInterface *output, std::chrono::nanoseconds timestamp, std::chrono::nanoseconds refresh, quint64 sequence, Kinds kinds)
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timestamp);
+    const quint64 tvSec = seconds.count();
+    const quint32 tvNsec = (timestamp - seconds).count();
+
+    wl_resource *resource;
+    wl_resource *tmp;
+    wl_resource_for_each_safe(resource, tmp, &d->resources)
+    {
+        if (output) {
+            if (ClientConnectionPrivate *connection = ClientConnectionPrivate::get(wl_resource_get_client(resource))) {
+                const QVector<wl_resource *> outputResources = output->clientResources(connection->q);
+                for (wl_resource *outputResource : outputResources) {
+                    wp_presentation_feedback_send_sync_output(resource, outputResource);
+                }
+            }
+        }
+        wp_presentation_feedback_send_presented(resource,
+                                                tvSec >> 32,
+                                                tvSec & 0xffffffff,
+                                                tvNsec,
+                                                uint32_t(refresh.count()),
+                                                sequence >> 32,
+                                                sequence & 0xffffffff,
+                                                uint32_t(kinds));
+        wl_resource_destroy(resource);
+    }
+}
+
+void PresentationFeedback::discarded()
+{
+    PresentationFeedbackPrivate::discard(&d->resources);
+}
+
+} // namespace KWaylandServer
@@ -0,0 +1,112 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <DWayland/Server/kwaylandserver_export.h>
+
+#include <QObject>
+
+#include <chrono>
+#include <time.h>
+
+namespace KWaylandServer
+{
+class Display;
+class OutputInterface;
+class PresentationFeedbackPrivate;
+class PresentationTimeInterfacePrivate;
+
+/**
+ * The PresentationTimeInterface lets clients find out when and on which output their content
+ * updates were shown, so that they can pace their frames.
+ *
+ * Clients request a feedback for a content update of a SurfaceInterface, the compositor takes it
+ * with SurfaceInterface::takePresentationFeedback() when it starts showing the update and reports
+ * the outcome through the PresentationFeedback.
+ *
+ * PresentationTimeInterface corresponds to the Wayland interface @c wp_presentation.
+ */
+class KWAYLANDSERVER_EXPORT PresentationTimeInterface : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PresentationTimeInterface(Display *display, QObject *parent = nullptr);
+    ~PresentationTimeInterface() override;
+
+    /**
+     * Sets the clock of the timestamps passed to PresentationFeedback::presented(). It is
+     * announced to the clients when they bind, so it should be set right after creation.
+     *
+     * The default is @c CLOCK_MONOTONIC.
+     */
+    void setClockId(clockid_t clockId);
+    clockid_t clockId() const;
+
+private:
+    QScopedPointer<PresentationTimeInterfacePrivate> d;
+};
+
+/**
+ * The PresentationFeedback holds the feedback the client requested for one content update of
+ * a SurfaceInterface.
+ *
+ * Exactly one of presented() or discarded() should be called. Destroying the feedback without
+ * calling either of them tells the client the content update was discarded.
+ *
+ * @see SurfaceInterface::takePresentationFeedback
+ */
+class KWAYLANDSERVER_EXPORT PresentationFeedback
+{
+public:
+    /**
+     * How the content update was presented, see @c wp_presentation_feedback.kind.
+     */
+    enum class Kind {
+        /**
+         * The presentation was synchronized to the vertical retrace of the output.
+         */
+        Vsync = 0x1,
+        /**
+         * The timestamp comes from the display hardware rather than from a software clock.
+         */
+        HardwareClock = 0x2,
+        /**
+         * The display hardware signalled that it started using the new content.
+         */
+        HardwareCompletion = 0x4,
+        /**
+         * The client buffer was scanned out directly, without any copy.
+         */
+        ZeroCopy = 0x8,
+    };
+    Q_DECLARE_FLAGS(Kinds, Kind)
+
+    ~PresentationFeedback();
+
+    /**
+     * Tells the client the content update turned into light on @p output at @p timestamp.
+     *
+     * @param timestamp the time of the presentation, in the clock set with PresentationTimeInterface::setClockId
+     * @param refresh the duration of a refresh cycle of the output, or zero if it is unknown
+     * @param sequence the vertical retrace counter of the output, or zero if it is unknown
+     */
+    void presented(OutputInterface *output, std::chrono::nanoseconds timestamp, std::chrono::nanoseconds refresh, quint64 sequence, Kinds kinds);
+    /**
+     * Tells the client the content update was never shown.
+     */
+    void discarded();
+
+private:
+    PresentationFeedback();
+    friend class SurfaceInterface;
+    QScopedPointer<PresentationFeedbackPrivate> d;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(PresentationFeedback::Kinds)
+
+} // namespace KWaylandServer
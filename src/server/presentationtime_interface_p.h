@@ -0,0 +1,29 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include "presentationtime_interface.h"
+
+#include <wayland-server-core.h>
+
+namespace KWaylandServer
+{
+class PresentationFeedbackPrivate
+{
+public:
+    PresentationFeedbackPrivate();
+
+    /**
+     * Sends discarded to all wp_presentation_feedback resources in @p feedbacks and destroys them.
+     */
+    static void discard(wl_list *feedbacks);
+
+    // The wp_presentation_feedback resources, linked like the frame callbacks of a SurfaceState.
+    wl_list resources;
+};
+
+} // namespace KWaylandServer
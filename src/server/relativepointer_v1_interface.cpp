@@ -77,7 +77,32 @@ void RelativePointerV1Interface::sendRelativeMotion(const QSizeF &delta, const Q
     }
 
     ClientConnection *focusedClient = pointer->focusedSurface()->client();
-    const QList<Resource *> pointerResources = resourceMap().values(focusedClient->client());
+    if (resourcesForClient(focusedClient->client()).isEmpty()) {
+        return;
+    }
+
+    PointerInterfacePrivate::Coalescing &coalescing = PointerInterfacePrivate::get(pointer)->coalescing;
+    if (coalescing.enabled) {
+        // Relative motion belongs to the same frame as the absolute motion, it goes out with it.
+        if (coalescing.relativeMotionPending) {
+            coalescing.relativeDelta += delta;
+            coalescing.relativeDeltaNonAccelerated += deltaNonAccelerated;
+        } else {
+            coalescing.relativeMotionPending = true;
+            coalescing.relativeDelta = delta;
+            coalescing.relativeDeltaNonAccelerated = deltaNonAccelerated;
+        }
+        coalescing.relativeTime = microseconds;
+        return;
+    }
+
+    sendMotion(delta, deltaNonAccelerated, microseconds);
+}
+
+void RelativePointerV1Interface::sendMotion(const QSizeF &delta, const QSizeF &deltaNonAccelerated, quint64 microseconds)
+{
+    ClientConnection *focusedClient = pointer->focusedSurface()->client();
+    const QVector<Resource *> &pointerResources = resourcesForClient(focusedClient->client());
     for (Resource *pointerResource : pointerResources) {
         if (pointerResource->client() == focusedClient->client()) {
             send_relative_motion(pointerResource->handle,
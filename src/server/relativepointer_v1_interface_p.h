@@ -32,6 +32,8 @@ public:
 
     static RelativePointerV1Interface *get(PointerInterface *pointer);
     void sendRelativeMotion(const QSizeF &delta, const QSizeF &deltaNonAccelerated, quint64 microseconds);
+    // Sends the motion to the focused client right away, without coalescing.
+    void sendMotion(const QSizeF &delta, const QSizeF &deltaNonAccelerated, quint64 microseconds);
 
 protected:
     void zwp_relative_pointer_v1_destroy(Resource *resource) override;
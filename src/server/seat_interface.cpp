@@ -327,7 +327,7 @@ void SeatInterfacePrivate::updatePrimarySelection(PrimarySelectionDeviceV1Interf
 
 void SeatInterfacePrivate::sendCapabilities()
 {
-    const auto seatResources = resourceMap();
+    const auto &seatResources = resourceMap();
     for (SeatInterfacePrivate::Resource *resource : seatResources) {
         send_capabilities(resource->handle, capabilities);
     }
@@ -359,6 +359,7 @@ void SeatInterface::setHasPointer(bool has)
     if (has) {
         d->capabilities |= SeatInterfacePrivate::capability_pointer;
         d->pointer.reset(new PointerInterface(this));
+        PointerInterfacePrivate::get(d->pointer.data())->setCoalescing(d->globalPointer.coalescing, d->globalPointer.coalescingRate);
     } else {
         d->capabilities &= ~SeatInterfacePrivate::capability_pointer;
         d->pointer.reset();
@@ -394,7 +395,7 @@ void SeatInterface::setName(const QString &name)
     }
     d->name = name;
 
-    const auto seatResources = d->resourceMap();
+    const auto &seatResources = d->resourceMap();
     for (SeatInterfacePrivate::Resource *resource : seatResources) {
         if (resource->version() >= WL_SEAT_NAME_SINCE_VERSION) {
             d->send_name(resource->handle, d->name);
@@ -700,6 +701,47 @@ void SeatInterface::notifyPointerAxisToClient(Qt::Orientation orientation, qint3
     usleep(10000);
 }
 
+void SeatInterface::setPointerEventCoalescing(bool enabled)
+{
+    d->globalPointer.coalescing = enabled;
+    if (d->pointer) {
+        PointerInterfacePrivate::get(d->pointer.data())->setCoalescing(enabled, d->globalPointer.coalescingRate);
+    }
+}
+
+bool SeatInterface::isPointerEventCoalescing() const
+{
+    return d->globalPointer.coalescing;
+}
+
+void SeatInterface::setPointerEventCoalescingRate(int rate)
+{
+    d->globalPointer.coalescingRate = qMax(rate, 0);
+    if (d->pointer) {
+        PointerInterfacePrivate::get(d->pointer.data())->setCoalescing(d->globalPointer.coalescing, d->globalPointer.coalescingRate);
+    }
+}
+
+int SeatInterface::pointerEventCoalescingRate() const
+{
+    return d->globalPointer.coalescingRate;
+}
+
+void SeatInterface::flushPointerEvents()
+{
+    if (d->pointer) {
+        PointerInterfacePrivate::get(d->pointer.data())->flushPendingEvents();
+    }
+}
+
+SeatInterface::PointerCoalescingStatistics SeatInterface::pointerCoalescingStatistics() const
+{
+    if (!d->pointer) {
+        return PointerCoalescingStatistics();
+    }
+    return PointerInterfacePrivate::get(d->pointer.data())->coalescing.statistics;
+}
+
 void SeatInterface::notifyPointerButton(Qt::MouseButton button, PointerButtonState state)
 {
     const quint32 nativeButton = qtToWaylandButton(button);
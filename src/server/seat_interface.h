@@ -157,6 +157,32 @@ public:
     explicit SeatInterface(Display *display, QObject *parent = nullptr);
     virtual ~SeatInterface();
 
+    /**
+     * This struct holds statistics about the pointer events merged while pointer event
+     * coalescing is enabled.
+     *
+     * @see pointerCoalescingStatistics()
+     */
+    struct PointerCoalescingStatistics {
+        /**
+         * The number of wl_pointer.motion events which were replaced by a later motion.
+         */
+        quint64 coalescedMotionEvents = 0;
+        /**
+         * The number of wl_pointer.axis events which were added to a pending axis event.
+         */
+        quint64 coalescedAxisEvents = 0;
+        /**
+         * The number of wl_pointer.frame events which were dropped because the events they
+         * terminated were merged into a later frame.
+         */
+        quint64 coalescedFrames = 0;
+        /**
+         * The number of times pending events have been sent to the client.
+         */
+        quint64 flushes = 0;
+    };
+
     Display *display() const;
     QString name() const;
     bool hasPointer() const;
@@ -375,6 +401,54 @@ public:
 
     void notifyPointerAxisToClient(Qt::Orientation orientation, qint32 delta, SurfaceInterface * surface, QMatrix4x4 matrix);
 
+    /**
+     * Enables or disables coalescing of pointer events.
+     *
+     * While enabled, motion and axis events are not sent to the focused client right away.
+     * Consecutive motion events are merged into the last one and axis events with the same
+     * source are summed up, until they get flushed either at the rate set with
+     * setPointerEventCoalescingRate() or by flushPointerEvents(). Button events are never
+     * merged; the pending events are flushed before a button event is sent, so the order
+     * in which the client sees them is preserved.
+     *
+     * Pointer event coalescing is disabled by default. Disabling it flushes pending events.
+     *
+     * @see isPointerEventCoalescing
+     * @see pointerCoalescingStatistics
+     */
+    void setPointerEventCoalescing(bool enabled);
+    /**
+     * @returns whether pointer events are coalesced
+     * @see setPointerEventCoalescing
+     */
+    bool isPointerEventCoalescing() const;
+    /**
+     * Sets the maximum @p rate in Hz at which coalesced pointer events are sent to the client.
+     *
+     * If the @p rate is @c 0, pending events are only sent when flushPointerEvents() is called,
+     * e.g. when the output showing the focused pointer surface is about to be repainted.
+     * The default rate is 120 Hz.
+     *
+     * @see flushPointerEvents
+     */
+    void setPointerEventCoalescingRate(int rate);
+    /**
+     * @returns the maximum rate at which coalesced pointer events are sent to the client
+     * @see setPointerEventCoalescingRate
+     */
+    int pointerEventCoalescingRate() const;
+    /**
+     * Sends the pending coalesced pointer events to the focused pointer surface.
+     *
+     * @see setPointerEventCoalescing
+     */
+    void flushPointerEvents();
+    /**
+     * @returns the statistics of the pointer event coalescing for the current pointer device
+     * @see setPointerEventCoalescing
+     */
+    PointerCoalescingStatistics pointerCoalescingStatistics() const;
+
     /**
      * @returns true if there is a pressed button with the given @p serial
      */
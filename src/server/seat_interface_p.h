@@ -84,6 +84,8 @@ public:
             quint32 serial = 0;
         };
         Focus focus;
+        bool coalescing = false;
+        int coalescingRate = 120;
     };
     Pointer globalPointer;
     void updatePointerButtonSerial(quint32 button, quint32 serial);
@@ -0,0 +1,68 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include "clientbuffer.h"
+#include "clientbufferintegration.h"
+
+#include <QRgba64>
+
+namespace KWaylandServer
+{
+class SinglePixelBufferV1ClientBufferPrivate;
+class SinglePixelBufferV1ClientBufferIntegrationPrivate;
+
+/**
+ * The SinglePixelBufferV1ClientBuffer class represents a buffer that consists of a single pixel.
+ *
+ * There is no memory behind the buffer, the compositor is expected to paint it as a solid
+ * fill with color(). Clients scale such buffers to the desired size with a ViewportInterface,
+ * so the size of the buffer is always 1x1.
+ *
+ * @see SinglePixelBufferV1ClientBufferIntegration
+ */
+class KWAYLANDSERVER_EXPORT SinglePixelBufferV1ClientBuffer : public ClientBuffer
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(SinglePixelBufferV1ClientBuffer)
+
+public:
+    SinglePixelBufferV1ClientBuffer(quint32 red, quint32 green, quint32 blue, quint32 alpha);
+    ~SinglePixelBufferV1ClientBuffer() override;
+
+    /**
+     * Returns the color of the pixel. The color channels are premultiplied by alpha.
+     */
+    QRgba64 color() const;
+
+    QSize size() const override;
+    bool hasAlphaChannel() const override;
+    Origin origin() const override;
+
+private:
+    void initialize(wl_resource *resource);
+    friend class SinglePixelBufferV1ClientBufferIntegrationPrivate;
+};
+
+/**
+ * The SinglePixelBufferV1ClientBufferIntegration class provides support for single pixel buffers.
+ *
+ * It announces the wp_single_pixel_buffer_manager_v1 global. The buffers created through
+ * it are SinglePixelBufferV1ClientBuffer objects.
+ */
+class KWAYLANDSERVER_EXPORT SinglePixelBufferV1ClientBufferIntegration : public ClientBufferIntegration
+{
+    Q_OBJECT
+
+public:
+    explicit SinglePixelBufferV1ClientBufferIntegration(Display *display);
+    ~SinglePixelBufferV1ClientBufferIntegration() override;
+
+private:
+    QScopedPointer<SinglePixelBufferV1ClientBufferIntegrationPrivate> d;
+};
+
+} // namespace KWaylandServer
@@ -9,9 +9,11 @@
 #include "clientconnection.h"
 #include "compositor_interface.h"
 #include "display.h"
+#include "fractionalscale_v1_interface_p.h"
 #include "idleinhibit_v1_interface_p.h"
 #include "linuxdmabufv1clientbuffer.h"
 #include "pointerconstraints_v1_interface_p.h"
+#include "presentationtime_interface_p.h"
 #include "region_interface_p.h"
 #include "subcompositor_interface.h"
 #include "subsurface_interface_p.h"
@@ -20,15 +22,116 @@
 #include "utils.h"
 // std
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace KWaylandServer
 {
+static qint64 floorDiv(qint64 value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+static qint64 ceilDiv(qint64 value, int divisor)
+{
+    return -floorDiv(-value, divisor);
+}
+
+static QRect rectFromEdges(qint64 left, qint64 top, qint64 right, qint64 bottom)
+{
+    const auto clamp = [](qint64 value) {
+        return int(qBound<qint64>(std::numeric_limits<int>::min(), value, std::numeric_limits<int>::max()));
+    };
+    return QRect(QPoint(clamp(left), clamp(top)), QPoint(clamp(right - 1), clamp(bottom - 1)));
+}
+
+static qint64 area(const QRect &rect)
+{
+    return qint64(rect.width()) * rect.height();
+}
+
+static QRect alignedToTiles(const QRect &rect)
+{
+    const int tileSize = DamageAccumulator::TileSize;
+    return rectFromEdges(floorDiv(rect.x(), tileSize) * tileSize,
+                         floorDiv(rect.y(), tileSize) * tileSize,
+                         ceilDiv(qint64(rect.x()) + rect.width(), tileSize) * tileSize,
+                         ceilDiv(qint64(rect.y()) + rect.height(), tileSize) * tileSize);
+}
+
+void DamageAccumulator::add(const QRect &rect, SurfaceInterface::DamagePolicy policy)
+{
+    if (rect.isEmpty()) {
+        return;
+    }
+    for (const QRect &existing : m_rects) {
+        if (existing.contains(rect)) {
+            return;
+        }
+    }
+    const auto covered = std::remove_if(m_rects.begin(), m_rects.end(), [&rect](const QRect &existing) {
+        return rect.contains(existing);
+    });
+    m_rects.resize(covered - m_rects.begin());
+    m_rects.append(rect);
+
+    if (m_rects.count() > MaxRects) {
+        simplify(policy);
+    }
+}
+
+void DamageAccumulator::clear()
+{
+    m_rects.clear();
+}
+
+void DamageAccumulator::simplify(SurfaceInterface::DamagePolicy policy)
+{
+    switch (policy) {
+    case SurfaceInterface::DamagePolicy::BoundingRect: {
+        QRect bounds;
+        for (const QRect &rect : m_rects) {
+            bounds |= rect;
+        }
+        m_rects.clear();
+        m_rects.append(bounds);
+        break;
+    }
+    case SurfaceInterface::DamagePolicy::Tiled:
+        for (QRect &rect : m_rects) {
+            rect = alignedToTiles(rect);
+        }
+        // Free up half of the slots, so the next rectangles can be added without simplifying again.
+        while (m_rects.count() > MaxRects / 2) {
+            int first = 0;
+            int second = 1;
+            qint64 leastWaste = std::numeric_limits<qint64>::max();
+            for (int i = 0; i < m_rects.count(); ++i) {
+                for (int j = i + 1; j < m_rects.count(); ++j) {
+                    const qint64 waste = area(m_rects[i] | m_rects[j]) - area(m_rects[i]) - area(m_rects[j]);
+                    if (waste < leastWaste) {
+                        leastWaste = waste;
+                        first = i;
+                        second = j;
+                    }
+                }
+            }
+            m_rects[first] |= m_rects[second];
+            m_rects.remove(second);
+        }
+        break;
+    }
+}
+
 SurfaceInterfacePrivate::SurfaceInterfacePrivate(SurfaceInterface *q)
     : q(q)
 {
     wl_list_init(&current.frameCallbacks);
     wl_list_init(&pending.frameCallbacks);
     wl_list_init(&cached.frameCallbacks);
+    wl_list_init(&current.presentationFeedbacks);
+    wl_list_init(&pending.presentationFeedbacks);
+    wl_list_init(&cached.presentationFeedbacks);
 }
 
 SurfaceInterfacePrivate::~SurfaceInterfacePrivate()
@@ -48,6 +151,9 @@ SurfaceInterfacePrivate::~SurfaceInterfacePrivate()
     {
         wl_resource_destroy(resource);
     }
+    PresentationFeedbackPrivate::discard(&current.presentationFeedbacks);
+    PresentationFeedbackPrivate::discard(&pending.presentationFeedbacks);
+    PresentationFeedbackPrivate::discard(&cached.presentationFeedbacks);
 
     if (current.buffer) {
         current.buffer->unref();
@@ -60,6 +166,7 @@ void SurfaceInterfacePrivate::addChild(SubSurfaceInterface *child)
     pending.above.append(child);
     cached.above.append(child);
     current.above.append(child);
+    invalidateHitTestCache();
     child->surface()->setOutputs(outputs);
     Q_EMIT q->childSubSurfaceAdded(child);
     Q_EMIT q->childSubSurfacesChanged();
@@ -74,6 +181,7 @@ void SurfaceInterfacePrivate::removeChild(SubSurfaceInterface *child)
     cached.above.removeAll(child);
     current.below.removeAll(child);
     current.above.removeAll(child);
+    invalidateHitTestCache();
     Q_EMIT q->childSubSurfaceRemoved(child);
     Q_EMIT q->childSubSurfacesChanged();
 }
@@ -101,7 +209,7 @@ bool SurfaceInterfacePrivate::raiseChild(SubSurfaceInterface *subsurface, Surfac
     }
 
     anchorList->insert(anchorIndex + 1, subsurface);
-    pending.childrenChanged = true;
+    pending.committed |= SurfaceState::Field::Children;
     return true;
 }
 
@@ -128,32 +236,32 @@ bool SurfaceInterfacePrivate::lowerChild(SubSurfaceInterface *subsurface, Surfac
     }
 
     anchorList->insert(anchorIndex, subsurface);
-    pending.childrenChanged = true;
+    pending.committed |= SurfaceState::Field::Children;
     return true;
 }
 
 void SurfaceInterfacePrivate::setShadow(const QPointer<ShadowInterface> &shadow)
 {
     pending.shadow = shadow;
-    pending.shadowIsSet = true;
+    pending.committed |= SurfaceState::Field::Shadow;
 }
 
 void SurfaceInterfacePrivate::setBlur(const QPointer<BlurInterface> &blur)
 {
     pending.blur = blur;
-    pending.blurIsSet = true;
+    pending.committed |= SurfaceState::Field::Blur;
 }
 
 void SurfaceInterfacePrivate::setSlide(const QPointer<SlideInterface> &slide)
 {
     pending.slide = slide;
-    pending.slideIsSet = true;
+    pending.committed |= SurfaceState::Field::Slide;
 }
 
 void SurfaceInterfacePrivate::setContrast(const QPointer<ContrastInterface> &contrast)
 {
     pending.contrast = contrast;
-    pending.contrastIsSet = true;
+    pending.committed |= SurfaceState::Field::Contrast;
 }
 
 void SurfaceInterfacePrivate::installPointerConstraint(LockedPointerV1Interface *lock)
@@ -240,25 +348,25 @@ void SurfaceInterfacePrivate::surface_destroy(Resource *resource)
 void SurfaceInterfacePrivate::surface_attach(Resource *resource, struct ::wl_resource *buffer, int32_t x, int32_t y)
 {
     Q_UNUSED(resource)
-    pending.bufferIsSet = true;
+    pending.committed |= SurfaceState::Field::Buffer;
     pending.offset = QPoint(x, y);
     if (!buffer) {
         // got a null buffer, deletes content in next frame
         pending.buffer = nullptr;
-        pending.damage = QRegion();
-        pending.bufferDamage = QRegion();
+        pending.damage.clear();
+        pending.bufferDamage.clear();
         return;
     }
     pending.buffer = compositor->display()->clientBufferForResource(buffer);
 
     // set default damage to force initial rendering
-    auto bufferSize = pending.buffer->size();
-    pending.damage = QRegion(0, 0, bufferSize.width(), bufferSize.height());
+    pending.damage.clear();
+    pending.damage.add(QRect(QPoint(0, 0), pending.buffer->size()), damagePolicy);
 }
 
 void SurfaceInterfacePrivate::surface_damage(Resource *, int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    pending.damage |= QRect(x, y, width, height);
+    pending.damage.add(QRect(x, y, width, height), damagePolicy);
 }
 
 void SurfaceInterfacePrivate::surface_frame(Resource *resource, uint32_t callback)
@@ -284,7 +392,7 @@ void SurfaceInterfacePrivate::surface_set_opaque_region(Resource *resource, stru
     Q_UNUSED(resource)
     RegionInterface *r = RegionInterface::get(region);
     pending.opaque = r ? r->region() : QRegion();
-    pending.opaqueIsSet = true;
+    pending.committed |= SurfaceState::Field::Opaque;
 }
 
 void SurfaceInterfacePrivate::surface_set_input_region(Resource *resource, struct ::wl_resource *region)
@@ -292,7 +400,7 @@ void SurfaceInterfacePrivate::surface_set_input_region(Resource *resource, struc
     Q_UNUSED(resource)
     RegionInterface *r = RegionInterface::get(region);
     pending.input = r ? r->region() : infiniteRegion();
-    pending.inputIsSet = true;
+    pending.committed |= SurfaceState::Field::Input;
 }
 
 void SurfaceInterfacePrivate::surface_commit(Resource *resource)
@@ -312,7 +420,7 @@ void SurfaceInterfacePrivate::surface_set_buffer_transform(Resource *resource, i
         return;
     }
     pending.bufferTransform = OutputInterface::Transform(transform);
-    pending.bufferTransformIsSet = true;
+    pending.committed |= SurfaceState::Field::BufferTransform;
 }
 
 void SurfaceInterfacePrivate::surface_set_buffer_scale(Resource *resource, int32_t scale)
@@ -322,13 +430,13 @@ void SurfaceInterfacePrivate::surface_set_buffer_scale(Resource *resource, int32
         return;
     }
     pending.bufferScale = scale;
-    pending.bufferScaleIsSet = true;
+    pending.committed |= SurfaceState::Field::BufferScale;
 }
 
 void SurfaceInterfacePrivate::surface_damage_buffer(Resource *resource, int32_t x, int32_t y, int32_t width, int32_t height)
 {
     Q_UNUSED(resource)
-    pending.bufferDamage |= QRect(x, y, width, height);
+    pending.bufferDamage.add(QRect(x, y, width, height), damagePolicy);
 }
 
 SurfaceInterface::SurfaceInterface(CompositorInterface *compositor, wl_resource *resource)
@@ -389,152 +497,293 @@ bool SurfaceInterface::hasFrameCallbacks() const
     return !wl_list_empty(&d->current.frameCallbacks);
 }
 
-QMatrix4x4 SurfaceInterfacePrivate::buildSurfaceToBufferMatrix()
+PresentationFeedback *SurfaceInterface::takePresentationFeedback()
 {
-    // The order of transforms is reversed, i.e. the viewport transform is the first one.
-
-    QMatrix4x4 surfaceToBufferMatrix;
-
-    if (!current.buffer) {
-        return surfaceToBufferMatrix;
+    if (wl_list_empty(&d->current.presentationFeedbacks)) {
+        return nullptr;
     }
+    auto feedback = new PresentationFeedback;
+    wl_list_insert_list(&feedback->d->resources, &d->current.presentationFeedbacks);
+    wl_list_init(&d->current.presentationFeedbacks);
+    return feedback;
+}
 
-    surfaceToBufferMatrix.scale(current.bufferScale, current.bufferScale);
-
-    switch (current.bufferTransform) {
+// Maps a point in the untransformed buffer space to the transformed buffer space, both in
+// logical units, i.e. without the buffer scale. The order of the cases follows wl_output.transform.
+template<typename T>
+static void applyBufferTransform(OutputInterface::Transform transform, T width, T height, T &x, T &y)
+{
+    const T ux = x;
+    const T uy = y;
+    switch (transform) {
     case OutputInterface::Transform::Normal:
-    case OutputInterface::Transform::Flipped:
         break;
     case OutputInterface::Transform::Rotated90:
-    case OutputInterface::Transform::Flipped90:
-        surfaceToBufferMatrix.translate(0, bufferSize.height() / current.bufferScale);
-        surfaceToBufferMatrix.rotate(-90, 0, 0, 1);
+        x = uy;
+        y = height - ux;
         break;
     case OutputInterface::Transform::Rotated180:
-    case OutputInterface::Transform::Flipped180:
-        surfaceToBufferMatrix.translate(bufferSize.width() / current.bufferScale, bufferSize.height() / current.bufferScale);
-        surfaceToBufferMatrix.rotate(-180, 0, 0, 1);
+        x = width - ux;
+        y = height - uy;
         break;
     case OutputInterface::Transform::Rotated270:
+        x = width - uy;
+        y = ux;
+        break;
+    case OutputInterface::Transform::Flipped:
+        x = width - ux;
+        break;
+    case OutputInterface::Transform::Flipped90:
+        x = uy;
+        y = ux;
+        break;
+    case OutputInterface::Transform::Flipped180:
+        y = height - uy;
+        break;
     case OutputInterface::Transform::Flipped270:
-        surfaceToBufferMatrix.translate(bufferSize.width() / current.bufferScale, 0);
-        surfaceToBufferMatrix.rotate(-270, 0, 0, 1);
+        x = width - uy;
+        y = height - ux;
         break;
     }
+}
 
-    switch (current.bufferTransform) {
+template<typename T>
+static void applyInverseBufferTransform(OutputInterface::Transform transform, T width, T height, T &x, T &y)
+{
+    const T bx = x;
+    const T by = y;
+    switch (transform) {
+    case OutputInterface::Transform::Normal:
+        break;
+    case OutputInterface::Transform::Rotated90:
+        x = height - by;
+        y = bx;
+        break;
+    case OutputInterface::Transform::Rotated180:
+        x = width - bx;
+        y = height - by;
+        break;
+    case OutputInterface::Transform::Rotated270:
+        x = by;
+        y = width - bx;
+        break;
     case OutputInterface::Transform::Flipped:
-    case OutputInterface::Transform::Flipped180:
-        surfaceToBufferMatrix.translate(bufferSize.width() / current.bufferScale, 0);
-        surfaceToBufferMatrix.scale(-1, 1);
+        x = width - bx;
         break;
     case OutputInterface::Transform::Flipped90:
-    case OutputInterface::Transform::Flipped270:
-        surfaceToBufferMatrix.translate(bufferSize.height() / current.bufferScale, 0);
-        surfaceToBufferMatrix.scale(-1, 1);
+        x = by;
+        y = bx;
+        break;
+    case OutputInterface::Transform::Flipped180:
+        y = height - by;
         break;
-    default:
+    case OutputInterface::Transform::Flipped270:
+        x = height - by;
+        y = width - bx;
         break;
     }
+}
+
+static QRect normalizedRect(qint64 x0, qint64 y0, qint64 x1, qint64 y1)
+{
+    return rectFromEdges(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1));
+}
 
-    if (current.viewport.sourceGeometry.isValid()) {
-        surfaceToBufferMatrix.translate(current.viewport.sourceGeometry.x(), current.viewport.sourceGeometry.y());
+static QRectF normalizedRect(const QPointF &a, const QPointF &b)
+{
+    return QRectF(a, b).normalized();
+}
+
+bool SurfaceToBufferTransform::update(qint32 bufferScale,
+                                      OutputInterface::Transform bufferTransform,
+                                      const QSize &bufferSize,
+                                      const QRectF &sourceGeometry,
+                                      const QSize &surfaceSize)
+{
+    if (m_bufferScale == bufferScale && m_bufferTransform == bufferTransform && m_bufferSize == bufferSize
+        && m_sourceGeometry == sourceGeometry && m_surfaceSize == surfaceSize) {
+        return false;
     }
 
+    m_bufferScale = bufferScale;
+    m_bufferTransform = bufferTransform;
+    m_bufferSize = bufferSize;
+    m_sourceGeometry = sourceGeometry;
+    m_surfaceSize = surfaceSize;
+
+    m_width = bufferSize.width() / bufferScale;
+    m_height = bufferSize.height() / bufferScale;
+
     QSizeF sourceSize;
-    if (current.viewport.sourceGeometry.isValid()) {
-        sourceSize = current.viewport.sourceGeometry.size();
+    if (sourceGeometry.isValid()) {
+        m_offset = sourceGeometry.topLeft();
+        sourceSize = sourceGeometry.size();
     } else {
-        sourceSize = implicitSurfaceSize;
+        m_offset = QPointF(0, 0);
+        sourceSize = bufferSize / bufferScale;
+        switch (bufferTransform) {
+        case OutputInterface::Transform::Rotated90:
+        case OutputInterface::Transform::Rotated270:
+        case OutputInterface::Transform::Flipped90:
+        case OutputInterface::Transform::Flipped270:
+            sourceSize.transpose();
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!surfaceSize.isEmpty() && sourceSize != surfaceSize) {
+        m_scaleX = sourceSize.width() / surfaceSize.width();
+        m_scaleY = sourceSize.height() / surfaceSize.height();
+    } else {
+        m_scaleX = 1;
+        m_scaleY = 1;
+    }
+
+    m_integral = m_scaleX == 1 && m_scaleY == 1 && m_offset.x() == std::floor(m_offset.x()) && m_offset.y() == std::floor(m_offset.y());
+    return true;
+}
+
+QPointF SurfaceToBufferTransform::map(const QPointF &point) const
+{
+    qreal x = point.x() * m_scaleX + m_offset.x();
+    qreal y = point.y() * m_scaleY + m_offset.y();
+    applyBufferTransform<qreal>(m_bufferTransform, m_width, m_height, x, y);
+    return QPointF(x * m_bufferScale, y * m_bufferScale);
+}
+
+QPointF SurfaceToBufferTransform::inverseMap(const QPointF &point) const
+{
+    qreal x = point.x() / m_bufferScale;
+    qreal y = point.y() / m_bufferScale;
+    applyInverseBufferTransform<qreal>(m_bufferTransform, m_width, m_height, x, y);
+    return QPointF((x - m_offset.x()) / m_scaleX, (y - m_offset.y()) / m_scaleY);
+}
+
+QRect SurfaceToBufferTransform::map(const QRect &rect) const
+{
+    if (!m_integral) {
+        return normalizedRect(map(QPointF(rect.topLeft())), map(QPointF(rect.x() + rect.width(), rect.y() + rect.height()))).toAlignedRect();
     }
 
-    if (sourceSize != surfaceSize) {
-        surfaceToBufferMatrix.scale(sourceSize.width() / surfaceSize.width(), sourceSize.height() / surfaceSize.height());
+    qint64 x0 = qint64(rect.x()) + qint64(m_offset.x());
+    qint64 y0 = qint64(rect.y()) + qint64(m_offset.y());
+    qint64 x1 = x0 + rect.width();
+    qint64 y1 = y0 + rect.height();
+    applyBufferTransform<qint64>(m_bufferTransform, m_width, m_height, x0, y0);
+    applyBufferTransform<qint64>(m_bufferTransform, m_width, m_height, x1, y1);
+    return normalizedRect(x0 * m_bufferScale, y0 * m_bufferScale, x1 * m_bufferScale, y1 * m_bufferScale);
+}
+
+QRect SurfaceToBufferTransform::inverseMap(const QRect &rect) const
+{
+    if (!m_integral) {
+        return normalizedRect(inverseMap(QPointF(rect.topLeft())), inverseMap(QPointF(rect.x() + rect.width(), rect.y() + rect.height()))).toAlignedRect();
     }
 
-    return surfaceToBufferMatrix;
+    // Undo the buffer scale first, rounding outwards so that partially covered pixels are kept.
+    qint64 x0 = floorDiv(rect.x(), m_bufferScale);
+    qint64 y0 = floorDiv(rect.y(), m_bufferScale);
+    qint64 x1 = ceilDiv(qint64(rect.x()) + rect.width(), m_bufferScale);
+    qint64 y1 = ceilDiv(qint64(rect.y()) + rect.height(), m_bufferScale);
+    applyInverseBufferTransform<qint64>(m_bufferTransform, m_width, m_height, x0, y0);
+    applyInverseBufferTransform<qint64>(m_bufferTransform, m_width, m_height, x1, y1);
+    const qint64 offsetX = m_offset.x();
+    const qint64 offsetY = m_offset.y();
+    return normalizedRect(x0 - offsetX, y0 - offsetY, x1 - offsetX, y1 - offsetY);
+}
+
+QMatrix4x4 SurfaceToBufferTransform::toMatrix() const
+{
+    const QPointF origin = map(QPointF(0, 0));
+    const QPointF xAxis = map(QPointF(1, 0)) - origin;
+    const QPointF yAxis = map(QPointF(0, 1)) - origin;
+    return QMatrix4x4(xAxis.x(), yAxis.x(), 0, origin.x(),
+                      xAxis.y(), yAxis.y(), 0, origin.y(),
+                      0, 0, 1, 0,
+                      0, 0, 0, 1);
 }
 
 void SurfaceState::mergeInto(SurfaceState *target)
 {
-    if (bufferIsSet) {
+    if (committed & Field::Buffer) {
         target->buffer = buffer;
         target->offset = offset;
         target->damage = damage;
         target->bufferDamage = bufferDamage;
-        target->bufferIsSet = bufferIsSet;
     }
-    if (viewport.sourceGeometryIsSet) {
+    if (committed & Field::ViewportSourceGeometry) {
         target->viewport.sourceGeometry = viewport.sourceGeometry;
-        target->viewport.sourceGeometryIsSet = true;
     }
-    if (viewport.destinationSizeIsSet) {
+    if (committed & Field::ViewportDestinationSize) {
         target->viewport.destinationSize = viewport.destinationSize;
-        target->viewport.destinationSizeIsSet = true;
     }
-    if (childrenChanged) {
+    if (committed & Field::Children) {
         target->below = below;
         target->above = above;
-        target->childrenChanged = true;
     }
     wl_list_insert_list(&target->frameCallbacks, &frameCallbacks);
+    if (!wl_list_empty(&presentationFeedbacks)) {
+        // This content update supersedes the one of the target.
+        PresentationFeedbackPrivate::discard(&target->presentationFeedbacks);
+        wl_list_insert_list(&target->presentationFeedbacks, &presentationFeedbacks);
+    }
 
-    if (shadowIsSet) {
+    if (committed & Field::Shadow) {
         target->shadow = shadow;
-        target->shadowIsSet = true;
     }
-    if (blurIsSet) {
+    if (committed & Field::Blur) {
         target->blur = blur;
-        target->blurIsSet = true;
     }
-    if (contrastIsSet) {
+    if (committed & Field::Contrast) {
         target->contrast = contrast;
-        target->contrastIsSet = true;
     }
-    if (slideIsSet) {
+    if (committed & Field::Slide) {
         target->slide = slide;
-        target->slideIsSet = true;
     }
-    if (inputIsSet) {
+    if (committed & Field::Input) {
         target->input = input;
-        target->inputIsSet = true;
     }
-    if (opaqueIsSet) {
+    if (committed & Field::Opaque) {
         target->opaque = opaque;
-        target->opaqueIsSet = true;
     }
-    if (bufferScaleIsSet) {
+    if (committed & Field::BufferScale) {
         target->bufferScale = bufferScale;
-        target->bufferScaleIsSet = true;
     }
-    if (bufferTransformIsSet) {
+    if (committed & Field::BufferTransform) {
         target->bufferTransform = bufferTransform;
-        target->bufferTransformIsSet = true;
     }
+    target->committed |= committed;
 
-    *this = SurfaceState{};
+    // Only the fields that accumulate across requests need to be reset, the others are
+    // overwritten before their bit is set again. The stacking order is shared with the
+    // target, which is an implicitly shared copy rather than a reallocation.
+    committed = Fields();
+    damage.clear();
+    bufferDamage.clear();
     below = target->below;
     above = target->above;
     wl_list_init(&frameCallbacks);
+    wl_list_init(&presentationFeedbacks);
 }
 
 void SurfaceInterfacePrivate::applyState(SurfaceState *next)
 {
-    const bool bufferChanged = next->bufferIsSet;
-    const bool opaqueRegionChanged = next->opaqueIsSet;
-    const bool scaleFactorChanged = next->bufferScaleIsSet && (current.bufferScale != next->bufferScale);
-    const bool transformChanged = next->bufferTransformIsSet && (current.bufferTransform != next->bufferTransform);
-    const bool shadowChanged = next->shadowIsSet;
-    const bool blurChanged = next->blurIsSet;
-    const bool contrastChanged = next->contrastIsSet;
-    const bool slideChanged = next->slideIsSet;
-    const bool childrenChanged = next->childrenChanged;
+    const bool bufferChanged = next->committed & SurfaceState::Field::Buffer;
+    const bool opaqueRegionChanged = next->committed & SurfaceState::Field::Opaque;
+    const bool inputRegionChanged = next->committed & SurfaceState::Field::Input;
+    const bool scaleFactorChanged = (next->committed & SurfaceState::Field::BufferScale) && (current.bufferScale != next->bufferScale);
+    const bool transformChanged = (next->committed & SurfaceState::Field::BufferTransform) && (current.bufferTransform != next->bufferTransform);
+    const bool shadowChanged = next->committed & SurfaceState::Field::Shadow;
+    const bool blurChanged = next->committed & SurfaceState::Field::Blur;
+    const bool contrastChanged = next->committed & SurfaceState::Field::Contrast;
+    const bool slideChanged = next->committed & SurfaceState::Field::Slide;
+    const bool childrenChanged = next->committed & SurfaceState::Field::Children;
     const bool visibilityChanged = bufferChanged && bool(current.buffer) != bool(next->buffer);
 
     const QSize oldSurfaceSize = surfaceSize;
     const QSize oldBufferSize = bufferSize;
-    const QMatrix4x4 oldSurfaceToBufferMatrix = surfaceToBufferMatrix;
-    const QRegion oldInputRegion = inputRegion;
 
     next->mergeInto(&current);
 
@@ -589,13 +838,30 @@ void SurfaceInterfacePrivate::applyState(SurfaceState *next)
         bufferSize = QSize();
     }
 
-    surfaceToBufferMatrix = buildSurfaceToBufferMatrix();
-    bufferToSurfaceMatrix = surfaceToBufferMatrix.inverted();
-    inputRegion = current.input & QRect(QPoint(0, 0), surfaceSize);
+    // Most commits only replace the buffer, so only rebuild the transform if one of its inputs changed.
+    const SurfaceToBufferTransform oldSurfaceToBuffer = surfaceToBuffer;
+    bool surfaceToBufferUpdated;
+    if (current.buffer) {
+        surfaceToBufferUpdated = surfaceToBuffer.update(current.bufferScale, current.bufferTransform, bufferSize, current.viewport.sourceGeometry, surfaceSize);
+    } else {
+        surfaceToBufferUpdated = surfaceToBuffer.update(1, OutputInterface::Transform::Normal, QSize(), QRectF(), QSize());
+    }
+    const bool surfaceToBufferChanged = surfaceToBufferUpdated && surfaceToBuffer.toMatrix() != oldSurfaceToBuffer.toMatrix();
+    bool effectiveInputRegionChanged = false;
+    if (inputRegionChanged || surfaceSize != oldSurfaceSize) {
+        const QRegion effectiveInputRegion = current.input & QRect(QPoint(0, 0), surfaceSize);
+        if (effectiveInputRegion != inputRegion) {
+            inputRegion = effectiveInputRegion;
+            effectiveInputRegionChanged = true;
+        }
+    }
+    if (surfaceSize != oldSurfaceSize || effectiveInputRegionChanged || childrenChanged) {
+        invalidateHitTestCache();
+    }
     if (opaqueRegionChanged) {
         Q_EMIT q->opaqueChanged(current.opaque);
     }
-    if (oldInputRegion != inputRegion) {
+    if (effectiveInputRegionChanged) {
         Q_EMIT q->inputChanged(inputRegion);
     }
     if (scaleFactorChanged) {
@@ -608,14 +874,26 @@ void SurfaceInterfacePrivate::applyState(SurfaceState *next)
         updateEffectiveMapped();
     }
     if (bufferChanged) {
+        damageRegion = QRegion();
         if (current.buffer && (!current.damage.isEmpty() || !current.bufferDamage.isEmpty())) {
-            const QRegion windowRegion = QRegion(0, 0, q->size().width(), q->size().height());
-            const QRegion bufferDamage = q->mapFromBuffer(current.bufferDamage);
-            current.damage = windowRegion.intersected(current.damage.united(bufferDamage));
-            Q_EMIT q->damaged(current.damage);
+            const QRect surfaceRect(QPoint(0, 0), surfaceSize);
+            for (const QRect &rect : current.damage) {
+                const QRect clipped = rect & surfaceRect;
+                if (!clipped.isEmpty()) {
+                    damageRegion += clipped;
+                }
+            }
+            const QRect bufferRect(QPoint(0, 0), bufferSize);
+            for (const QRect &rect : current.bufferDamage) {
+                const QRect clipped = surfaceToBuffer.inverseMap(rect & bufferRect) & surfaceRect;
+                if (!clipped.isEmpty()) {
+                    damageRegion += clipped;
+                }
+            }
+            Q_EMIT q->damaged(damageRegion);
         }
     }
-    if (surfaceToBufferMatrix != oldSurfaceToBufferMatrix) {
+    if (surfaceToBufferChanged) {
         Q_EMIT q->surfaceToBufferMatrixChanged();
     }
     if (bufferSize != oldBufferSize) {
@@ -693,6 +971,7 @@ void SurfaceInterfacePrivate::updateEffectiveMapped()
     }
 
     mapped = effectiveMapped;
+    invalidateHitTestCache();
 
     if (mapped) {
         Q_EMIT q->mapped();
@@ -712,7 +991,17 @@ void SurfaceInterfacePrivate::updateEffectiveMapped()
 
 QRegion SurfaceInterface::damage() const
 {
-    return d->current.damage;
+    return d->damageRegion;
+}
+
+void SurfaceInterface::setDamagePolicy(DamagePolicy policy)
+{
+    d->damagePolicy = policy;
+}
+
+SurfaceInterface::DamagePolicy SurfaceInterface::damagePolicy() const
+{
+    return d->damagePolicy;
 }
 
 QRegion SurfaceInterface::opaque() const
@@ -841,6 +1130,7 @@ void SurfaceInterface::setOutputs(const QVector<OutputInterface *> &outputs)
         }
         disconnect(d->outputDestroyedConnections.take(*it));
         disconnect(d->outputBoundConnections.take(*it));
+        disconnect(d->outputScaleConnections.take(*it));
     }
     QVector<OutputInterface *> addedOutputsOutputs = outputs;
     for (auto it = d->outputs.constBegin(), end = d->outputs.constEnd(); it != end; ++it) {
@@ -867,9 +1157,13 @@ void SurfaceInterface::setOutputs(const QVector<OutputInterface *> &outputs)
             }
             d->send_enter(outputResource);
         });
+        d->outputScaleConnections[o] = connect(o, &OutputInterface::fractionalScaleChanged, this, [this] {
+            d->updatePreferredScale();
+        });
     }
 
     d->outputs = outputs;
+    d->updatePreferredScale();
     for (auto child : qAsConst(d->current.below)) {
         child->surface()->setOutputs(outputs);
     }
@@ -878,30 +1172,97 @@ void SurfaceInterface::setOutputs(const QVector<OutputInterface *> &outputs)
     }
 }
 
-SurfaceInterface *SurfaceInterface::surfaceAt(const QPointF &position)
+qreal SurfaceInterface::preferredScale() const
 {
-    if (!isMapped()) {
-        return nullptr;
+    return d->preferredScale;
+}
+
+void SurfaceInterfacePrivate::updatePreferredScale()
+{
+    if (outputs.isEmpty()) {
+        return;
+    }
+    qreal scale = 0;
+    for (OutputInterface *output : qAsConst(outputs)) {
+        scale = std::max(scale, output->fractionalScale());
+    }
+    if (qFuzzyCompare(preferredScale, scale)) {
+        return;
+    }
+    preferredScale = scale;
+    if (fractionalScaleExtension) {
+        fractionalScaleExtension->setPreferredScale(preferredScale);
+    }
+}
+
+static void collectHitTestEntries(SurfaceInterface *surface, const QPoint &offset, QVector<HitTestCache::Entry> *entries)
+{
+    if (!surface->isMapped()) {
+        return;
+    }
+
+    const SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(surface);
+    for (auto it = surfacePrivate->current.above.crbegin(); it != surfacePrivate->current.above.crend(); ++it) {
+        const SubSurfaceInterface *subsurface = *it;
+        collectHitTestEntries(subsurface->surface(), offset + subsurface->position(), entries);
+    }
+    if (!surfacePrivate->surfaceSize.isEmpty()) {
+        entries->append(HitTestCache::Entry{surface, QRect(offset, surfacePrivate->surfaceSize)});
     }
+    for (auto it = surfacePrivate->current.below.crbegin(); it != surfacePrivate->current.below.crend(); ++it) {
+        const SubSurfaceInterface *subsurface = *it;
+        collectHitTestEntries(subsurface->surface(), offset + subsurface->position(), entries);
+    }
+}
 
-    for (auto it = d->current.above.crbegin(); it != d->current.above.crend(); ++it) {
-        const SubSurfaceInterface *current = *it;
-        SurfaceInterface *surface = current->surface();
-        if (auto s = surface->surfaceAt(position - current->position())) {
-            return s;
+void SurfaceInterfacePrivate::invalidateHitTestCache()
+{
+    // The caches of all ancestors contain this surface too.
+    SurfaceInterfacePrivate *surfacePrivate = this;
+    while (surfacePrivate) {
+        surfacePrivate->hitTestCache.valid = false;
+        if (!surfacePrivate->subSurface || !surfacePrivate->subSurface->parentSurface()) {
+            break;
         }
+        surfacePrivate = get(surfacePrivate->subSurface->parentSurface());
+    }
+}
+
+void SurfaceInterfacePrivate::updateHitTestCache()
+{
+    if (hitTestCache.valid) {
+        return;
+    }
+
+    // resize() keeps the capacity, unlike clear()
+    hitTestCache.entries.resize(0);
+    collectHitTestEntries(q, QPoint(0, 0), &hitTestCache.entries);
+
+    QRect bounds;
+    for (const HitTestCache::Entry &entry : qAsConst(hitTestCache.entries)) {
+        bounds |= entry.geometry;
+    }
+    hitTestCache.bounds = bounds;
+    hitTestCache.valid = true;
+    hitTestCache.statistics.rebuilds++;
+}
+
+SurfaceInterface *SurfaceInterface::surfaceAt(const QPointF &position)
+{
+    if (!isMapped()) {
+        return nullptr;
     }
 
-    // check whether the geometry contains the pos
-    if (!size().isEmpty() && QRectF(QPoint(0, 0), size()).contains(position)) {
-        return this;
+    d->updateHitTestCache();
+    d->hitTestCache.statistics.queries++;
+    if (!d->hitTestCache.bounds.contains(position)) {
+        d->hitTestCache.statistics.rejected++;
+        return nullptr;
     }
 
-    for (auto it = d->current.below.crbegin(); it != d->current.below.crend(); ++it) {
-        const SubSurfaceInterface *current = *it;
-        SurfaceInterface *surface = current->surface();
-        if (auto s = surface->surfaceAt(position - current->position())) {
-            return s;
+    for (const HitTestCache::Entry &entry : qAsConst(d->hitTestCache.entries)) {
+        if (QRectF(entry.geometry).contains(position)) {
+            return entry.surface;
         }
     }
     return nullptr;
@@ -909,36 +1270,35 @@ SurfaceInterface *SurfaceInterface::surfaceAt(const QPointF &position)
 
 SurfaceInterface *SurfaceInterface::inputSurfaceAt(const QPointF &position)
 {
-    // TODO: Most of this is very similar to SurfaceInterface::surfaceAt
-    //       Is there a way to reduce the code duplication?
     if (!isMapped()) {
         return nullptr;
     }
 
-    for (auto it = d->current.above.crbegin(); it != d->current.above.crend(); ++it) {
-        const SubSurfaceInterface *current = *it;
-        auto surface = current->surface();
-        if (auto s = surface->inputSurfaceAt(position - current->position())) {
-            return s;
-        }
+    d->updateHitTestCache();
+    d->hitTestCache.statistics.queries++;
+    if (!d->hitTestCache.bounds.contains(position)) {
+        d->hitTestCache.statistics.rejected++;
+        return nullptr;
     }
 
     // check whether the geometry and input region contain the pos
-    if (!size().isEmpty() && QRectF(QPoint(0, 0), size()).contains(position) && input().contains(position.toPoint())) {
-        return this;
-    }
-
-    for (auto it = d->current.below.crbegin(); it != d->current.below.crend(); ++it) {
-        const SubSurfaceInterface *current = *it;
-        auto surface = current->surface();
-        if (auto s = surface->inputSurfaceAt(position - current->position())) {
-            return s;
+    for (const HitTestCache::Entry &entry : qAsConst(d->hitTestCache.entries)) {
+        if (!QRectF(entry.geometry).contains(position)) {
+            continue;
+        }
+        const QPointF localPosition = position - entry.geometry.topLeft();
+        if (SurfaceInterfacePrivate::get(entry.surface)->inputRegion.contains(localPosition.toPoint())) {
+            return entry.surface;
         }
     }
-
     return nullptr;
 }
 
+SurfaceInterface::HitTestStatistics SurfaceInterface::hitTestStatistics() const
+{
+    return d->hitTestCache.statistics;
+}
+
 LockedPointerV1Interface *SurfaceInterface::lockedPointer() const
 {
     return d->lockedPointer;
@@ -961,36 +1321,45 @@ LinuxDmaBufV1Feedback *SurfaceInterface::dmabufFeedbackV1() const
 
 QPointF SurfaceInterface::mapToBuffer(const QPointF &point) const
 {
-    return d->surfaceToBufferMatrix.map(point);
+    return d->surfaceToBuffer.map(point);
 }
 
 QPointF SurfaceInterface::mapFromBuffer(const QPointF &point) const
 {
-    return d->bufferToSurfaceMatrix.map(point);
+    return d->surfaceToBuffer.inverseMap(point);
 }
 
-static QRegion map_helper(const QMatrix4x4 &matrix, const QRegion &region)
+QRegion SurfaceInterface::mapToBuffer(const QRegion &region) const
 {
     QRegion result;
     for (const QRect &rect : region) {
-        result += matrix.mapRect(rect);
+        result += d->surfaceToBuffer.map(rect);
     }
     return result;
 }
 
-QRegion SurfaceInterface::mapToBuffer(const QRegion &region) const
+QRegion SurfaceInterface::mapFromBuffer(const QRegion &region) const
 {
-    return map_helper(d->surfaceToBufferMatrix, region);
+    QRegion result;
+    for (const QRect &rect : region) {
+        result += d->surfaceToBuffer.inverseMap(rect);
+    }
+    return result;
 }
 
-QRegion SurfaceInterface::mapFromBuffer(const QRegion &region) const
+QRect SurfaceInterface::mapToBuffer(const QRect &rect) const
+{
+    return d->surfaceToBuffer.map(rect);
+}
+
+QRect SurfaceInterface::mapFromBuffer(const QRect &rect) const
 {
-    return map_helper(d->bufferToSurfaceMatrix, region);
+    return d->surfaceToBuffer.inverseMap(rect);
 }
 
 QMatrix4x4 SurfaceInterface::surfaceToBufferMatrix() const
 {
-    return d->surfaceToBufferMatrix;
+    return d->surfaceToBuffer.toMatrix();
 }
 
 QPointF SurfaceInterface::mapToChild(SurfaceInterface *child, const QPointF &point) const
@@ -28,6 +28,7 @@ class SlideInterface;
 class SubSurfaceInterface;
 class SurfaceInterfacePrivate;
 class LinuxDmaBufV1Feedback;
+class PresentationFeedback;
 
 /**
  * @brief Resource representing a wl_surface.
@@ -74,6 +75,43 @@ class KWAYLANDSERVER_EXPORT SurfaceInterface : public QObject
     Q_PROPERTY(KWaylandServer::OutputInterface::Transform bufferTransform READ bufferTransform NOTIFY bufferTransformChanged)
     Q_PROPERTY(QSize size READ size NOTIFY sizeChanged)
 public:
+    /**
+     * This enum type is used to specify how the damage posted by the client gets simplified
+     * once it consists of more rectangles than the surface keeps track of.
+     */
+    enum class DamagePolicy {
+        /**
+         * The damage is collapsed into its bounding rectangle.
+         */
+        BoundingRect,
+        /**
+         * The damage is snapped to a grid of 64x64 tiles and the tiles which waste the least
+         * area when combined are merged.
+         */
+        Tiled,
+    };
+
+    /**
+     * This struct holds statistics about the hit-tests done with surfaceAt() and inputSurfaceAt().
+     *
+     * @see hitTestStatistics()
+     */
+    struct HitTestStatistics {
+        /**
+         * The number of surfaceAt() and inputSurfaceAt() calls on a mapped surface.
+         */
+        quint64 queries = 0;
+        /**
+         * The number of times the sub-surface tree had to be flattened again because it changed.
+         */
+        quint64 rebuilds = 0;
+        /**
+         * The number of queries answered without looking at individual surfaces because the
+         * position was outside of the bounding rectangle of the sub-surface tree.
+         */
+        quint64 rejected = 0;
+    };
+
     explicit SurfaceInterface(CompositorInterface *compositor, wl_resource *resource);
     ~SurfaceInterface() override;
 
@@ -142,6 +180,29 @@ public:
      * @see surfaceToBufferMatrix(), surfaceToBufferMatrixChanged()
      */
     QRegion mapFromBuffer(const QRegion &region) const;
+    /**
+     * Maps the specified @a rect from the surface-local coordinates to buffer pixel coordinates.
+     *
+     * The returned rectangle includes every buffer pixel that is partially covered by the @a rect.
+     * Unless the surface has a viewport that scales the buffer, the mapping is done with integer
+     * math and is cheap enough to be used per input event.
+     *
+     * The returned value will become invalid when the surfaceToBufferMatrixChanged() signal is emitted.
+     *
+     * @see mapFromBuffer(), surfaceToBufferMatrixChanged()
+     */
+    QRect mapToBuffer(const QRect &rect) const;
+    /**
+     * Maps the specified @a rect from the buffer pixel coordinates to surface-local coordinates.
+     *
+     * The returned rectangle includes every surface-local pixel that is partially covered by
+     * the @a rect.
+     *
+     * The returned value will become invalid when the surfaceToBufferMatrixChanged() signal is emitted.
+     *
+     * @see mapToBuffer(), surfaceToBufferMatrixChanged()
+     */
+    QRect mapFromBuffer(const QRect &rect) const;
     /**
      * Returns the projection matrix from the surface-local coordinates to buffer coordinates.
      *
@@ -159,8 +220,31 @@ public:
 
     void frameRendered(quint32 msec);
     bool hasFrameCallbacks() const;
+    /**
+     * Takes the presentation feedback the client requested for the current content update,
+     * @c null if there is none. The caller takes ownership.
+     *
+     * The compositor should take it when it starts showing the content update, e.g. when it
+     * schedules the frame containing it, and report the outcome once the frame is on screen.
+     * A feedback which is not taken is discarded when the client commits new content.
+     *
+     * The feedback only covers this surface, not its sub-surfaces.
+     *
+     * @see PresentationTimeInterface
+     */
+    PresentationFeedback *takePresentationFeedback();
 
     QRegion damage() const;
+    /**
+     * Sets the policy that is used to simplify the damage of this surface to @a policy.
+     *
+     * The default policy is DamagePolicy::BoundingRect.
+     */
+    void setDamagePolicy(DamagePolicy policy);
+    /**
+     * Returns the policy that is used to simplify the damage of this surface.
+     */
+    DamagePolicy damagePolicy() const;
     QRegion opaque() const;
     QRegion input() const;
     qint32 bufferScale() const;
@@ -269,6 +353,15 @@ public:
      */
     SurfaceInterface *inputSurfaceAt(const QPointF &position);
 
+    /**
+     * Returns the statistics of the hit-tests done on this SurfaceInterface.
+     *
+     * surfaceAt() and inputSurfaceAt() do not walk the sub-surface tree for every query, but
+     * test against a flattened copy of it, which is only rebuilt when the geometry, the input
+     * region, the stacking order or the mapping state of a surface in the tree changes.
+     */
+    HitTestStatistics hitTestStatistics() const;
+
     /**
      * Sets the @p outputs this SurfaceInterface overlaps with, may be empty.
      *
@@ -285,6 +378,19 @@ public:
      */
     QVector<OutputInterface *> outputs() const;
 
+    /**
+     * The scale the client should render this SurfaceInterface at, the highest
+     * OutputInterface::fractionalScale() of the outputs(). It is kept when the surface
+     * leaves all outputs.
+     *
+     * Clients which bound the fractional scale global are told about changes. They render
+     * buffers of the surface size multiplied by this scale and map them to the surface
+     * with a viewport.
+     *
+     * @see FractionalScaleManagerV1Interface
+     */
+    qreal preferredScale() const;
+
     /**
      * Pointer confinement installed on this SurfaceInterface.
      * @see pointerConstraintsChanged
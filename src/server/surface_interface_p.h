@@ -10,36 +10,145 @@
 #include "utils.h"
 // Qt
 #include <QHash>
+#include <QVarLengthArray>
 #include <QVector>
 // Wayland
 #include "qwayland-server-wayland.h"
 
 namespace KWaylandServer
 {
+class FractionalScaleV1Interface;
 class IdleInhibitorV1Interface;
 class SurfaceRole;
 class ViewportInterface;
 
+/**
+ * The DamageAccumulator collects the damage rectangles posted by a client between two commits.
+ *
+ * At most MaxRects rectangles are kept, if the client posts more than that, the rectangles are
+ * simplified according to the damage policy of the surface. This bounds both the memory and the
+ * time spent on damage per commit, no matter how many rectangles the client sends.
+ */
+class DamageAccumulator
+{
+public:
+    static constexpr int MaxRects = 16;
+    static constexpr int TileSize = 64;
+
+    void add(const QRect &rect, SurfaceInterface::DamagePolicy policy);
+    void clear();
+
+    bool isEmpty() const
+    {
+        return m_rects.isEmpty();
+    }
+    const QRect *begin() const
+    {
+        return m_rects.constBegin();
+    }
+    const QRect *end() const
+    {
+        return m_rects.constEnd();
+    }
+
+private:
+    void simplify(SurfaceInterface::DamagePolicy policy);
+
+    QVarLengthArray<QRect, MaxRects + 1> m_rects;
+};
+
+/**
+ * The SurfaceToBufferTransform maps surface-local coordinates to buffer pixel coordinates.
+ *
+ * The mapping is made of the viewport crop and scale, one of the eight buffer transforms and the
+ * buffer scale, so it is kept in that form instead of a 4x4 matrix. This makes the inverse free
+ * and allows mapping rectangles with exact integer math unless the viewport scales the buffer.
+ */
+class SurfaceToBufferTransform
+{
+public:
+    /**
+     * Recomputes the transform for the given inputs. Returns @c false without doing anything
+     * if the inputs have not changed since the last call.
+     */
+    bool update(qint32 bufferScale,
+                OutputInterface::Transform bufferTransform,
+                const QSize &bufferSize,
+                const QRectF &sourceGeometry,
+                const QSize &surfaceSize);
+
+    QPointF map(const QPointF &point) const;
+    QPointF inverseMap(const QPointF &point) const;
+    QRect map(const QRect &rect) const;
+    QRect inverseMap(const QRect &rect) const;
+    QMatrix4x4 toMatrix() const;
+
+private:
+    qint32 m_bufferScale = 1;
+    OutputInterface::Transform m_bufferTransform = OutputInterface::Transform::Normal;
+    QSize m_bufferSize;
+    QRectF m_sourceGeometry;
+    QSize m_surfaceSize;
+
+    qint64 m_width = 0;
+    qint64 m_height = 0;
+    QPointF m_offset;
+    qreal m_scaleX = 1;
+    qreal m_scaleY = 1;
+    bool m_integral = true;
+};
+
+/**
+ * The HitTestCache is a flattened copy of a sub-surface tree, sorted from the top-most to the
+ * bottom-most surface. Each entry holds the geometry of a mapped surface in the coordinates of
+ * the surface that owns the cache.
+ */
+struct HitTestCache {
+    struct Entry {
+        SurfaceInterface *surface;
+        QRect geometry;
+    };
+
+    QVector<Entry> entries;
+    QRectF bounds;
+    bool valid = false;
+    SurfaceInterface::HitTestStatistics statistics;
+};
+
 struct SurfaceState {
+    /**
+     * The fields set by the client since the state was last merged. A field which is not
+     * marked as committed holds a stale value and must not be read.
+     */
+    enum class Field : uint {
+        Buffer = 1 << 0,
+        Opaque = 1 << 1,
+        Input = 1 << 2,
+        Shadow = 1 << 3,
+        Blur = 1 << 4,
+        Contrast = 1 << 5,
+        Slide = 1 << 6,
+        Children = 1 << 7,
+        BufferScale = 1 << 8,
+        BufferTransform = 1 << 9,
+        ViewportSourceGeometry = 1 << 10,
+        ViewportDestinationSize = 1 << 11,
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+
     void mergeInto(SurfaceState *target);
 
-    QRegion damage = QRegion();
-    QRegion bufferDamage = QRegion();
+    Fields committed;
+    DamageAccumulator damage;
+    DamageAccumulator bufferDamage;
     QRegion opaque = QRegion();
     QRegion input = infiniteRegion();
-    bool inputIsSet = false;
-    bool opaqueIsSet = false;
-    bool bufferIsSet = false;
-    bool shadowIsSet = false;
-    bool blurIsSet = false;
-    bool contrastIsSet = false;
-    bool slideIsSet = false;
-    bool childrenChanged = false;
-    bool bufferScaleIsSet = false;
-    bool bufferTransformIsSet = false;
     qint32 bufferScale = 1;
     OutputInterface::Transform bufferTransform = OutputInterface::Transform::Normal;
     wl_list frameCallbacks;
+    // The wp_presentation_feedback resources of this content update, the ones of an older
+    // update which has not been taken by the compositor yet are discarded on merge.
+    wl_list presentationFeedbacks;
     QPoint offset = QPoint();
     QPointer<ClientBuffer> buffer;
     QPointer<ShadowInterface> shadow;
@@ -56,11 +165,11 @@ struct SurfaceState {
     struct {
         QRectF sourceGeometry = QRectF();
         QSize destinationSize = QSize();
-        bool sourceGeometryIsSet = false;
-        bool destinationSizeIsSet = false;
     } viewport;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(SurfaceState::Fields)
+
 class SurfaceInterfacePrivate : public QtWaylandServer::wl_surface
 {
 public:
@@ -88,11 +197,14 @@ public:
     void commitFromCache();
 
     void commitSubSurface();
-    QMatrix4x4 buildSurfaceToBufferMatrix();
     void applyState(SurfaceState *next);
 
     bool computeEffectiveMapped() const;
     void updateEffectiveMapped();
+    void updatePreferredScale();
+
+    void invalidateHitTestCache();
+    void updateHitTestCache();
 
     CompositorInterface *compositor;
     SurfaceInterface *q;
@@ -101,25 +213,30 @@ public:
     SurfaceState pending;
     SurfaceState cached;
     SubSurfaceInterface *subSurface = nullptr;
-    QMatrix4x4 surfaceToBufferMatrix;
-    QMatrix4x4 bufferToSurfaceMatrix;
+    SurfaceToBufferTransform surfaceToBuffer;
     QSize bufferSize;
     QSize implicitSurfaceSize;
     QSize surfaceSize;
     QRegion inputRegion;
+    QRegion damageRegion;
+    HitTestCache hitTestCache;
+    SurfaceInterface::DamagePolicy damagePolicy = SurfaceInterface::DamagePolicy::BoundingRect;
     ClientBuffer *bufferRef = nullptr;
     bool mapped = false;
     bool hasCacheState = false;
 
     QVector<OutputInterface *> outputs;
+    qreal preferredScale = 1;
 
     LockedPointerV1Interface *lockedPointer = nullptr;
     ConfinedPointerV1Interface *confinedPointer = nullptr;
     QHash<OutputInterface *, QMetaObject::Connection> outputDestroyedConnections;
     QHash<OutputInterface *, QMetaObject::Connection> outputBoundConnections;
+    QHash<OutputInterface *, QMetaObject::Connection> outputScaleConnections;
 
     QVector<IdleInhibitorV1Interface *> idleInhibitors;
     ViewportInterface *viewportExtension = nullptr;
+    FractionalScaleV1Interface *fractionalScaleExtension = nullptr;
     QScopedPointer<LinuxDmaBufV1Feedback> dmabufFeedbackV1;
     ClientConnection *client = nullptr;
 
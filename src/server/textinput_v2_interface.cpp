@@ -154,7 +154,7 @@ void TextInputV2InterfacePrivate::sendEnter(SurfaceInterface *newSurface, quint3
     // It should be always synchronized with SeatInterface::focusedTextInputSurface.
     Q_ASSERT(!surface && newSurface);
     surface = newSurface;
-    const auto clientResources = textInputsForClient(newSurface->client());
+    const auto &clientResources = textInputsForClient(newSurface->client());
     for (auto resource : clientResources) {
         send_enter(resource->handle, serial, newSurface->resource());
     }
@@ -166,7 +166,7 @@ void TextInputV2InterfacePrivate::sendLeave(quint32 serial, SurfaceInterface *le
     Q_ASSERT(leavingSurface && surface == leavingSurface);
     EnabledEmitter emitter(q);
     surface.clear();
-    const auto clientResources = textInputsForClient(leavingSurface->client());
+    const auto &clientResources = textInputsForClient(leavingSurface->client());
     for (auto resource : clientResources) {
         send_leave(resource->handle, serial, leavingSurface->resource());
     }
@@ -178,7 +178,7 @@ void TextInputV2InterfacePrivate::preEdit(const QString &text, const QString &co
         return;
     }
 
-    const auto clientResources = textInputsForClient(surface->client());
+    const auto &clientResources = textInputsForClient(surface->client());
     for (auto resource : clientResources) {
         send_preedit_string(resource->handle, text, commit);
     }
@@ -190,7 +190,7 @@ void TextInputV2InterfacePrivate::preEditStyling(uint32_t index, uint32_t length
         return;
     }
 
-    const auto clientResources = textInputsForClient(surface->client());
+    const auto &clientResources = textInputsForClient(surface->client());
     for (auto resource : clientResources) {
         send_preedit_styling(resource->handle, index, length, style);
     }
@@ -201,7 +201,7 @@ void TextInputV2InterfacePrivate::commitString(const QString &text)
     if (!surface) {
         return;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_commit_string(resource->handle, text);
     }
@@ -213,7 +213,7 @@ void TextInputV2InterfacePrivate::keysymPressed(quint32 keysym, quint32 modifier
         return;
     }
 
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_keysym(resource->handle, seat ? seat->timestamp() : 0, keysym, WL_KEYBOARD_KEY_STATE_PRESSED, modifiers);
     }
@@ -225,7 +225,7 @@ void TextInputV2InterfacePrivate::keysymReleased(quint32 keysym, quint32 modifie
         return;
     }
 
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_keysym(resource->handle, seat ? seat->timestamp() : 0, keysym, WL_KEYBOARD_KEY_STATE_RELEASED, modifiers);
     }
@@ -236,7 +236,7 @@ void TextInputV2InterfacePrivate::deleteSurroundingText(quint32 beforeLength, qu
     if (!surface) {
         return;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_delete_surrounding_text(resource->handle, beforeLength, afterLength);
     }
@@ -247,7 +247,7 @@ void TextInputV2InterfacePrivate::setCursorPosition(qint32 index, qint32 anchor)
     if (!surface) {
         return;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_cursor_position(resource->handle, index, anchor);
     }
@@ -273,7 +273,7 @@ void TextInputV2InterfacePrivate::setTextDirection(Qt::LayoutDirection direction
         Q_UNREACHABLE();
         break;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_text_direction(resource->handle, wlDirection);
     }
@@ -284,7 +284,7 @@ void TextInputV2InterfacePrivate::setPreEditCursor(qint32 index)
     if (!surface) {
         return;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_preedit_cursor(resource->handle, index);
     }
@@ -295,7 +295,7 @@ void TextInputV2InterfacePrivate::sendInputPanelState()
     if (!surface) {
         return;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_input_panel_state(resource->handle,
                                inputPanelVisible ? ZWP_TEXT_INPUT_V2_INPUT_PANEL_VISIBILITY_VISIBLE : ZWP_TEXT_INPUT_V2_INPUT_PANEL_VISIBILITY_HIDDEN,
@@ -311,7 +311,7 @@ void TextInputV2InterfacePrivate::sendLanguage()
     if (!surface) {
         return;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_language(resource->handle, language);
     }
@@ -322,7 +322,7 @@ void TextInputV2InterfacePrivate::sendModifiersMap()
     if (!surface) {
         return;
     }
-    const QList<Resource *> textInputs = textInputsForClient(surface->client());
+    const QVector<Resource *> &textInputs = textInputsForClient(surface->client());
     for (auto resource : textInputs) {
         send_modifiers_map(resource->handle, modifiersMap);
     }
@@ -404,11 +404,16 @@ void TextInputV2InterfacePrivate::zwp_text_input_v2_set_cursor_rectangle(Resourc
     }
 }
 
-void TextInputV2InterfacePrivate::zwp_text_input_v2_set_preferred_language(Resource *resource, const QString &language)
+void TextInputV2InterfacePrivate::zwp_text_input_v2_set_preferred_language(Resource *resource, const char *language)
 {
     Q_UNUSED(resource)
-    if (preferredLanguage != language) {
-        preferredLanguage = language;
+    // Language tags are ASCII, this catches the client repeating itself without converting.
+    if (preferredLanguage == QLatin1String(language)) {
+        return;
+    }
+    const QString decoded = QString::fromUtf8(language);
+    if (preferredLanguage != decoded) {
+        preferredLanguage = decoded;
         Q_EMIT q->preferredLanguageChanged(preferredLanguage);
     }
 }
@@ -419,9 +424,9 @@ void TextInputV2InterfacePrivate::zwp_text_input_v2_show_input_panel(Resource *r
     Q_EMIT q->requestShowInputPanel();
 }
 
-QList<TextInputV2InterfacePrivate::Resource *> TextInputV2InterfacePrivate::textInputsForClient(ClientConnection *client) const
+const QVector<TextInputV2InterfacePrivate::Resource *> &TextInputV2InterfacePrivate::textInputsForClient(ClientConnection *client) const
 {
-    return resourceMap().values(client->client());
+    return resourcesForClient(client->client());
 }
 
 TextInputV2Interface::TextInputV2Interface(SeatInterface *seat)
@@ -49,7 +49,7 @@ public:
     void sendLanguage();
     void sendModifiersMap();
 
-    QList<Resource *> textInputsForClient(ClientConnection *client) const;
+    const QVector<Resource *> &textInputsForClient(ClientConnection *client) const;
     static TextInputV2InterfacePrivate *get(TextInputV2Interface *inputInterface)
     {
         return inputInterface->d.data();
@@ -79,7 +79,7 @@ protected:
     void zwp_text_input_v2_set_surrounding_text(Resource *resource, const QString &text, int32_t cursor, int32_t anchor) override;
     void zwp_text_input_v2_set_content_type(Resource *resource, uint32_t hint, uint32_t purpose) override;
     void zwp_text_input_v2_set_cursor_rectangle(Resource *resource, int32_t x, int32_t y, int32_t width, int32_t height) override;
-    void zwp_text_input_v2_set_preferred_language(Resource *resource, const QString &language) override;
+    void zwp_text_input_v2_set_preferred_language(Resource *resource, const char *language) override;
     void zwp_text_input_v2_update_state(Resource *resource, uint32_t serial, uint32_t reason) override;
 };
 
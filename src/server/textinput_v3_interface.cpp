@@ -186,7 +186,7 @@ void TextInputV3InterfacePrivate::sendEnter(SurfaceInterface *newSurface)
     // It should be always synchronized with SeatInterface::focusedTextInputSurface.
     Q_ASSERT(!surface && newSurface);
     surface = newSurface;
-    const auto clientResources = textInputsForClient(newSurface->client());
+    const auto &clientResources = textInputsForClient(newSurface->client());
     for (auto resource : clientResources) {
         send_enter(resource->handle, newSurface->resource());
     }
@@ -198,7 +198,7 @@ void TextInputV3InterfacePrivate::sendLeave(SurfaceInterface *leavingSurface)
     // It should be always synchronized with SeatInterface::focusedTextInputSurface.
     Q_ASSERT(leavingSurface && surface == leavingSurface);
     surface.clear();
-    const auto clientResources = textInputsForClient(leavingSurface->client());
+    const auto &clientResources = textInputsForClient(leavingSurface->client());
     for (auto resource : clientResources) {
         send_leave(resource->handle, leavingSurface->resource());
     }
@@ -250,18 +250,18 @@ void TextInputV3InterfacePrivate::done()
     }
 }
 
-QList<TextInputV3InterfacePrivate::Resource *> TextInputV3InterfacePrivate::textInputsForClient(ClientConnection *client) const
+const QVector<TextInputV3InterfacePrivate::Resource *> &TextInputV3InterfacePrivate::textInputsForClient(ClientConnection *client) const
 {
-    return resourceMap().values(client->client());
+    return resourcesForClient(client->client());
 }
 
 QList<TextInputV3InterfacePrivate::Resource *> TextInputV3InterfacePrivate::enabledTextInputsForClient(ClientConnection *client) const
 {
     QList<TextInputV3InterfacePrivate::Resource *> result;
-    const auto [start, end] = resourceMap().equal_range(client->client());
-    for (auto it = start; it != end; ++it) {
-        if (enabled[*it]) {
-            result.append(*it);
+    const QVector<Resource *> &textInputs = resourcesForClient(client->client());
+    for (Resource *resource : textInputs) {
+        if (enabled[resource]) {
+            result.append(resource);
         }
     }
     return result;
@@ -272,7 +272,7 @@ bool TextInputV3InterfacePrivate::isEnabled() const
     if (!surface) {
         return false;
     }
-    const auto clientResources = textInputsForClient(surface->client());
+    const auto &clientResources = textInputsForClient(surface->client());
     return std::any_of(clientResources.begin(), clientResources.end(), [this](Resource *resource) {
         return enabled[resource];
     });
@@ -293,14 +293,15 @@ void TextInputV3InterfacePrivate::zwp_text_input_v3_disable(Resource *resource)
     defaultPending();
 }
 
-void TextInputV3InterfacePrivate::zwp_text_input_v3_set_surrounding_text(Resource *resource, const QString &text, int32_t cursor, int32_t anchor)
+void TextInputV3InterfacePrivate::zwp_text_input_v3_set_surrounding_text(Resource *resource, const char *text, int32_t cursor, int32_t anchor)
 {
     Q_UNUSED(resource)
-    // zwp_text_input_v3_set_surrounding_text is no-op if enabled request is not pending
+    // zwp_text_input_v3_set_surrounding_text is no-op if enabled request is not pending,
+    // so the text is only decoded once it is known to be used
     if (!pending.enabled) {
         return;
     }
-    pending.surroundingText = text;
+    pending.surroundingText = QString::fromUtf8(text);
     pending.surroundingTextCursorPosition = cursor;
     pending.surroundingTextSelectionAnchor = anchor;
 }
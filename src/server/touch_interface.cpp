@@ -30,9 +30,9 @@ void TouchInterfacePrivate::touch_release(Resource *resource)
     wl_resource_destroy(resource->handle);
 }
 
-QList<TouchInterfacePrivate::Resource *> TouchInterfacePrivate::touchesForClient(ClientConnection *client) const
+const QVector<TouchInterfacePrivate::Resource *> &TouchInterfacePrivate::touchesForClient(ClientConnection *client) const
 {
-    return resourceMap().values(client->client());
+    return resourcesForClient(client->client());
 }
 
 TouchInterface::TouchInterface(SeatInterface *seat)
@@ -60,7 +60,7 @@ void TouchInterface::sendCancel()
         return;
     }
 
-    const auto touchResources = d->touchesForClient(d->focusedSurface->client());
+    const auto &touchResources = d->touchesForClient(d->focusedSurface->client());
     for (TouchInterfacePrivate::Resource *resource : touchResources) {
         d->send_cancel(resource->handle);
     }
@@ -72,7 +72,7 @@ void TouchInterface::sendFrame()
         return;
     }
 
-    const auto touchResources = d->touchesForClient(d->focusedSurface->client());
+    const auto &touchResources = d->touchesForClient(d->focusedSurface->client());
     for (TouchInterfacePrivate::Resource *resource : touchResources) {
         d->send_frame(resource->handle);
     }
@@ -84,7 +84,7 @@ void TouchInterface::sendMotion(qint32 id, const QPointF &localPos)
         return;
     }
 
-    const auto touchResources = d->touchesForClient(d->focusedSurface->client());
+    const auto &touchResources = d->touchesForClient(d->focusedSurface->client());
     for (TouchInterfacePrivate::Resource *resource : touchResources) {
         d->send_motion(resource->handle, d->seat->timestamp(), id, wl_fixed_from_double(localPos.x()), wl_fixed_from_double(localPos.y()));
     }
@@ -96,7 +96,7 @@ void TouchInterface::sendUp(qint32 id, quint32 serial)
         return;
     }
 
-    const auto touchResources = d->touchesForClient(d->focusedSurface->client());
+    const auto &touchResources = d->touchesForClient(d->focusedSurface->client());
     for (TouchInterfacePrivate::Resource *resource : touchResources) {
         d->send_up(resource->handle, serial, d->seat->timestamp(), id);
     }
@@ -108,7 +108,7 @@ void TouchInterface::sendDown(qint32 id, quint32 serial, const QPointF &localPos
         return;
     }
 
-    const auto touchResources = d->touchesForClient(d->focusedSurface->client());
+    const auto &touchResources = d->touchesForClient(d->focusedSurface->client());
     for (TouchInterfacePrivate::Resource *resource : touchResources) {
         d->send_down(resource->handle,
                      serial,
@@ -20,7 +20,7 @@ public:
     static TouchInterfacePrivate *get(TouchInterface *touch);
     TouchInterfacePrivate(TouchInterface *q, SeatInterface *seat);
 
-    QList<Resource *> touchesForClient(ClientConnection *client) const;
+    const QVector<Resource *> &touchesForClient(ClientConnection *client) const;
 
     TouchInterface *q;
     QPointer<SurfaceInterface> focusedSurface;
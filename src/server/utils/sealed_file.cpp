@@ -0,0 +1,75 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#include "sealed_file.h"
+#include "logging.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace KWaylandServer
+{
+SealedFile::~SealedFile()
+{
+    reset();
+}
+
+void SealedFile::reset()
+{
+    if (m_fd != -1) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+}
+
+bool SealedFile::create(const char *name, const char *data, quint32 size)
+{
+    reset();
+
+#if defined(MFD_ALLOW_SEALING) && defined(F_ADD_SEALS)
+    int fd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd == -1) {
+        qCDebug(KWAYLAND_SERVER) << "memfd_create failed:" << strerror(errno);
+        return false;
+    }
+
+    // pwrite keeps the file offset at 0, the description is shared with every client
+    quint32 written = 0;
+    while (written < size) {
+        const ssize_t ret = pwrite(fd, data + written, size - written, written);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qCWarning(KWAYLAND_SERVER) << "Failed to write sealed file:" << strerror(errno);
+            close(fd);
+            return false;
+        }
+        written += ret;
+    }
+
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+        qCDebug(KWAYLAND_SERVER) << "Failed to seal file:" << strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_size = size;
+    return true;
+#else
+    Q_UNUSED(name)
+    Q_UNUSED(data)
+    Q_UNUSED(size)
+    return false;
+#endif
+}
+
+} // namespace KWaylandServer
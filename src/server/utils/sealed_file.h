@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+
+#pragma once
+
+#include <QtGlobal>
+
+namespace KWaylandServer
+{
+/**
+ * An anonymous in-memory file whose content can't be changed once it's created.
+ *
+ * The file is sealed against writing, shrinking and growing, so one descriptor can be
+ * handed out to any number of clients without giving any of them a way to modify what
+ * the other clients see.
+ */
+class SealedFile
+{
+public:
+    SealedFile() = default;
+    ~SealedFile();
+
+    /**
+     * Replaces the file with a new one holding @p size bytes from @p data. Returns @c false
+     * if sealed memory files are not supported by the system, the file is invalid then.
+     */
+    bool create(const char *name, const char *data, quint32 size);
+    void reset();
+
+    bool isValid() const
+    {
+        return m_fd != -1;
+    }
+    int fd() const
+    {
+        return m_fd;
+    }
+    quint32 size() const
+    {
+        return m_size;
+    }
+
+private:
+    Q_DISABLE_COPY(SealedFile)
+
+    int m_fd = -1;
+    quint32 m_size = 0;
+};
+
+} // namespace KWaylandServer
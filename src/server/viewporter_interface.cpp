@@ -72,9 +72,9 @@ void ViewportInterface::wp_viewport_destroy(Resource *resource)
     if (surface) {
         SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(surface);
         surfacePrivate->pending.viewport.sourceGeometry = QRectF();
-        surfacePrivate->pending.viewport.sourceGeometryIsSet = true;
+        surfacePrivate->pending.committed |= SurfaceState::Field::ViewportSourceGeometry;
         surfacePrivate->pending.viewport.destinationSize = QSize();
-        surfacePrivate->pending.viewport.destinationSizeIsSet = true;
+        surfacePrivate->pending.committed |= SurfaceState::Field::ViewportDestinationSize;
     }
 
     wl_resource_destroy(resource->handle);
@@ -95,7 +95,7 @@ void ViewportInterface::wp_viewport_set_source(Resource *resource, wl_fixed_t x_
     if (x == -1 && y == -1 && width == -1 && height == -1) {
         SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(surface);
         surfacePrivate->pending.viewport.sourceGeometry = QRectF();
-        surfacePrivate->pending.viewport.sourceGeometryIsSet = true;
+        surfacePrivate->pending.committed |= SurfaceState::Field::ViewportSourceGeometry;
         return;
     }
 
@@ -106,7 +106,7 @@ void ViewportInterface::wp_viewport_set_source(Resource *resource, wl_fixed_t x_
 
     SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(surface);
     surfacePrivate->pending.viewport.sourceGeometry = QRectF(x, y, width, height);
-    surfacePrivate->pending.viewport.sourceGeometryIsSet = true;
+    surfacePrivate->pending.committed |= SurfaceState::Field::ViewportSourceGeometry;
 }
 
 void ViewportInterface::wp_viewport_set_destination(Resource *resource, int32_t width, int32_t height)
@@ -119,7 +119,7 @@ void ViewportInterface::wp_viewport_set_destination(Resource *resource, int32_t
     if (width == -1 && height == -1) {
         SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(surface);
         surfacePrivate->pending.viewport.destinationSize = QSize();
-        surfacePrivate->pending.viewport.destinationSizeIsSet = true;
+        surfacePrivate->pending.committed |= SurfaceState::Field::ViewportDestinationSize;
         return;
     }
 
@@ -130,7 +130,7 @@ void ViewportInterface::wp_viewport_set_destination(Resource *resource, int32_t
 
     SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(surface);
     surfacePrivate->pending.viewport.destinationSize = QSize(width, height);
-    surfacePrivate->pending.viewport.destinationSizeIsSet = true;
+    surfacePrivate->pending.committed |= SurfaceState::Field::ViewportDestinationSize;
 }
 
 ViewporterInterface::ViewporterInterface(Display *display, QObject *parent)
@@ -374,24 +374,35 @@ void XdgToplevelInterfacePrivate::xdg_toplevel_set_parent(Resource *resource, ::
     Q_EMIT q->parentXdgToplevelChanged();
 }
 
-void XdgToplevelInterfacePrivate::xdg_toplevel_set_title(Resource *resource, const QString &title)
+void XdgToplevelInterfacePrivate::xdg_toplevel_set_title(Resource *resource, const char *title)
 {
     Q_UNUSED(resource)
-    if (windowTitle == title) {
+    // Terminals and browsers keep setting the same title, e.g. on every prompt.
+    if (rawWindowTitle == title) {
         return;
     }
-    windowTitle = title;
-    Q_EMIT q->windowTitleChanged(title);
+    rawWindowTitle = title;
+    const QString decoded = QString::fromUtf8(rawWindowTitle);
+    if (windowTitle == decoded) {
+        return;
+    }
+    windowTitle = decoded;
+    Q_EMIT q->windowTitleChanged(windowTitle);
 }
 
-void XdgToplevelInterfacePrivate::xdg_toplevel_set_app_id(Resource *resource, const QString &app_id)
+void XdgToplevelInterfacePrivate::xdg_toplevel_set_app_id(Resource *resource, const char *app_id)
 {
     Q_UNUSED(resource)
-    if (windowClass == app_id) {
+    if (rawWindowClass == app_id) {
+        return;
+    }
+    rawWindowClass = app_id;
+    const QString decoded = QString::fromUtf8(rawWindowClass);
+    if (windowClass == decoded) {
         return;
     }
-    windowClass = app_id;
-    Q_EMIT q->windowClassChanged(app_id);
+    windowClass = decoded;
+    Q_EMIT q->windowClassChanged(windowClass);
 }
 
 void XdgToplevelInterfacePrivate::xdg_toplevel_show_window_menu(Resource *resource, ::wl_resource *seatResource, uint32_t serial, int32_t x, int32_t y)
@@ -138,6 +138,9 @@ public:
 
     QString windowTitle;
     QString windowClass;
+    // As sent by the client, to drop repeated requests without converting them.
+    QByteArray rawWindowTitle;
+    QByteArray rawWindowClass;
 
     struct State {
         QSize minimumSize;
@@ -151,8 +154,8 @@ protected:
     void xdg_toplevel_destroy_resource(Resource *resource) override;
     void xdg_toplevel_destroy(Resource *resource) override;
     void xdg_toplevel_set_parent(Resource *resource, ::wl_resource *parent) override;
-    void xdg_toplevel_set_title(Resource *resource, const QString &title) override;
-    void xdg_toplevel_set_app_id(Resource *resource, const QString &app_id) override;
+    void xdg_toplevel_set_title(Resource *resource, const char *title) override;
+    void xdg_toplevel_set_app_id(Resource *resource, const char *app_id) override;
     void xdg_toplevel_show_window_menu(Resource *resource, ::wl_resource *seat, uint32_t serial, int32_t x, int32_t y) override;
     void xdg_toplevel_move(Resource *resource, ::wl_resource *seat, uint32_t serial) override;
     void xdg_toplevel_resize(Resource *resource, ::wl_resource *seat, uint32_t serial, uint32_t edges) override;
@@ -80,6 +80,8 @@ private:
         QByteArray name;
         QByteArray type;
         std::vector<WaylandArgument> arguments;
+        // string arguments are passed to the handler as const char * without converting
+        bool rawStrings;
     };
 
     struct WaylandInterface {
@@ -102,6 +104,7 @@ private:
     Scanner::WaylandInterface readInterface(QXmlStreamReader &xml);
     QByteArray waylandToCType(const QByteArray &waylandType, const QByteArray &interface);
     QByteArray waylandToQtType(const QByteArray &waylandType, const QByteArray &interface, bool cStyleArray);
+    QByteArray handlerArgumentType(const WaylandEvent &e, const WaylandArgument &a);
     const Scanner::WaylandArgument *newIdArgument(const std::vector<WaylandArgument> &arguments);
 
     void printEvent(const WaylandEvent &e, bool omitNames = false, bool withResource = false);
@@ -124,6 +127,7 @@ private:
     QByteArray m_headerPath;
     QByteArray m_prefix;
     QVector <QByteArray> m_includes;
+    QVector<QByteArray> m_rawStringRequests;
     QXmlStreamReader *m_xml = nullptr;
 };
 
@@ -150,16 +154,23 @@ bool Scanner::parseArguments(int argc, char **argv)
         // --header-path=<path> (14 characters)
         // --prefix=<prefix> (9 characters)
         // --add-include=<include> (14 characters)
+        // --raw-strings=<interface.request>[,<interface.request>...] (14 characters)
         for (int pos = 3; pos < argc; pos++) {
             const QByteArray &option = args[pos];
             if (option.startsWith("--header-path=")) {
                 m_headerPath = option.mid(14);
             } else if (option.startsWith("--prefix=")) {
-                m_prefix = option.mid(10);
+                m_prefix = option.mid(9);
             } else if (option.startsWith("--add-include=")) {
                 auto include = option.mid(14);
                 if (!include.isEmpty())
                     m_includes << include;
+            } else if (option.startsWith("--raw-strings=")) {
+                const auto requests = option.mid(14).split(',');
+                for (const QByteArray &request : requests) {
+                    if (!request.isEmpty())
+                        m_rawStringRequests << request;
+                }
             } else {
                 return false;
             }
@@ -171,7 +182,7 @@ bool Scanner::parseArguments(int argc, char **argv)
 
 void Scanner::printUsage()
 {
-    fprintf(stderr, "Usage: %s [client-header|server-header|client-code|server-code] specfile [--header-path=<path>] [--prefix=<prefix>] [--add-include=<include>]\n", m_scannerName.constData());
+    fprintf(stderr, "Usage: %s [client-header|server-header|client-code|server-code] specfile [--header-path=<path>] [--prefix=<prefix>] [--add-include=<include>] [--raw-strings=<interface.request>,...]\n", m_scannerName.constData());
 }
 
 bool Scanner::isServerSide()
@@ -221,6 +232,7 @@ Scanner::WaylandEvent Scanner::readEvent(QXmlStreamReader &xml, bool request)
         .name = byteArrayValue(xml, "name"),
         .type = byteArrayValue(xml, "type"),
         .arguments = {},
+        .rawStrings = false,
     };
     while (xml.readNextStartElement()) {
         if (xml.name() == "arg") {
@@ -320,6 +332,13 @@ QByteArray Scanner::waylandToQtType(const QByteArray &waylandType, const QByteAr
         return waylandToCType(waylandType, interface);
 }
 
+QByteArray Scanner::handlerArgumentType(const WaylandEvent &e, const WaylandArgument &a)
+{
+    if (e.rawStrings && a.type == "string" && e.request == isServerSide())
+        return waylandToCType(a.type, a.interface);
+    return waylandToQtType(a.type, a.interface, e.request == isServerSide());
+}
+
 const Scanner::WaylandArgument *Scanner::newIdArgument(const std::vector<WaylandArgument> &arguments)
 {
     for (const WaylandArgument &a : arguments) {
@@ -365,7 +384,7 @@ void Scanner::printEvent(const WaylandEvent &e, bool omitNames, bool withResourc
             }
         }
 
-        QByteArray qtType = waylandToQtType(a.type, a.interface, e.request == isServerSide());
+        QByteArray qtType = handlerArgumentType(e, a);
         printf("%s%s%s", qtType.constData(), qtType.endsWith("&") || qtType.endsWith("*") ? "" : " ", omitNames ? "" : a.name.constData());
     }
     printf(")");
@@ -458,9 +477,12 @@ bool Scanner::process()
     std::vector<WaylandInterface> interfaces;
 
     while (m_xml->readNextStartElement()) {
-        if (m_xml->name() == "interface")
-            interfaces.push_back(readInterface(*m_xml));
-        else
+        if (m_xml->name() == "interface") {
+            WaylandInterface interface = readInterface(*m_xml);
+            for (WaylandEvent &request : interface.requests)
+                request.rawStrings = m_rawStringRequests.contains(interface.name + '.' + request.name);
+            interfaces.push_back(std::move(interface));
+        } else
             m_xml->skipCurrentElement();
     }
 
@@ -484,8 +506,10 @@ bool Scanner::process()
         else
             printf("#include <%s/wayland-%s-server-protocol.h>\n", m_headerPath.constData(), QByteArray(m_protocolName).replace('_', '-').constData());
         printf("#include <QByteArray>\n");
+        printf("#include <QHash>\n");
         printf("#include <QMultiMap>\n");
         printf("#include <QString>\n");
+        printf("#include <QVector>\n");
 
         printf("\n");
         printf("#include <unistd.h>\n");
@@ -569,8 +593,8 @@ bool Scanner::process()
             printf("        Resource *resource() { return m_resource; }\n");
             printf("        const Resource *resource() const { return m_resource; }\n");
             printf("\n");
-            printf("        QMultiMap<struct ::wl_client*, Resource*> resourceMap() { return m_resource_map; }\n");
-            printf("        const QMultiMap<struct ::wl_client*, Resource*> resourceMap() const { return m_resource_map; }\n");
+            printf("        const QMultiMap<struct ::wl_client*, Resource*> &resourceMap() const { return m_resource_map; }\n");
+            printf("        const QVector<Resource *> &resourcesForClient(struct ::wl_client *client) const;\n");
             printf("\n");
             printf("        bool isGlobalRemoved() const { return m_globalRemovedEvent; }\n");
             printf("        void globalRemove();\n");
@@ -644,6 +668,7 @@ bool Scanner::process()
 
             printf("\n");
             printf("        QMultiMap<struct ::wl_client*, Resource*> m_resource_map;\n");
+            printf("        QHash<struct ::wl_client*, QVector<Resource*>> m_client_resources;\n");
             printf("        Resource *m_resource;\n");
             printf("        struct ::wl_global *m_global;\n");
             printf("        struct ::wl_display *m_display;\n");
@@ -781,6 +806,7 @@ bool Scanner::process()
             printf("    {\n");
             printf("        Resource *resource = bind(client, 0, version);\n");
             printf("        m_resource_map.insert(client, resource);\n");
+            printf("        m_client_resources[client].append(resource);\n");
             printf("        return resource;\n");
             printf("    }\n");
             printf("\n");
@@ -789,10 +815,19 @@ bool Scanner::process()
             printf("    {\n");
             printf("        Resource *resource = bind(client, id, version);\n");
             printf("        m_resource_map.insert(client, resource);\n");
+            printf("        m_client_resources[client].append(resource);\n");
             printf("        return resource;\n");
             printf("    }\n");
             printf("\n");
 
+            printf("    const QVector<%s::Resource *> &%s::resourcesForClient(struct ::wl_client *client) const\n", interfaceName, interfaceName);
+            printf("    {\n");
+            printf("        static const QVector<Resource *> noResources;\n");
+            printf("        const auto it = m_client_resources.constFind(client);\n");
+            printf("        return it != m_client_resources.constEnd() ? *it : noResources;\n");
+            printf("    }\n");
+            printf("\n");
+
             printf("    void %s::init(struct ::wl_display *display, int version)\n", interfaceName);
             printf("    {\n");
             printf("        m_display = display;\n");
@@ -853,6 +888,12 @@ bool Scanner::process()
             printf("        %s *that = resource->%s_object;\n", interfaceName, interfaceNameStripped);
             printf("        if (Q_LIKELY(that)) {\n");
             printf("            that->m_resource_map.remove(resource->client(), resource);\n");
+            printf("            auto clientResources = that->m_client_resources.find(resource->client());\n");
+            printf("            if (clientResources != that->m_client_resources.end()) {\n");
+            printf("                clientResources->removeOne(resource);\n");
+            printf("                if (clientResources->isEmpty())\n");
+            printf("                    that->m_client_resources.erase(clientResources);\n");
+            printf("            }\n");
             printf("            that->%s_destroy_resource(resource);\n", interfaceNameStripped);
             printf("\n");
             printf("            that = resource->%s_object;\n", interfaceNameStripped);
@@ -962,7 +1003,7 @@ bool Scanner::process()
                     for (const WaylandArgument &a : e.arguments) {
                         printf(",\n");
                         QByteArray cType = waylandToCType(a.type, a.interface);
-                        QByteArray qtType = waylandToQtType(a.type, a.interface, e.request);
+                        QByteArray qtType = handlerArgumentType(e, a);
                         const char *argumentName = a.name.constData();
                         if (cType == qtType)
                             printf("            %s", argumentName);